@@ -0,0 +1,387 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <stdexcept>
+#include <sc/Spirv_compiler.h>
+#include <sc/Glsl_compiler.h>
+#include "Gl_backend.h"
+
+using namespace std;
+using namespace Sc;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr array<float, 4> identity {0.0f, 0.0f, 1.0f, 1.0f};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto compile(GLenum stage, Shader_type type, const string& src)
+{
+    // GL shaders are generated from the same VKSL as Vulkan shaders.
+    auto spirv = Spirv_compiler(Spirv_compiler_configs {Platform::desktop}).compile(type, src);
+    auto glsl = Glsl_compiler(Glsl_compiler_configs {Platform::desktop}).compile(spirv);
+    auto glsl_src = glsl.c_str();
+
+    auto shader = glCreateShader(stage);
+
+    glShaderSource(shader, 1, &glsl_src, nullptr);
+    glCompileShader(shader);
+
+    GLint status;
+
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+    if (!status) {
+        string log(1024, '\0');
+
+        glGetShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, &log[0]);
+        glDeleteShader(shader);
+
+        throw runtime_error("fail to compile a shader : " + log);
+    }
+
+    return shader;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Gl_backend::Gl_backend() :
+    display_ {EGL_NO_DISPLAY},
+    context_ {EGL_NO_CONTEXT},
+    program_ {0},
+    draw_transform_location_ {-1},
+    framebuffer_ {0},
+    renderbuffer_ {0},
+    quad_buffer_ {0},
+    stream_buffer_ {0},
+    uniform_buffer_ {0},
+    quad_vertex_array_ {0},
+    stream_vertex_array_ {0},
+    textures_ {}
+{
+    init_display_();
+    init_context_();
+    init_program_();
+    init_framebuffer_();
+    init_buffers_();
+    init_vertex_arrays_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Gl_backend::~Gl_backend()
+{
+    if (context_ != EGL_NO_CONTEXT) {
+        term_textures_();
+        term_vertex_arrays_();
+        term_buffers_();
+        term_framebuffer_();
+        term_program_();
+    }
+
+    term_context_();
+    term_display_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Result Gl_backend::run(const Workload& workload)
+{
+    auto data = workload_data(workload);
+
+    init_textures_(workload.type == Workload_type::texture_upload ? workload.call_count : 1);
+
+    // warm up the driver before measuring.
+    for (auto i = 0; i != frames_in_flight; ++i)
+        frame_(workload, data);
+
+    glFinish();
+
+    auto wall_begin = wall_time();
+    auto cpu_begin = thread_cpu_time();
+
+    for (auto i = 0; i != workload.frame_count; ++i)
+        frame_(workload, data);
+
+    glFinish();
+
+    return {wall_time() - wall_begin, thread_cpu_time() - cpu_begin};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string Gl_backend::name() const
+{
+    return reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::init_display_()
+{
+    // the surfaceless platform of Mesa doesn't need a window system, e.g. llvmpipe with LIBGL_ALWAYS_SOFTWARE.
+    display_ = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+    if (display_ == EGL_NO_DISPLAY)
+        throw runtime_error("fail to get a surfaceless display");
+
+    if (!eglInitialize(display_, nullptr, nullptr))
+        throw runtime_error("fail to initialize a display");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::init_context_()
+{
+    if (!eglBindAPI(EGL_OPENGL_API))
+        throw runtime_error("fail to bind OpenGL");
+
+    const EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 5,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+
+    context_ = eglCreateContext(display_, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+
+    if (context_ == EGL_NO_CONTEXT)
+        throw runtime_error("fail to create a context");
+
+    if (!eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, context_))
+        throw runtime_error("fail to make a context current");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::init_program_()
+{
+    auto vertex_shader = compile(GL_VERTEX_SHADER, Shader_type::vertex, vertex_src());
+    auto fragment_shader = compile(GL_FRAGMENT_SHADER, Shader_type::fragment, fragment_src());
+
+    program_ = glCreateProgram();
+    glAttachShader(program_, vertex_shader);
+    glAttachShader(program_, fragment_shader);
+    glLinkProgram(program_);
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+
+    GLint status;
+
+    glGetProgramiv(program_, GL_LINK_STATUS, &status);
+
+    if (!status)
+        throw runtime_error("fail to link a program");
+
+    // the push constant block is translated to a uniform struct.
+    draw_transform_location_ = glGetUniformLocation(program_, "draw.transform");
+
+    if (draw_transform_location_ == -1)
+        throw runtime_error("fail to find a uniform draw.transform");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::init_framebuffer_()
+{
+    glGenRenderbuffers(1, &renderbuffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, target_size, target_size);
+
+    glGenFramebuffers(1, &framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer_);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        throw runtime_error("fail to complete a framebuffer");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::init_buffers_()
+{
+    Vertex vertices[quad_vertex_count];
+
+    quad(identity, vertices);
+
+    glGenBuffers(1, &quad_buffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, quad_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &stream_buffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, stream_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), nullptr, GL_STREAM_DRAW);
+
+    glGenBuffers(1, &uniform_buffer_);
+    glBindBuffer(GL_UNIFORM_BUFFER, uniform_buffer_);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Uniform), nullptr, GL_DYNAMIC_DRAW);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::init_vertex_arrays_()
+{
+    for (auto [vertex_array, buffer] : {make_pair(&quad_vertex_array_, quad_buffer_),
+                                        make_pair(&stream_vertex_array_, stream_buffer_)}) {
+        glGenVertexArrays(1, vertex_array);
+        glBindVertexArray(*vertex_array);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(0));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(8));
+    }
+
+    glBindVertexArray(0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::init_textures_(uint32_t count)
+{
+    while (textures_.size() < count) {
+        GLuint texture;
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, texture_size, texture_size);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        textures_.push_back(texture);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::term_display_()
+{
+    if (display_ != EGL_NO_DISPLAY)
+        eglTerminate(display_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::term_context_()
+{
+    if (context_ == EGL_NO_CONTEXT)
+        return;
+
+    eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display_, context_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::term_program_()
+{
+    glDeleteProgram(program_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::term_framebuffer_()
+{
+    glDeleteFramebuffers(1, &framebuffer_);
+    glDeleteRenderbuffers(1, &renderbuffer_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::term_buffers_()
+{
+    glDeleteBuffers(1, &uniform_buffer_);
+    glDeleteBuffers(1, &stream_buffer_);
+    glDeleteBuffers(1, &quad_buffer_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::term_vertex_arrays_()
+{
+    glDeleteVertexArrays(1, &stream_vertex_array_);
+    glDeleteVertexArrays(1, &quad_vertex_array_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::term_textures_()
+{
+    if (!textures_.empty())
+        glDeleteTextures(static_cast<GLsizei>(textures_.size()), &textures_[0]);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Gl_backend::frame_(const Workload& workload, const Workload_data& data)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glViewport(0, 0, target_size, target_size);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glUseProgram(program_);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, uniform_buffer_);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures_[0]);
+    glUniform4fv(draw_transform_location_, 1, &identity[0]);
+
+    switch (workload.type) {
+        case Workload_type::uniform_update:
+            // the classic GL pattern, one uniform buffer which is updated before each draw.
+            glBindVertexArray(quad_vertex_array_);
+
+            for (auto i = 0; i != workload.call_count; ++i) {
+                glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Uniform), &data.uniforms[i]);
+                glDrawArrays(GL_TRIANGLES, 0, quad_vertex_count);
+            }
+            break;
+        case Workload_type::small_draw:
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Uniform), &data.uniforms[0]);
+            glBindVertexArray(quad_vertex_array_);
+
+            for (auto i = 0; i != workload.call_count; ++i) {
+                glUniform4fv(draw_transform_location_, 1, &data.transforms[i][0]);
+                glDrawArrays(GL_TRIANGLES, 0, quad_vertex_count);
+            }
+
+            glUniform4fv(draw_transform_location_, 1, &identity[0]);
+            break;
+        case Workload_type::texture_upload:
+            for (auto i = 0; i != workload.call_count; ++i) {
+                glBindTexture(GL_TEXTURE_2D, textures_[i]);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture_size, texture_size, GL_RGBA, GL_UNSIGNED_BYTE,
+                                &data.texels[0]);
+            }
+
+            glBindTexture(GL_TEXTURE_2D, textures_[0]);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Uniform), &data.uniforms[0]);
+            glBindVertexArray(quad_vertex_array_);
+            glDrawArrays(GL_TRIANGLES, 0, quad_vertex_count);
+            break;
+        case Workload_type::buffer_streaming:
+            // orphan the storage, so the driver doesn't wait for draws which use the previous storage.
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Uniform), &data.uniforms[0]);
+            glBindVertexArray(stream_vertex_array_);
+            glBindBuffer(GL_ARRAY_BUFFER, stream_buffer_);
+
+            for (auto i = 0; i != workload.call_count; ++i) {
+                glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * quad_vertex_count, nullptr, GL_STREAM_DRAW);
+                glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertex) * quad_vertex_count,
+                                &data.vertices[i * quad_vertex_count]);
+                glDrawArrays(GL_TRIANGLES, 0, quad_vertex_count);
+            }
+            break;
+    }
+
+    glFlush();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,81 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef BENCHMARK_GL_BACKEND_GUARD
+#define BENCHMARK_GL_BACKEND_GUARD
+
+#define GL_GLEXT_PROTOTYPES 1
+
+#include <string>
+#include <vector>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include "Workload.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// renders to a framebuffer object of a surfaceless EGL context, so it runs without a display.
+class Gl_backend final {
+public:
+    Gl_backend();
+
+    ~Gl_backend();
+
+    Result run(const Workload& workload);
+
+    [[nodiscard]]
+    std::string name() const;
+
+private:
+    void init_display_();
+
+    void init_context_();
+
+    void init_program_();
+
+    void init_framebuffer_();
+
+    void init_buffers_();
+
+    void init_vertex_arrays_();
+
+    void init_textures_(uint32_t count);
+
+    void term_display_();
+
+    void term_context_();
+
+    void term_program_();
+
+    void term_framebuffer_();
+
+    void term_buffers_();
+
+    void term_vertex_arrays_();
+
+    void term_textures_();
+
+    void frame_(const Workload& workload, const Workload_data& data);
+
+private:
+    EGLDisplay display_;
+    EGLContext context_;
+    GLuint program_;
+    GLint draw_transform_location_;
+    GLuint framebuffer_;
+    GLuint renderbuffer_;
+    GLuint quad_buffer_;
+    GLuint stream_buffer_;
+    GLuint uniform_buffer_;
+    GLuint quad_vertex_array_;
+    GLuint stream_vertex_array_;
+    std::vector<GLuint> textures_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif // BENCHMARK_GL_BACKEND_GUARD
@@ -0,0 +1,1014 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <fmt/format.h>
+#include <sc/Spirv_compiler.h>
+#include "Vk_backend.h"
+
+using namespace std;
+using namespace Sc;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr array<float, 4> identity {0.0f, 0.0f, 1.0f, 1.0f};
+constexpr auto texture_byte_size {texture_size * texture_size * 4};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void check(VkResult result, const char* message)
+{
+    if (VK_SUCCESS != result)
+        throw runtime_error(fmt::format("fail to {} ({})", message, static_cast<int>(result)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto create_shader_module(VkDevice device, Shader_type type, const string& src)
+{
+    auto spirv = Spirv_compiler(Spirv_compiler_configs {Platform::desktop}).compile(type, src);
+
+    VkShaderModuleCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    create_info.codeSize = spirv.size() * sizeof(uint32_t);
+    create_info.pCode = &spirv[0];
+
+    VkShaderModule shader_module;
+
+    check(vkCreateShaderModule(device, &create_info, nullptr, &shader_module), "create a shader module");
+
+    return shader_module;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto image_barrier(VkImage image, VkImageLayout old_layout, VkImageLayout new_layout,
+                          VkAccessFlags src_access_mask, VkAccessFlags dst_access_mask)
+{
+    VkImageMemoryBarrier barrier {};
+
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = src_access_mask;
+    barrier.dstAccessMask = dst_access_mask;
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    return barrier;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Vk_backend::Vk_backend(const std::string& device_name) :
+    instance_ {VK_NULL_HANDLE},
+    physical_device_ {VK_NULL_HANDLE},
+    properties_ {},
+    memory_properties_ {},
+    queue_family_index_ {UINT32_MAX},
+    device_ {VK_NULL_HANDLE},
+    queue_ {VK_NULL_HANDLE},
+    command_pool_ {VK_NULL_HANDLE},
+    command_buffers_ {},
+    fences_ {},
+    frame_index_ {0},
+    color_image_ {VK_NULL_HANDLE},
+    color_device_memory_ {VK_NULL_HANDLE},
+    color_image_view_ {VK_NULL_HANDLE},
+    render_pass_ {VK_NULL_HANDLE},
+    framebuffer_ {VK_NULL_HANDLE},
+    descriptor_set_layout_ {VK_NULL_HANDLE},
+    descriptor_pool_ {VK_NULL_HANDLE},
+    descriptor_set_ {VK_NULL_HANDLE},
+    vertex_shader_module_ {VK_NULL_HANDLE},
+    fragment_shader_module_ {VK_NULL_HANDLE},
+    pipeline_layout_ {VK_NULL_HANDLE},
+    pipeline_ {VK_NULL_HANDLE},
+    quad_buffer_ {},
+    sampler_ {VK_NULL_HANDLE},
+    textures_ {},
+    uniform_buffer_ {},
+    stream_buffer_ {},
+    staging_buffer_ {}
+{
+    init_instance_();
+    init_physical_device_(device_name);
+    init_device_();
+    init_command_buffers_();
+    init_fences_();
+    init_render_target_();
+    init_render_pass_();
+    init_framebuffer_();
+    init_descriptor_set_();
+    init_pipeline_();
+    init_quad_buffer_();
+    init_sampler_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Vk_backend::~Vk_backend()
+{
+    if (device_) {
+        vkDeviceWaitIdle(device_);
+
+        term_host_buffers_();
+        term_textures_();
+        term_sampler_();
+        term_quad_buffer_();
+        term_pipeline_();
+        term_descriptor_set_();
+        term_framebuffer_();
+        term_render_pass_();
+        term_render_target_();
+        term_fences_();
+        term_command_buffers_();
+    }
+
+    term_device_();
+    term_instance_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Result Vk_backend::run(const Workload& workload)
+{
+    auto data = workload_data(workload);
+
+    init_textures_(workload.type == Workload_type::texture_upload ? workload.call_count : 1);
+    init_host_buffers_(workload);
+
+    // warm up the driver before measuring.
+    for (auto i = 0; i != frames_in_flight; ++i)
+        frame_(workload, data);
+
+    vkDeviceWaitIdle(device_);
+
+    auto wall_begin = wall_time();
+    auto cpu_begin = thread_cpu_time();
+
+    for (auto i = 0; i != workload.frame_count; ++i)
+        frame_(workload, data);
+
+    vkDeviceWaitIdle(device_);
+
+    return {wall_time() - wall_begin, thread_cpu_time() - cpu_begin};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string Vk_backend::name() const
+{
+    return properties_.deviceName;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_instance_()
+{
+    VkApplicationInfo app_info {};
+
+    app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app_info.pApplicationName = "gl_vs_vk";
+    app_info.apiVersion = VK_API_VERSION_1_0;
+
+    VkInstanceCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    create_info.pApplicationInfo = &app_info;
+
+    check(vkCreateInstance(&create_info, nullptr, &instance_), "create an instance");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_physical_device_(const std::string& device_name)
+{
+    uint32_t count {0};
+
+    vkEnumeratePhysicalDevices(instance_, &count, nullptr);
+
+    vector<VkPhysicalDevice> physical_devices(count);
+
+    vkEnumeratePhysicalDevices(instance_, &count, physical_devices.data());
+
+    for (auto& physical_device : physical_devices) {
+        vkGetPhysicalDeviceProperties(physical_device, &properties_);
+
+        if (string(properties_.deviceName).find(device_name) == string::npos)
+            continue;
+
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &count, nullptr);
+
+        vector<VkQueueFamilyProperties> queue_families(count);
+
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &count, queue_families.data());
+
+        for (auto i = 0; i != count; ++i) {
+            if (queue_families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                physical_device_ = physical_device;
+                queue_family_index_ = i;
+                break;
+            }
+        }
+
+        if (physical_device_)
+            break;
+    }
+
+    if (!physical_device_)
+        throw runtime_error("fail to find a physical device " + device_name);
+
+    vkGetPhysicalDeviceMemoryProperties(physical_device_, &memory_properties_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_device_()
+{
+    auto priority {1.0f};
+
+    VkDeviceQueueCreateInfo queue_create_info {};
+
+    queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queue_create_info.queueFamilyIndex = queue_family_index_;
+    queue_create_info.queueCount = 1;
+    queue_create_info.pQueuePriorities = &priority;
+
+    VkDeviceCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    create_info.queueCreateInfoCount = 1;
+    create_info.pQueueCreateInfos = &queue_create_info;
+
+    check(vkCreateDevice(physical_device_, &create_info, nullptr, &device_), "create a device");
+
+    vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_command_buffers_()
+{
+    VkCommandPoolCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    create_info.queueFamilyIndex = queue_family_index_;
+
+    check(vkCreateCommandPool(device_, &create_info, nullptr, &command_pool_), "create a command pool");
+
+    VkCommandBufferAllocateInfo allocate_info {};
+
+    allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocate_info.commandPool = command_pool_;
+    allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocate_info.commandBufferCount = frames_in_flight;
+
+    check(vkAllocateCommandBuffers(device_, &allocate_info, &command_buffers_[0]), "allocate command buffers");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_fences_()
+{
+    VkFenceCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for (auto& fence : fences_)
+        check(vkCreateFence(device_, &create_info, nullptr, &fence), "create a fence");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_render_target_()
+{
+    VkImageCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    create_info.imageType = VK_IMAGE_TYPE_2D;
+    create_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    create_info.extent = {target_size, target_size, 1};
+    create_info.mipLevels = 1;
+    create_info.arrayLayers = 1;
+    create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    create_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    check(vkCreateImage(device_, &create_info, nullptr, &color_image_), "create an image");
+
+    VkMemoryRequirements requirements;
+
+    vkGetImageMemoryRequirements(device_, color_image_, &requirements);
+    color_device_memory_ = allocate_memory_(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    check(vkBindImageMemory(device_, color_image_, color_device_memory_, 0), "bind a memory");
+
+    VkImageViewCreateInfo view_create_info {};
+
+    view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_create_info.image = color_image_;
+    view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_create_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    view_create_info.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    check(vkCreateImageView(device_, &view_create_info, nullptr, &color_image_view_), "create an image view");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_render_pass_()
+{
+    VkAttachmentDescription attachment {};
+
+    attachment.format = VK_FORMAT_R8G8B8A8_UNORM;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference reference {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass {};
+
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &reference;
+
+    VkRenderPassCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    create_info.attachmentCount = 1;
+    create_info.pAttachments = &attachment;
+    create_info.subpassCount = 1;
+    create_info.pSubpasses = &subpass;
+
+    check(vkCreateRenderPass(device_, &create_info, nullptr, &render_pass_), "create a render pass");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_framebuffer_()
+{
+    VkFramebufferCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    create_info.renderPass = render_pass_;
+    create_info.attachmentCount = 1;
+    create_info.pAttachments = &color_image_view_;
+    create_info.width = target_size;
+    create_info.height = target_size;
+    create_info.layers = 1;
+
+    check(vkCreateFramebuffer(device_, &create_info, nullptr, &framebuffer_), "create a framebuffer");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_descriptor_set_()
+{
+    // the uniform buffer is dynamic, so each call only changes an offset instead of a descriptor.
+    array<VkDescriptorSetLayoutBinding, 2> bindings {};
+
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    create_info.bindingCount = static_cast<uint32_t>(bindings.size());
+    create_info.pBindings = &bindings[0];
+
+    check(vkCreateDescriptorSetLayout(device_, &create_info, nullptr, &descriptor_set_layout_),
+          "create a descriptor set layout");
+
+    array<VkDescriptorPoolSize, 2> pool_sizes {{
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1}
+    }};
+
+    VkDescriptorPoolCreateInfo pool_create_info {};
+
+    pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_create_info.maxSets = 1;
+    pool_create_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+    pool_create_info.pPoolSizes = &pool_sizes[0];
+
+    check(vkCreateDescriptorPool(device_, &pool_create_info, nullptr, &descriptor_pool_),
+          "create a descriptor pool");
+
+    VkDescriptorSetAllocateInfo allocate_info {};
+
+    allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocate_info.descriptorPool = descriptor_pool_;
+    allocate_info.descriptorSetCount = 1;
+    allocate_info.pSetLayouts = &descriptor_set_layout_;
+
+    check(vkAllocateDescriptorSets(device_, &allocate_info, &descriptor_set_), "allocate a descriptor set");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_pipeline_()
+{
+    vertex_shader_module_ = create_shader_module(device_, Shader_type::vertex, vertex_src());
+    fragment_shader_module_ = create_shader_module(device_, Shader_type::fragment, fragment_src());
+
+    VkPushConstantRange push_constant_range {VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(identity)};
+
+    VkPipelineLayoutCreateInfo layout_create_info {};
+
+    layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_create_info.setLayoutCount = 1;
+    layout_create_info.pSetLayouts = &descriptor_set_layout_;
+    layout_create_info.pushConstantRangeCount = 1;
+    layout_create_info.pPushConstantRanges = &push_constant_range;
+
+    check(vkCreatePipelineLayout(device_, &layout_create_info, nullptr, &pipeline_layout_),
+          "create a pipeline layout");
+
+    array<VkPipelineShaderStageCreateInfo, 2> stages {};
+
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vertex_shader_module_;
+    stages[0].pName = "main";
+
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = fragment_shader_module_;
+    stages[1].pName = "main";
+
+    VkVertexInputBindingDescription vertex_binding {0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX};
+
+    array<VkVertexInputAttributeDescription, 2> vertex_attributes {{
+        {0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, x)},
+        {1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, u)}
+    }};
+
+    VkPipelineVertexInputStateCreateInfo vertex_input_state {};
+
+    vertex_input_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertex_input_state.vertexBindingDescriptionCount = 1;
+    vertex_input_state.pVertexBindingDescriptions = &vertex_binding;
+    vertex_input_state.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertex_attributes.size());
+    vertex_input_state.pVertexAttributeDescriptions = &vertex_attributes[0];
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly_state {};
+
+    input_assembly_state.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly_state.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkViewport viewport {0.0f, 0.0f, target_size, target_size, 0.0f, 1.0f};
+    VkRect2D scissor {{0, 0}, {target_size, target_size}};
+
+    VkPipelineViewportStateCreateInfo viewport_state {};
+
+    viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state.viewportCount = 1;
+    viewport_state.pViewports = &viewport;
+    viewport_state.scissorCount = 1;
+    viewport_state.pScissors = &scissor;
+
+    VkPipelineRasterizationStateCreateInfo rasterization_state {};
+
+    rasterization_state.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterization_state.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterization_state.cullMode = VK_CULL_MODE_NONE;
+    rasterization_state.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterization_state.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisample_state {};
+
+    multisample_state.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisample_state.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState color_blend_attachment {};
+
+    color_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                            VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo color_blend_state {};
+
+    color_blend_state.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blend_state.attachmentCount = 1;
+    color_blend_state.pAttachments = &color_blend_attachment;
+
+    VkGraphicsPipelineCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    create_info.stageCount = static_cast<uint32_t>(stages.size());
+    create_info.pStages = &stages[0];
+    create_info.pVertexInputState = &vertex_input_state;
+    create_info.pInputAssemblyState = &input_assembly_state;
+    create_info.pViewportState = &viewport_state;
+    create_info.pRasterizationState = &rasterization_state;
+    create_info.pMultisampleState = &multisample_state;
+    create_info.pColorBlendState = &color_blend_state;
+    create_info.layout = pipeline_layout_;
+    create_info.renderPass = render_pass_;
+
+    check(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &create_info, nullptr, &pipeline_),
+          "create a graphics pipeline");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_quad_buffer_()
+{
+    quad_buffer_ = create_host_buffer_(sizeof(Vertex) * quad_vertex_count, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    quad(identity, reinterpret_cast<Vertex*>(quad_buffer_.data));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_sampler_()
+{
+    VkSamplerCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    create_info.magFilter = VK_FILTER_LINEAR;
+    create_info.minFilter = VK_FILTER_LINEAR;
+    create_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    create_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    create_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+    check(vkCreateSampler(device_, &create_info, nullptr, &sampler_), "create a sampler");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_textures_(uint32_t count)
+{
+    if (textures_.size() >= count)
+        return;
+
+    vkDeviceWaitIdle(device_);
+
+    vector<VkImageMemoryBarrier> barriers;
+
+    while (textures_.size() < count) {
+        Texture_ texture;
+
+        VkImageCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        create_info.imageType = VK_IMAGE_TYPE_2D;
+        create_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+        create_info.extent = {texture_size, texture_size, 1};
+        create_info.mipLevels = 1;
+        create_info.arrayLayers = 1;
+        create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        create_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        check(vkCreateImage(device_, &create_info, nullptr, &texture.image), "create an image");
+
+        VkMemoryRequirements requirements;
+
+        vkGetImageMemoryRequirements(device_, texture.image, &requirements);
+        texture.device_memory = allocate_memory_(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        check(vkBindImageMemory(device_, texture.image, texture.device_memory, 0), "bind a memory");
+
+        VkImageViewCreateInfo view_create_info {};
+
+        view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_create_info.image = texture.image;
+        view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_create_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+        view_create_info.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+        check(vkCreateImageView(device_, &view_create_info, nullptr, &texture.image_view), "create an image view");
+
+        barriers.push_back(image_barrier(texture.image,
+                                         VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                         0, VK_ACCESS_SHADER_READ_BIT));
+        textures_.push_back(texture);
+    }
+
+    // every texture stays in the shader read only layout between uploads.
+    auto command_buffer = command_buffers_[0];
+
+    VkCommandBufferBeginInfo begin_info {};
+
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkResetCommandBuffer(command_buffer, 0);
+    vkBeginCommandBuffer(command_buffer, &begin_info);
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0,
+                         0, nullptr,
+                         0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), &barriers[0]);
+    vkEndCommandBuffer(command_buffer);
+
+    VkSubmitInfo submit_info {};
+
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+
+    check(vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE), "submit");
+    vkQueueWaitIdle(queue_);
+
+    VkDescriptorImageInfo image_info {sampler_, textures_[0].image_view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+    VkWriteDescriptorSet write {};
+
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptor_set_;
+    write.dstBinding = 1;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &image_info;
+
+    vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::init_host_buffers_(const Workload& workload)
+{
+    vkDeviceWaitIdle(device_);
+    term_host_buffers_();
+
+    auto stream_count = workload.type == Workload_type::buffer_streaming ? workload.call_count : 1;
+    auto staging_count = workload.type == Workload_type::texture_upload ? workload.call_count : 1;
+
+    // each frame in flight owns a region of every buffer, so the CPU never writes what the GPU reads.
+    uniform_buffer_ = create_host_buffer_(frames_in_flight * workload.call_count * uniform_stride,
+                                          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+    stream_buffer_ = create_host_buffer_(frames_in_flight * stream_count * quad_vertex_count * sizeof(Vertex),
+                                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    staging_buffer_ = create_host_buffer_(frames_in_flight * staging_count * texture_byte_size,
+                                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+    VkDescriptorBufferInfo buffer_info {uniform_buffer_.buffer, 0, sizeof(Uniform)};
+
+    VkWriteDescriptorSet write {};
+
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptor_set_;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    write.pBufferInfo = &buffer_info;
+
+    vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_instance_()
+{
+    vkDestroyInstance(instance_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_device_()
+{
+    vkDestroyDevice(device_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_command_buffers_()
+{
+    vkDestroyCommandPool(device_, command_pool_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_fences_()
+{
+    for (auto& fence : fences_)
+        vkDestroyFence(device_, fence, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_render_target_()
+{
+    vkDestroyImageView(device_, color_image_view_, nullptr);
+    vkDestroyImage(device_, color_image_, nullptr);
+    vkFreeMemory(device_, color_device_memory_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_render_pass_()
+{
+    vkDestroyRenderPass(device_, render_pass_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_framebuffer_()
+{
+    vkDestroyFramebuffer(device_, framebuffer_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_descriptor_set_()
+{
+    vkDestroyDescriptorPool(device_, descriptor_pool_, nullptr);
+    vkDestroyDescriptorSetLayout(device_, descriptor_set_layout_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_pipeline_()
+{
+    vkDestroyPipeline(device_, pipeline_, nullptr);
+    vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
+    vkDestroyShaderModule(device_, fragment_shader_module_, nullptr);
+    vkDestroyShaderModule(device_, vertex_shader_module_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_quad_buffer_()
+{
+    destroy_host_buffer_(quad_buffer_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_sampler_()
+{
+    vkDestroySampler(device_, sampler_, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_textures_()
+{
+    for (auto& texture : textures_) {
+        vkDestroyImageView(device_, texture.image_view, nullptr);
+        vkDestroyImage(device_, texture.image, nullptr);
+        vkFreeMemory(device_, texture.device_memory, nullptr);
+    }
+
+    textures_.clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::term_host_buffers_()
+{
+    destroy_host_buffer_(staging_buffer_);
+    destroy_host_buffer_(stream_buffer_);
+    destroy_host_buffer_(uniform_buffer_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::frame_(const Workload& workload, const Workload_data& data)
+{
+    auto frame = frame_index_++ % frames_in_flight;
+    auto command_buffer = command_buffers_[frame];
+
+    // wait until the GPU finishes the frame which used the same regions.
+    check(vkWaitForFences(device_, 1, &fences_[frame], VK_TRUE, UINT64_MAX), "wait for a fence");
+    vkResetFences(device_, 1, &fences_[frame]);
+
+    uint32_t uniform_offset = frame * workload.call_count * uniform_stride;
+    uint32_t first_vertex = frame * workload.call_count * quad_vertex_count;
+
+    VkCommandBufferBeginInfo begin_info {};
+
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkResetCommandBuffer(command_buffer, 0);
+    vkBeginCommandBuffer(command_buffer, &begin_info);
+
+    if (workload.type == Workload_type::texture_upload) {
+        // uploads are batched between two barriers instead of synchronizing each upload.
+        vector<VkImageMemoryBarrier> barriers;
+
+        for (auto i = 0; i != workload.call_count; ++i)
+            barriers.push_back(image_barrier(textures_[i].image,
+                                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                             VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT));
+
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0,
+                             0, nullptr,
+                             0, nullptr,
+                             static_cast<uint32_t>(barriers.size()), &barriers[0]);
+
+        for (auto i = 0; i != workload.call_count; ++i) {
+            VkDeviceSize offset = (frame * workload.call_count + i) * texture_byte_size;
+
+            memcpy(staging_buffer_.data + offset, &data.texels[0], texture_byte_size);
+
+            VkBufferImageCopy region {};
+
+            region.bufferOffset = offset;
+            region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+            region.imageExtent = {texture_size, texture_size, 1};
+
+            vkCmdCopyBufferToImage(command_buffer, staging_buffer_.buffer, textures_[i].image,
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+        }
+
+        for (auto& barrier : barriers) {
+            swap(barrier.oldLayout, barrier.newLayout);
+            swap(barrier.srcAccessMask, barrier.dstAccessMask);
+        }
+
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                             0,
+                             0, nullptr,
+                             0, nullptr,
+                             static_cast<uint32_t>(barriers.size()), &barriers[0]);
+    }
+
+    VkClearValue clear_value {};
+
+    VkRenderPassBeginInfo render_pass_begin_info {};
+
+    render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    render_pass_begin_info.renderPass = render_pass_;
+    render_pass_begin_info.framebuffer = framebuffer_;
+    render_pass_begin_info.renderArea = {{0, 0}, {target_size, target_size}};
+    render_pass_begin_info.clearValueCount = 1;
+    render_pass_begin_info.pClearValues = &clear_value;
+
+    vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+    vkCmdPushConstants(command_buffer, pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(identity),
+                       &identity[0]);
+
+    VkDeviceSize vertex_offset {0};
+
+    if (workload.type == Workload_type::buffer_streaming)
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &stream_buffer_.buffer, &vertex_offset);
+    else
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &quad_buffer_.buffer, &vertex_offset);
+
+    switch (workload.type) {
+        case Workload_type::uniform_update:
+            // each draw writes its own region and selects it with a dynamic offset.
+            for (auto i = 0; i != workload.call_count; ++i) {
+                uint32_t offset = uniform_offset + i * uniform_stride;
+
+                memcpy(uniform_buffer_.data + offset, &data.uniforms[i], sizeof(Uniform));
+                vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_,
+                                        0, 1, &descriptor_set_, 1, &offset);
+                vkCmdDraw(command_buffer, quad_vertex_count, 1, 0, 0);
+            }
+            break;
+        case Workload_type::small_draw:
+            memcpy(uniform_buffer_.data + uniform_offset, &data.uniforms[0], sizeof(Uniform));
+            vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_,
+                                    0, 1, &descriptor_set_, 1, &uniform_offset);
+
+            for (auto i = 0; i != workload.call_count; ++i) {
+                vkCmdPushConstants(command_buffer, pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT,
+                                   0, sizeof(identity), &data.transforms[i][0]);
+                vkCmdDraw(command_buffer, quad_vertex_count, 1, 0, 0);
+            }
+            break;
+        case Workload_type::texture_upload:
+            memcpy(uniform_buffer_.data + uniform_offset, &data.uniforms[0], sizeof(Uniform));
+            vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_,
+                                    0, 1, &descriptor_set_, 1, &uniform_offset);
+            vkCmdDraw(command_buffer, quad_vertex_count, 1, 0, 0);
+            break;
+        case Workload_type::buffer_streaming:
+            // a ring buffer, vertices are appended to the region of the frame and drawn with a first vertex.
+            memcpy(uniform_buffer_.data + uniform_offset, &data.uniforms[0], sizeof(Uniform));
+            vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_,
+                                    0, 1, &descriptor_set_, 1, &uniform_offset);
+
+            for (auto i = 0; i != workload.call_count; ++i) {
+                auto vertex = first_vertex + i * quad_vertex_count;
+
+                memcpy(stream_buffer_.data + vertex * sizeof(Vertex), &data.vertices[i * quad_vertex_count],
+                       sizeof(Vertex) * quad_vertex_count);
+                vkCmdDraw(command_buffer, quad_vertex_count, 1, vertex, 0);
+            }
+            break;
+    }
+
+    vkCmdEndRenderPass(command_buffer);
+    vkEndCommandBuffer(command_buffer);
+
+    VkSubmitInfo submit_info {};
+
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+
+    check(vkQueueSubmit(queue_, 1, &submit_info, fences_[frame]), "submit");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Vk_backend::Host_buffer_ Vk_backend::create_host_buffer_(VkDeviceSize size, VkBufferUsageFlags usage)
+{
+    Host_buffer_ host_buffer;
+
+    VkBufferCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    create_info.size = size;
+    create_info.usage = usage;
+
+    check(vkCreateBuffer(device_, &create_info, nullptr, &host_buffer.buffer), "create a buffer");
+
+    VkMemoryRequirements requirements;
+
+    vkGetBufferMemoryRequirements(device_, host_buffer.buffer, &requirements);
+
+    // the memory is coherent and stays mapped, so writes don't need flushes.
+    host_buffer.device_memory = allocate_memory_(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    check(vkBindBufferMemory(device_, host_buffer.buffer, host_buffer.device_memory, 0), "bind a memory");
+    check(vkMapMemory(device_, host_buffer.device_memory, 0, VK_WHOLE_SIZE, 0,
+                      reinterpret_cast<void**>(&host_buffer.data)), "map a memory");
+
+    return host_buffer;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Vk_backend::destroy_host_buffer_(Host_buffer_& host_buffer)
+{
+    if (host_buffer.device_memory)
+        vkUnmapMemory(device_, host_buffer.device_memory);
+
+    vkDestroyBuffer(device_, host_buffer.buffer, nullptr);
+    vkFreeMemory(device_, host_buffer.device_memory, nullptr);
+
+    host_buffer = {};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkDeviceMemory Vk_backend::allocate_memory_(const VkMemoryRequirements& requirements,
+                                            VkMemoryPropertyFlags properties)
+{
+    for (auto i = 0; i != memory_properties_.memoryTypeCount; ++i) {
+        if (!(requirements.memoryTypeBits & (1 << i)))
+            continue;
+
+        if ((memory_properties_.memoryTypes[i].propertyFlags & properties) != properties)
+            continue;
+
+        VkMemoryAllocateInfo allocate_info {};
+
+        allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocate_info.allocationSize = requirements.size;
+        allocate_info.memoryTypeIndex = i;
+
+        VkDeviceMemory device_memory;
+
+        check(vkAllocateMemory(device_, &allocate_info, nullptr, &device_memory), "allocate a memory");
+
+        return device_memory;
+    }
+
+    throw runtime_error("fail to find a memory type");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef BENCHMARK_VK_BACKEND_GUARD
+#define BENCHMARK_VK_BACKEND_GUARD
+
+#include <array>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Workload.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// renders to an offscreen image, so it runs without a display.
+class Vk_backend final {
+public:
+    // picks the first device whose name contains the given name, e.g. llvmpipe for lavapipe.
+    explicit Vk_backend(const std::string& device_name);
+
+    ~Vk_backend();
+
+    Result run(const Workload& workload);
+
+    [[nodiscard]]
+    std::string name() const;
+
+private:
+    struct Host_buffer_ {
+        VkBuffer buffer {VK_NULL_HANDLE};
+        VkDeviceMemory device_memory {VK_NULL_HANDLE};
+        uint8_t* data {nullptr};
+    };
+
+    struct Texture_ {
+        VkImage image {VK_NULL_HANDLE};
+        VkDeviceMemory device_memory {VK_NULL_HANDLE};
+        VkImageView image_view {VK_NULL_HANDLE};
+    };
+
+    void init_instance_();
+
+    void init_physical_device_(const std::string& device_name);
+
+    void init_device_();
+
+    void init_command_buffers_();
+
+    void init_fences_();
+
+    void init_render_target_();
+
+    void init_render_pass_();
+
+    void init_framebuffer_();
+
+    void init_descriptor_set_();
+
+    void init_pipeline_();
+
+    void init_quad_buffer_();
+
+    void init_sampler_();
+
+    void init_textures_(uint32_t count);
+
+    void init_host_buffers_(const Workload& workload);
+
+    void term_instance_();
+
+    void term_device_();
+
+    void term_command_buffers_();
+
+    void term_fences_();
+
+    void term_render_target_();
+
+    void term_render_pass_();
+
+    void term_framebuffer_();
+
+    void term_descriptor_set_();
+
+    void term_pipeline_();
+
+    void term_quad_buffer_();
+
+    void term_sampler_();
+
+    void term_textures_();
+
+    void term_host_buffers_();
+
+    void frame_(const Workload& workload, const Workload_data& data);
+
+    [[nodiscard]]
+    Host_buffer_ create_host_buffer_(VkDeviceSize size, VkBufferUsageFlags usage);
+
+    void destroy_host_buffer_(Host_buffer_& host_buffer);
+
+    [[nodiscard]]
+    VkDeviceMemory allocate_memory_(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties);
+
+private:
+    VkInstance instance_;
+    VkPhysicalDevice physical_device_;
+    VkPhysicalDeviceProperties properties_;
+    VkPhysicalDeviceMemoryProperties memory_properties_;
+    uint32_t queue_family_index_;
+    VkDevice device_;
+    VkQueue queue_;
+    VkCommandPool command_pool_;
+    std::array<VkCommandBuffer, frames_in_flight> command_buffers_;
+    std::array<VkFence, frames_in_flight> fences_;
+    uint64_t frame_index_;
+    VkImage color_image_;
+    VkDeviceMemory color_device_memory_;
+    VkImageView color_image_view_;
+    VkRenderPass render_pass_;
+    VkFramebuffer framebuffer_;
+    VkDescriptorSetLayout descriptor_set_layout_;
+    VkDescriptorPool descriptor_pool_;
+    VkDescriptorSet descriptor_set_;
+    VkShaderModule vertex_shader_module_;
+    VkShaderModule fragment_shader_module_;
+    VkPipelineLayout pipeline_layout_;
+    VkPipeline pipeline_;
+    Host_buffer_ quad_buffer_;
+    VkSampler sampler_;
+    std::vector<Texture_> textures_;
+    Host_buffer_ uniform_buffer_;
+    Host_buffer_ stream_buffer_;
+    Host_buffer_ staging_buffer_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif // BENCHMARK_VK_BACKEND_GUARD
@@ -0,0 +1,190 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <cmath>
+#include <ctime>
+#include <stdexcept>
+#include "Workload.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string to_string(Workload_type type)
+{
+    switch (type) {
+        case Workload_type::uniform_update:
+            return "uniform_update";
+        case Workload_type::small_draw:
+            return "small_draw";
+        case Workload_type::texture_upload:
+            return "texture_upload";
+        case Workload_type::buffer_streaming:
+            return "buffer_streaming";
+        default:
+            throw runtime_error("invalid workload type");
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<Workload> default_workloads()
+{
+    return {
+        {Workload_type::uniform_update, 256, 256},
+        {Workload_type::small_draw, 256, 4096},
+        {Workload_type::texture_upload, 256, 4},
+        {Workload_type::buffer_streaming, 256, 256}
+    };
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Workload_data workload_data(const Workload& workload)
+{
+    Workload_data data;
+
+    for (auto i = 0; i != workload.call_count; ++i) {
+        auto call_transform = transform(i, workload.call_count);
+
+        data.transforms.push_back(call_transform);
+        data.uniforms.push_back({
+            {1.0f, static_cast<float>(i) / workload.call_count, 0.5f, 1.0f},
+            {call_transform[0], call_transform[1], call_transform[2], call_transform[3]}
+        });
+
+        data.vertices.resize(data.vertices.size() + quad_vertex_count);
+        quad(call_transform, &data.vertices[data.vertices.size() - quad_vertex_count]);
+    }
+
+    data.texels.resize(texture_size * texture_size);
+    texels(0, &data.texels[0]);
+
+    return data;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const std::string& vertex_src()
+{
+    // the push constant becomes a plain uniform in GLSL, so both APIs get a per draw constant.
+    static const string src {
+        "layout(location = 0) in vec2 i_pos;                               \n"
+        "layout(location = 1) in vec2 i_uv;                                \n"
+        "                                                                  \n"
+        "layout(location = 0) out vec4 o_col;                              \n"
+        "layout(location = 1) out vec2 o_uv;                               \n"
+        "                                                                  \n"
+        "layout(set = 0, binding = 0) uniform Frame {                      \n"
+        "    vec4 col;                                                     \n"
+        "    vec4 transform;                                               \n"
+        "} frame;                                                          \n"
+        "                                                                  \n"
+        "layout(push_constant) uniform Draw {                              \n"
+        "    vec4 transform;                                               \n"
+        "} draw;                                                           \n"
+        "                                                                  \n"
+        "void main() {                                                     \n"
+        "    vec2 pos = i_pos * draw.transform.zw + draw.transform.xy;     \n"
+        "                                                                  \n"
+        "    pos = pos * frame.transform.zw + frame.transform.xy;          \n"
+        "    gl_Position = vec4(pos, 0.0, 1.0);                            \n"
+        "    o_col = frame.col;                                            \n"
+        "    o_uv = i_uv;                                                  \n"
+        "}                                                                 \n"
+    };
+
+    return src;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const std::string& fragment_src()
+{
+    static const string src {
+        "precision mediump float;                            \n"
+        "                                                    \n"
+        "layout(location = 0) in vec4 i_col;                 \n"
+        "layout(location = 1) in vec2 i_uv;                  \n"
+        "                                                    \n"
+        "layout(location = 0) out vec4 fragment_color0;      \n"
+        "                                                    \n"
+        "layout(set = 0, binding = 1) uniform sampler2D tex; \n"
+        "                                                    \n"
+        "void main() {                                       \n"
+        "    fragment_color0 = i_col * texture(tex, i_uv);   \n"
+        "}                                                   \n"
+    };
+
+    return src;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::array<float, 4> transform(uint32_t index, uint32_t count) noexcept
+{
+    auto column_count = static_cast<uint32_t>(ceil(sqrt(static_cast<double>(count))));
+    auto scale = 2.0f / column_count;
+
+    return {
+        -1.0f + (index % column_count) * scale,
+        -1.0f + (index / column_count) * scale,
+        scale,
+        scale
+    };
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void quad(const std::array<float, 4>& transform, Vertex* vertices) noexcept
+{
+    constexpr Vertex unit[quad_vertex_count] = {
+        {0.0f, 0.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f, 1.0f},
+        {0.0f, 1.0f, 0.0f, 1.0f},
+        {1.0f, 0.0f, 1.0f, 0.0f},
+        {1.0f, 1.0f, 1.0f, 1.0f}
+    };
+
+    auto [tx, ty, sx, sy] = transform;
+
+    for (auto i = 0; i != quad_vertex_count; ++i)
+        vertices[i] = {unit[i].x * sx + tx, unit[i].y * sy + ty, unit[i].u, unit[i].v};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void texels(uint32_t frame, uint32_t* texels) noexcept
+{
+    for (auto y = 0; y != texture_size; ++y) {
+        for (auto x = 0; x != texture_size; ++x)
+            texels[y * texture_size + x] = (((x ^ y) + frame) & 0x10) ? 0xffffffff : 0xff000000;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+double thread_cpu_time() noexcept
+{
+    timespec time;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+
+    return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+double wall_time() noexcept
+{
+    timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
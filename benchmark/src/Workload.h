@@ -0,0 +1,98 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef BENCHMARK_WORKLOAD_GUARD
+#define BENCHMARK_WORKLOAD_GUARD
+
+#include <cstdint>
+#include <array>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr auto target_size {256};
+constexpr auto texture_size {256};
+constexpr auto frames_in_flight {2};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+enum class Workload_type : uint8_t {
+    uniform_update = 0, small_draw, texture_upload, buffer_streaming
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a call is the operation the workload measures, e.g. a draw or an upload, and the other API calls of
+// the operation are charged to it.
+struct Workload final {
+    Workload_type type;
+    uint32_t frame_count;
+    uint32_t call_count;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Result final {
+    double wall_time {0.0}; // nanoseconds of the whole run
+    double cpu_time {0.0};  // nanoseconds spent by the submitting thread
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Vertex final {
+    float x, y;
+    float u, v;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the uniform block is aligned to 256 bytes which satisfies minUniformBufferOffsetAlignment of every device.
+constexpr auto uniform_stride {256};
+constexpr auto quad_vertex_count {6};
+
+struct Uniform final {
+    float color[4];
+    float transform[4];
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the data of calls is prepared before measuring, so both APIs only pay for the API calls.
+struct Workload_data final {
+    std::vector<std::array<float, 4>> transforms;
+    std::vector<Uniform> uniforms;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> texels;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string to_string(Workload_type type);
+
+std::vector<Workload> default_workloads();
+
+Workload_data workload_data(const Workload& workload);
+
+const std::string& vertex_src();
+
+const std::string& fragment_src();
+
+// returns the translation and the scale which place the index of a call in a grid.
+std::array<float, 4> transform(uint32_t index, uint32_t count) noexcept;
+
+// fills a unit quad which is placed by a transform.
+void quad(const std::array<float, 4>& transform, Vertex* vertices) noexcept;
+
+// fills the texels of a texture with a pattern which changes by the frame.
+void texels(uint32_t frame, uint32_t* texels) noexcept;
+
+double thread_cpu_time() noexcept;
+
+double wall_time() noexcept;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif // BENCHMARK_WORKLOAD_GUARD
@@ -0,0 +1,104 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <fmt/format.h>
+#include "Gl_backend.h"
+#include "Vk_backend.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto starts_with(const string& str, const string& prefix)
+{
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void print(const string& api, const string& renderer, const Workload& workload, const Result& result)
+{
+    cout << fmt::format("{:<4}{:<32}{:<20}{:>8}{:>14.3f}{:>14.3f}{:>14.3f}",
+                        api, renderer.substr(0, 31), to_string(workload.type), workload.call_count,
+                        result.wall_time / workload.frame_count / 1e6,
+                        result.cpu_time / workload.frame_count / 1e6,
+                        result.cpu_time / workload.frame_count / workload.call_count / 1e3) << endl;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void run(const string& api, T& backend, const vector<Workload>& workloads)
+{
+    for (auto& workload : workloads)
+        print(api, backend.name(), workload, backend.run(workload));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    string api {"both"};
+    string device_name;
+    auto workloads = default_workloads();
+
+    for (auto i = 1; i != argc; ++i) {
+        string arg {argv[i]};
+
+        if (arg == "--software") {
+            // llvmpipe for OpenGL and lavapipe for Vulkan.
+            setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+            device_name = "llvmpipe";
+        }
+        else if (starts_with(arg, "--api=")) {
+            api = arg.substr(6);
+        }
+        else if (starts_with(arg, "--device=")) {
+            device_name = arg.substr(9);
+        }
+        else if (starts_with(arg, "--frames=")) {
+            for (auto& workload : workloads)
+                workload.frame_count = stoul(arg.substr(9));
+        }
+        else {
+            cerr << "usage : gl_vs_vk [--software] [--api=gl|vk|both] [--device=<name>] [--frames=<count>]" << endl;
+            return 1;
+        }
+    }
+
+    cout << fmt::format("{:<4}{:<32}{:<20}{:>8}{:>14}{:>14}{:>14}",
+                        "api", "renderer", "workload", "calls", "wall ms/frame", "cpu ms/frame", "cpu us/call")
+         << endl;
+
+    try {
+        if (api == "gl" || api == "both") {
+            Gl_backend backend;
+
+            run("gl", backend, workloads);
+        }
+
+        if (api == "vk" || api == "both") {
+            Vk_backend backend {device_name};
+
+            run("vk", backend, workloads);
+        }
+    }
+    catch (exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
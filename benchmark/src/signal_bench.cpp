@@ -0,0 +1,88 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <chrono>
+#include <iostream>
+#include <fmt/format.h>
+#include <sigs.h>
+#include <platform/Signal.h>
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr auto emit_count {1000000};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Listener {
+    void on_render()
+    { ++count; }
+
+    uint64_t count {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// returns the time of an emission in nanoseconds.
+template<typename Signal>
+inline auto measure(uint32_t listener_count)
+{
+    Signal signal;
+    vector<Listener> listeners(listener_count);
+
+    for (auto& listener : listeners)
+        signal.connect(&listener, &Listener::on_render);
+
+    auto begin = chrono::steady_clock::now();
+
+    for (auto i = 0; i != emit_count; ++i)
+        signal();
+
+    auto end = chrono::steady_clock::now();
+
+    // the count keeps the compiler from removing the emissions.
+    uint64_t count {0};
+
+    for (auto& listener : listeners)
+        count += listener.count;
+
+    if (count != static_cast<uint64_t>(emit_count) * listener_count)
+        throw runtime_error("fail to emit a signal");
+
+    return chrono::duration<double, nano>(end - begin).count() / emit_count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    cout << fmt::format("{:>10}{:>18}{:>18}{:>10}", "listeners", "sigs ns/emit", "platform ns/emit", "speedup")
+         << endl;
+
+    try {
+        for (auto listener_count : {1u, 4u, 16u, 64u}) {
+            auto sigs_time = measure<sigs::Signal<void()>>(listener_count);
+            auto platform_time = measure<Platform::Signal<void()>>(listener_count);
+
+            cout << fmt::format("{:>10}{:>18.2f}{:>18.2f}{:>10.2f}",
+                                listener_count, sigs_time, platform_time, sigs_time / platform_time) << endl;
+        }
+    }
+    catch (exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -6,16 +6,19 @@
 #include <cassert>
 #include <iostream>
 #include <vector>
-#include <vulkan/vulkan.h>
+#include <vlk/Vulkan.h>
 
 using namespace std;
+using namespace Vlk;
 
 //----------------------------------------------------------------------------------------------------------------------
 
 VkInstance instance_ {VK_NULL_HANDLE};
+Instance_table instance_table_;
 VkPhysicalDevice  physical_device_ {VK_NULL_HANDLE};
 uint32_t queue_family_index_ {UINT32_MAX};
 VkDevice device_ {VK_NULL_HANDLE};
+Device_table device_table_;
 VkQueue queue_ {VK_NULL_HANDLE};
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -24,6 +27,9 @@ int main(int argc, char* argv[])
 {
     VkResult result = VK_SUCCESS;
 
+    // 벌칸 로더를 열고 인스턴스를 생성하기 위한 함수들을 가져옵니다.
+    load_global_functions();
+
     {
         // 사용가능한 레이어의 수를 얻기 위한 변수를 선언합니다.
         uint32_t count {0};
@@ -64,6 +70,9 @@ int main(int argc, char* argv[])
         // 인스턴스를 생성합니다.
         result = vkCreateInstance(&create_info, nullptr, &instance_);
         assert(result == VK_SUCCESS);
+
+        // 인스턴스로부터 인스턴스 함수들을 인스턴스의 테이블로 가져옵니다.
+        instance_table_ = load_instance_table(instance_);
     }
 
     if (result == VK_SUCCESS) {
@@ -71,7 +80,7 @@ int main(int argc, char* argv[])
         uint32_t count {0};
 
         // 사용가능한 물리 디바이스의 수를 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, nullptr);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, nullptr);
 
         // 사용가능한 물리 디바이스들의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkPhysicalDevice> physical_devices;
@@ -80,14 +89,14 @@ int main(int argc, char* argv[])
         physical_devices.resize(count);
 
         // 사용가능한 물리 디바이스들의 핸들을 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
 
         for (auto &physical_device : physical_devices) {
             // 물리 디바이스의 속성을 얻기 위한 변수를 선언합니다.
             VkPhysicalDeviceProperties properties;
 
             // 물리 디바이스의 속성을 얻어옵니다.
-            vkGetPhysicalDeviceProperties(physical_device, &properties);
+            instance_table_.vkGetPhysicalDeviceProperties(physical_device, &properties);
 
             // 물리 디바이스의 이름을 출력합니다.
             cout << "Device Name : " << properties.deviceName << endl;
@@ -104,7 +113,7 @@ int main(int argc, char* argv[])
         uint32_t count {0};
 
         // 사용가능한 큐 패밀리의 수를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
 
         // 사용가능한 큐 패밀리의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkQueueFamilyProperties> properties;
@@ -113,7 +122,7 @@ int main(int argc, char* argv[])
         properties.resize(count);
 
         // 사용가능한 큐 패밀리의 정보를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
 
         for (auto i = 0; i != properties.size(); ++i) {
             // 큐 패밀리에서 사용가능한 큐가 있는지 확인합니다.
@@ -153,13 +162,16 @@ int main(int argc, char* argv[])
         create_info.pQueueCreateInfos = &queue_create_info;
 
         // 디바이스를 생성합니다.
-        result = vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
+        result = instance_table_.vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
         assert(result == VK_SUCCESS);
+
+        // 로더를 거치지 않고 호출하기 위해 디바이스로부터 디바이스 함수들을 디바이스의 테이블로 가져옵니다.
+        device_table_ = load_device_table(instance_table_, device_);
     }
 
     if (result == VK_SUCCESS) {
         // 디바이스로 부터 생성된 큐의 핸들을 얻어옵니다.
-        vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+        device_table_.vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
     }
 
     return 0;
@@ -12,11 +12,12 @@
 
 #include <iostream>
 #include <vector>
-#include <vulkan/vulkan.h>
+#include <vlk/Vulkan.h>
 #include <platform/Window.h>
 
 using namespace std;
 using namespace Platform;
+using namespace Vlk;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -25,13 +26,18 @@ public:
     Chapter4(Window* window) :
         window_ {window},
         instance_ {VK_NULL_HANDLE},
+        instance_table_ {},
         physical_device_ {VK_NULL_HANDLE},
         queue_family_index_ {UINT32_MAX},
         device_ {VK_NULL_HANDLE},
+        device_table_ {},
         queue_ {VK_NULL_HANDLE},
         surface_ {VK_NULL_HANDLE},
         swapchain_ {VK_NULL_HANDLE}
     {
+        // 벌칸 로더를 열고 인스턴스를 생성하기 위한 함수들을 가져옵니다.
+        load_global_functions();
+
         init_signals_();
         print_instance_extensions_();
         init_instance_();
@@ -95,6 +101,8 @@ private:
             "VK_KHR_surface",
 #if defined(_WIN64)
             "VK_KHR_win32_surface"
+#elif defined(__linux__)
+            "VK_EXT_headless_surface"
 #else
             "VK_MVK_macos_surface"
 #endif
@@ -131,6 +139,9 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
+
+        // 인스턴스로부터 인스턴스 함수들을 인스턴스의 테이블로 가져옵니다.
+        instance_table_ = load_instance_table(instance_);
     }
 
     void find_best_physical_device_()
@@ -139,7 +150,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 물리 디바이스의 수를 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, nullptr);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, nullptr);
 
         // 사용가능한 물리 디바이스들의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkPhysicalDevice> physical_devices;
@@ -148,7 +159,7 @@ private:
         physical_devices.resize(count);
 
         // 사용가능한 물리 디바이스들의 핸들을 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
 
         // 어플리케이션에선 사용가능한 물리 디바이스들 중에서 어플리케이션에
         // 적합한 물리 디바이스를 찾아야 합니다.
@@ -162,7 +173,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 큐 패밀리의 수를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
 
         // 사용가능한 큐 패밀리의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkQueueFamilyProperties> properties;
@@ -171,7 +182,7 @@ private:
         properties.resize(count);
 
         // 사용가능한 큐 패밀리의 정보를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
 
         for (auto i = 0; i != properties.size(); ++i) {
             // 큐 패밀리에서 사용가능한 큐가 있는지 확인합니다.
@@ -197,7 +208,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 익스텐션의 수를 얻어옵니다.
-        vkEnumerateDeviceExtensionProperties(physical_device_, nullptr, &count, nullptr);
+        instance_table_.vkEnumerateDeviceExtensionProperties(physical_device_, nullptr, &count, nullptr);
 
         // 사용가능한 익스텐션들의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkExtensionProperties> properties;
@@ -206,7 +217,7 @@ private:
         properties.resize(count);
 
         // 사용가능한 익스텐션들의 정보를 얻어옵니다.
-        vkEnumerateDeviceExtensionProperties(physical_device_, nullptr, &count, &properties[0]);
+        instance_table_.vkEnumerateDeviceExtensionProperties(physical_device_, nullptr, &count, &properties[0]);
 
         // 익스텐션들의 정보를 출력합니다.
         for (auto& props : properties) {
@@ -246,7 +257,7 @@ private:
         create_info.ppEnabledExtensionNames = &extension_names[0];
 
         // 디바이스를 생성합니다.
-        auto result = vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
+        auto result = instance_table_.vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -273,12 +284,15 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
+
+        // 로더를 거치지 않고 호출하기 위해 디바이스로부터 디바이스 함수들을 디바이스의 테이블로 가져옵니다.
+        device_table_ = load_device_table(instance_table_, device_);
     }
 
     void init_queue_()
     {
         // 디바이스로 부터 생성된 큐의 핸들을 얻어옵니다.
-        vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+        device_table_.vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
     }
 
     void init_surface_()
@@ -301,7 +315,7 @@ private:
         create_info.pView = (__bridge void*)content_view;
 
         // 서피스를 생성합니다.
-        auto result = vkCreateMacOSSurfaceMVK(instance_, &create_info, nullptr, &surface_);
+        auto result = instance_table_.vkCreateMacOSSurfaceMVK(instance_, &create_info, nullptr, &surface_);
 #elif defined(_WIN64)
         // 생성하려는 서피스를 정의합니다.
         VkWin32SurfaceCreateInfoKHR create_info {};
@@ -311,7 +325,16 @@ private:
         create_info.hwnd = static_cast<HWND>(window_->window());
 
         // 서피스를 생성합니다.
-        auto result = vkCreateWin32SurfaceKHR(instance_, &create_info, nullptr, &surface_);
+        auto result = instance_table_.vkCreateWin32SurfaceKHR(instance_, &create_info, nullptr, &surface_);
+#elif defined(__linux__)
+        // 헤드리스 서피스는 디스플레이 없이 스왑체인을 생성할 수 있게 합니다.
+        // 그러므로 디스플레이가 없는 리눅스에서도 렌더링 경로를 그대로 실행할 수 있습니다.
+        VkHeadlessSurfaceCreateInfoEXT create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+        // 서피스를 생성합니다.
+        auto result = instance_table_.vkCreateHeadlessSurfaceEXT(instance_, &create_info, nullptr, &surface_);
 #endif
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
@@ -332,7 +355,8 @@ private:
         VkBool32 supported;
 
         // 물리 디바이스의 큐 패밀리가 서피스를 지원하는지 확인합니다.
-        vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, queue_family_index_, surface_, &supported);
+        instance_table_.vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, queue_family_index_, surface_,
+                                                             &supported);
         assert(supported == VK_TRUE);
     }
 
@@ -342,7 +366,7 @@ private:
         uint32_t count;
 
         // 사용 가능한 프레젠트 모드의 수를 얻어옵니다.
-        vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device_, surface_, &count, nullptr);
+        instance_table_.vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device_, surface_, &count, nullptr);
 
         // 사용 가능한 프레젠트 모드들을 얻기 위한 변수를 선언합니다.
         vector<VkPresentModeKHR> modes;
@@ -351,7 +375,7 @@ private:
         modes.resize(count);
 
         // 사용 가능한 프레젠트 모드들을 얻어옵니다.
-        vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device_, surface_, &count, &modes[0]);
+        instance_table_.vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device_, surface_, &count, &modes[0]);
 
         // 사용 가능한 프레젠트 모드들을 출력합니다.
         for (auto& mode : modes) {
@@ -384,7 +408,7 @@ private:
         uint32_t count;
 
         // 사용 가능한 서피스 포맷의 수를 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, nullptr);
+        instance_table_.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, nullptr);
 
         // 사용가능한 서피스 포맷들을 얻기 위한 변수를 선언합니다.
         vector<VkSurfaceFormatKHR> formats;
@@ -393,7 +417,7 @@ private:
         formats.resize(count);
 
         // 사용가능한 서피스 포맷들을 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, &formats[0]);
+        instance_table_.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, &formats[0]);
 
         // 어플리케이션은 여러 조건을 고려해서 최적의 서피스 포맷을 선택해야합니다.
         // 예제의 간소화를 위해서 첫 번째 서피스 포맷을 사용합니다.
@@ -408,7 +432,14 @@ private:
         VkSurfaceCapabilitiesKHR surface_capabilities;
 
         // 서피스의 능력을 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities);
+        instance_table_.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities);
+
+        // 헤드리스 서피스처럼 서피스가 크기를 정하지 않는다면 윈도우의 크기를 사용합니다.
+        if (surface_capabilities.currentExtent.width == UINT32_MAX) {
+            auto extent = window_->extent();
+
+            surface_capabilities.currentExtent = {extent.w, extent.h};
+        }
 
         // 사용할 수 있는 컴포짓 알파 모드를 검색한다.
         VkCompositeAlphaFlagBitsKHR composite_alpha {static_cast<VkCompositeAlphaFlagBitsKHR>(0)};
@@ -442,7 +473,7 @@ private:
         create_info.presentMode = VK_PRESENT_MODE_FIFO_KHR;
 
         // 스왑체인을 생성합니다.
-        auto result = vkCreateSwapchainKHR(device_, &create_info, nullptr, &swapchain_);
+        auto result = device_table_.vkCreateSwapchainKHR(device_, &create_info, nullptr, &swapchain_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -474,13 +505,13 @@ private:
         uint32_t count;
 
         // 사용 가능한 스왑체인 이미지의 개수를 얻어옵니다.
-        vkGetSwapchainImagesKHR(device_, swapchain_, &count, nullptr);
+        device_table_.vkGetSwapchainImagesKHR(device_, swapchain_, &count, nullptr);
 
         // 사용 가능한 스왑체인 이미지를 얻기 위한 메모리를 할당합니다.
         swapchain_images_.resize(count);
 
         // 사용 가능한 스왑체인 이미지를 얻어옵니다.
-        vkGetSwapchainImagesKHR(device_, swapchain_, &count, &swapchain_images_[0]);
+        device_table_.vkGetSwapchainImagesKHR(device_, swapchain_, &count, &swapchain_images_[0]);
 
         // 스왑체인 생성시 정의한 이미지의 개수는 최소 이미지의 개수이기 때문에
         // 실제로 더 많은 이미지가 생성될 수 있습니다.
@@ -489,25 +520,25 @@ private:
     void fini_instance_()
     {
         // 생성한 인스턴스를 파괴합니다.
-        vkDestroyInstance(instance_, nullptr);
+        instance_table_.vkDestroyInstance(instance_, nullptr);
     }
 
     void fini_device_()
     {
         // 생성한 디바이스를 파괴합니다.
-        vkDestroyDevice(device_, nullptr);
+        device_table_.vkDestroyDevice(device_, nullptr);
     }
 
     void fini_surface_()
     {
         // 생성한 서피스를 파괴합니다.
-        vkDestroySurfaceKHR(instance_, surface_, nullptr);
+        instance_table_.vkDestroySurfaceKHR(instance_, surface_, nullptr);
     }
 
     void fini_swapchain_()
     {
         // 생성한 스왑체인을 파괴합니다.
-        vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+        device_table_.vkDestroySwapchainKHR(device_, swapchain_, nullptr);
     }
 
     void on_startup()
@@ -527,9 +558,11 @@ private:
 private:
     Window* window_;
     VkInstance instance_;
+    Instance_table instance_table_;
     VkPhysicalDevice physical_device_;
     uint32_t queue_family_index_;
     VkDevice device_;
+    Device_table device_table_;
     VkQueue queue_;
     VkSurfaceKHR surface_;
     VkSwapchainKHR swapchain_;
@@ -546,6 +579,13 @@ int main(int argc, char* argv[])
     window_desc.title = L"Chapter04"s;
     window_desc.extent = {512, 512, 1};
 
+#if defined(__linux__)
+    // 헤드리스 윈도우는 기본적으로 5초 동안 실행됩니다.
+    // HEADLESS_FRAME_COUNT, HEADLESS_TIME_BUDGET, HEADLESS_FRAME_RATE 환경 변수로 바꿀 수 있습니다.
+    window_desc.time_budget = 5.0;
+    override_by_env(window_desc);
+#endif
+
     // 윈도우를 생성합니다.
     Window window {window_desc};
 
@@ -555,6 +595,17 @@ int main(int argc, char* argv[])
     // 윈도우를 실행시킵니다.
     window.run();
 
+#if defined(__linux__)
+    // 헤드리스 윈도우에서 측정된 프레임 처리량을 출력합니다.
+    cout << window.frame_count() << " frames";
+
+    // 측정된 시간이 없다면 처리량을 계산할 수 없습니다.
+    if (window.elapsed_time() > 0.0)
+        cout << ", " << window.frame_count() / window.elapsed_time() << " fps";
+
+    cout << endl;
+#endif
+
     return 0;
 }
 
@@ -13,11 +13,12 @@
 #include <iostream>
 #include <vector>
 #include <array>
-#include <vulkan/vulkan.h>
+#include <vlk/Vulkan.h>
 #include <platform/Window.h>
 
 using namespace std;
 using namespace Platform;
+using namespace Vlk;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -31,9 +32,11 @@ public:
     Chapter7(Window* window) :
         window_ {window},
         instance_ {VK_NULL_HANDLE},
+        instance_table_ {},
         physical_device_ {VK_NULL_HANDLE},
         queue_family_index_ {UINT32_MAX},
         device_ {VK_NULL_HANDLE},
+        device_table_ {},
         queue_ {VK_NULL_HANDLE},
         command_pool_ {VK_NULL_HANDLE},
         command_buffer_ {VK_NULL_HANDLE},
@@ -44,6 +47,9 @@ public:
         swapchain_image_extent_ {0, 0},
         render_pass_ {VK_NULL_HANDLE}
     {
+        // 벌칸 로더를 열고 인스턴스를 생성하기 위한 함수들을 가져옵니다.
+        load_global_functions();
+
         init_signals_();
         init_instance_();
         find_best_physical_device_();
@@ -88,6 +94,8 @@ private:
             "VK_KHR_surface",
 #if defined(_WIN64)
             "VK_KHR_win32_surface"
+#elif defined(__linux__)
+            "VK_EXT_headless_surface"
 #else
             "VK_MVK_macos_surface"
 #endif
@@ -124,6 +132,9 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
+
+        // 인스턴스로부터 인스턴스 함수들을 인스턴스의 테이블로 가져옵니다.
+        instance_table_ = load_instance_table(instance_);
     }
 
     void find_best_physical_device_()
@@ -132,7 +143,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 물리 디바이스의 수를 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, nullptr);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, nullptr);
 
         // 사용가능한 물리 디바이스들의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkPhysicalDevice> physical_devices;
@@ -141,7 +152,7 @@ private:
         physical_devices.resize(count);
 
         // 사용가능한 물리 디바이스들의 핸들을 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
 
         // 어플리케이션에선 사용가능한 물리 디바이스들 중에서 어플리케이션에
         // 적합한 물리 디바이스를 찾아야 합니다.
@@ -155,7 +166,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 큐 패밀리의 수를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
 
         // 사용가능한 큐 패밀리의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkQueueFamilyProperties> properties;
@@ -164,7 +175,7 @@ private:
         properties.resize(count);
 
         // 사용가능한 큐 패밀리의 정보를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
 
         for (auto i = 0; i != properties.size(); ++i) {
             // 큐 패밀리에서 사용가능한 큐가 있는지 확인합니다.
@@ -215,7 +226,7 @@ private:
         create_info.ppEnabledExtensionNames = &extension_names[0];
 
         // 디바이스를 생성합니다.
-        auto result = vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
+        auto result = instance_table_.vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -242,12 +253,15 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
+
+        // 로더를 거치지 않고 호출하기 위해 디바이스로부터 디바이스 함수들을 디바이스의 테이블로 가져옵니다.
+        device_table_ = load_device_table(instance_table_, device_);
     }
 
     void init_queue_()
     {
         // 디바이스로 부터 생성된 큐의 핸들을 얻어옵니다.
-        vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+        device_table_.vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
     }
 
     void init_command_pool_()
@@ -260,7 +274,7 @@ private:
         create_info.queueFamilyIndex = queue_family_index_;
 
         // 커맨드 풀을 생성합니다.
-        auto result = vkCreateCommandPool(device_, &create_info, nullptr, &command_pool_);
+        auto result = device_table_.vkCreateCommandPool(device_, &create_info, nullptr, &command_pool_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -285,7 +299,7 @@ private:
         allocate_info.commandBufferCount = 1;
 
         // 커맨드 버퍼를 생성합니다.
-        auto result = vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer_);
+        auto result = device_table_.vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -312,7 +326,7 @@ private:
         // - 첫 번째 세마포어는 스왑체인 이미지가 준비된 후에 제출한 커맨드 버퍼가 처리되기 위해 사용됩니다.
         // - 두 번째 세마포어는 제출한 커맨드 버퍼가 처리된 후에 화면에 출력을 하기 위해 사용됩니다.
         for (auto& semaphore : semaphores_) {
-            auto result = vkCreateSemaphore(device_, &create_info, nullptr, &semaphore);
+            auto result = device_table_.vkCreateSemaphore(device_, &create_info, nullptr, &semaphore);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -339,7 +353,7 @@ private:
         create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
         // 펜스를 생성합니다.
-        auto result = vkCreateFence(device_, &create_info, nullptr, &fence_);
+        auto result = device_table_.vkCreateFence(device_, &create_info, nullptr, &fence_);
 
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
@@ -374,7 +388,7 @@ private:
         create_info.pView = (__bridge void*)content_view;
 
         // 서피스를 생성합니다.
-        auto result = vkCreateMacOSSurfaceMVK(instance_, &create_info, nullptr, &surface_);
+        auto result = instance_table_.vkCreateMacOSSurfaceMVK(instance_, &create_info, nullptr, &surface_);
 #elif defined(_WIN64)
         // 생성하려는 서피스를 정의합니다.
         VkWin32SurfaceCreateInfoKHR create_info {};
@@ -384,7 +398,16 @@ private:
         create_info.hwnd = static_cast<HWND>(window_->window());
 
         // 서피스를 생성합니다.
-        auto result = vkCreateWin32SurfaceKHR(instance_, &create_info, nullptr, &surface_);
+        auto result = instance_table_.vkCreateWin32SurfaceKHR(instance_, &create_info, nullptr, &surface_);
+#elif defined(__linux__)
+        // 헤드리스 서피스는 디스플레이 없이 스왑체인을 생성할 수 있게 합니다.
+        // 그러므로 디스플레이가 없는 리눅스에서도 렌더링 경로를 그대로 실행할 수 있습니다.
+        VkHeadlessSurfaceCreateInfoEXT create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+        // 서피스를 생성합니다.
+        auto result = instance_table_.vkCreateHeadlessSurfaceEXT(instance_, &create_info, nullptr, &surface_);
 #endif
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
@@ -405,7 +428,8 @@ private:
         VkBool32 supported;
 
         // 물리 디바이스의 큐 패밀리가 서피스를 지원하는지 확인합니다.
-        vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, queue_family_index_, surface_, &supported);
+        instance_table_.vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, queue_family_index_, surface_,
+                                                             &supported);
         assert(supported == VK_TRUE);
     }
 
@@ -415,7 +439,7 @@ private:
         uint32_t count;
 
         // 사용 가능한 서피스 포맷의 수를 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, nullptr);
+        instance_table_.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, nullptr);
 
         // 사용가능한 서피스 포맷들을 얻기 위한 변수를 선언합니다.
         vector<VkSurfaceFormatKHR> formats;
@@ -424,7 +448,7 @@ private:
         formats.resize(count);
 
         // 사용가능한 서피스 포맷들을 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, &formats[0]);
+        instance_table_.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, &formats[0]);
 
         // 어플리케이션은 여러 조건을 고려해서 최적의 서피스 포맷을 선택해야합니다.
         // 예제의 간소화를 위해서 첫 번째 서피스 포맷을 사용합니다.
@@ -439,7 +463,14 @@ private:
         VkSurfaceCapabilitiesKHR surface_capabilities;
 
         // 서피스의 능력을 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities);
+        instance_table_.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities);
+
+        // 헤드리스 서피스처럼 서피스가 크기를 정하지 않는다면 윈도우의 크기를 사용합니다.
+        if (surface_capabilities.currentExtent.width == UINT32_MAX) {
+            auto extent = window_->extent();
+
+            surface_capabilities.currentExtent = {extent.w, extent.h};
+        }
 
         // 사용할 수 있는 컴포짓 알파 모드를 검색한다.
         VkCompositeAlphaFlagBitsKHR composite_alpha {static_cast<VkCompositeAlphaFlagBitsKHR>(0)};
@@ -476,7 +507,7 @@ private:
         create_info.presentMode = VK_PRESENT_MODE_FIFO_KHR;
 
         // 스왑체인을 생성합니다.
-        auto result = vkCreateSwapchainKHR(device_, &create_info, nullptr, &swapchain_);
+        auto result = device_table_.vkCreateSwapchainKHR(device_, &create_info, nullptr, &swapchain_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -508,13 +539,13 @@ private:
         uint32_t count;
 
         // 사용 가능한 스왑체인 이미지의 개수를 얻어옵니다.
-        vkGetSwapchainImagesKHR(device_, swapchain_, &count, nullptr);
+        device_table_.vkGetSwapchainImagesKHR(device_, swapchain_, &count, nullptr);
 
         // 사용 가능한 스왑체인 이미지를 얻기 위한 메모리를 할당합니다.
         swapchain_images_.resize(count);
 
         // 사용 가능한 스왑체인 이미지를 얻어옵니다.
-        vkGetSwapchainImagesKHR(device_, swapchain_, &count, &swapchain_images_[0]);
+        device_table_.vkGetSwapchainImagesKHR(device_, swapchain_, &count, &swapchain_images_[0]);
 
         // 스왑체인 생성시 정의한 이미지의 개수는 최소 이미지의 개수이기 때문에
         // 실제로 더 많은 이미지가 생성될 수 있습니다.
@@ -526,7 +557,7 @@ private:
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         // 커맨드 버퍼에 커맨드 기록을 시작한다.
-        vkBeginCommandBuffer(command_buffer_, &begin_info);
+        device_table_.vkBeginCommandBuffer(command_buffer_, &begin_info);
 
         // 스왑체인 이미지의 레이아웃을 PRESENT_SRC로 변경하는 배리어를 정의한다.
         // PRESENT_SRC로 변경하는 이유는 렌더링을 위한 커맨드를 단순화하기 위해서이다.
@@ -548,15 +579,15 @@ private:
         }
 
         // 정의된 배리어를 실행하는 커맨드를 커맨드 버퍼에 기록한다.
-        vkCmdPipelineBarrier(command_buffer_,
-                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                             0,
-                             0, nullptr,
-                             0, nullptr,
-                             barriers.size(), &barriers[0]);
+        device_table_.vkCmdPipelineBarrier(command_buffer_,
+                                           VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                           0,
+                                           0, nullptr,
+                                           0, nullptr,
+                                           barriers.size(), &barriers[0]);
 
         // 커맨드 버퍼에 커맨드 기록을 끝마친다.
-        vkEndCommandBuffer(command_buffer_);
+        device_table_.vkEndCommandBuffer(command_buffer_);
 
         // 어떤 기록된 커맨드를 큐에 제출할지 정의한다.
         VkSubmitInfo submit_info {};
@@ -566,10 +597,10 @@ private:
         submit_info.pCommandBuffers = &command_buffer_;
 
         // 기록된 커맨드를 큐에 제출한다.
-        vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
+        device_table_.vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
 
         // 커맨드 버퍼들이 모두 처리될 때까지 기다린다.
-        vkDeviceWaitIdle(device_);
+        device_table_.vkDeviceWaitIdle(device_);
     }
 
     void init_swapchain_image_views_()
@@ -596,7 +627,7 @@ private:
             create_info.image = swapchain_images_[i];
 
             // 이미지 뷰를 생성합니다.
-            auto result = vkCreateImageView(device_, &create_info, nullptr, &swapchain_image_views_[i]);
+            auto result = device_table_.vkCreateImageView(device_, &create_info, nullptr, &swapchain_image_views_[i]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -648,7 +679,7 @@ private:
         create_info.pSubpasses = &subpass_desc;
 
         // 렌더패스를 생성합니다.
-        auto result = vkCreateRenderPass(device_, &create_info, nullptr, &render_pass_);
+        auto result = device_table_.vkCreateRenderPass(device_, &create_info, nullptr, &render_pass_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -681,7 +712,7 @@ private:
             create_info.pAttachments = &swapchain_image_views_[i];
 
             // 프레임버퍼를 생성합니다.
-            auto result = vkCreateFramebuffer(device_, &create_info, nullptr, &framebuffers_[i]);
+            auto result = device_table_.vkCreateFramebuffer(device_, &create_info, nullptr, &framebuffers_[i]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -699,65 +730,65 @@ private:
     void fini_instance_()
     {
         // 생성한 인스턴스를 파괴합니다.
-        vkDestroyInstance(instance_, nullptr);
+        instance_table_.vkDestroyInstance(instance_, nullptr);
     }
 
     void fini_device_()
     {
         // 생성한 디바이스를 파괴합니다.
-        vkDestroyDevice(device_, nullptr);
+        device_table_.vkDestroyDevice(device_, nullptr);
     }
 
     void fini_command_pool_()
     {
         // 생성한 커맨드 풀을 파괴합니다.
         // 커맨드 풀이 파괴되면 커맨드 버퍼도 파괴됩니다.
-        vkDestroyCommandPool(device_, command_pool_, nullptr);
+        device_table_.vkDestroyCommandPool(device_, command_pool_, nullptr);
     }
 
     void fini_semaphores_()
     {
         // 생성한 세마포어를 파괴합니다.
         for (auto& semaphore : semaphores_)
-            vkDestroySemaphore(device_, semaphore, nullptr);
+            device_table_.vkDestroySemaphore(device_, semaphore, nullptr);
     }
 
     void fini_fence_()
     {
         // 생성한 펜스를 파괴합니다.
-        vkDestroyFence(device_, fence_, nullptr);
+        device_table_.vkDestroyFence(device_, fence_, nullptr);
     }
 
     void fini_surface_()
     {
         // 생성한 서피스를 파괴합니다.
-        vkDestroySurfaceKHR(instance_, surface_, nullptr);
+        instance_table_.vkDestroySurfaceKHR(instance_, surface_, nullptr);
     }
 
     void fini_swapchain_()
     {
         // 생성한 스왑체인을 파괴합니다.
-        vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+        device_table_.vkDestroySwapchainKHR(device_, swapchain_, nullptr);
     }
 
     void fini_swapchain_image_views_()
     {
         // 생성한 이미지 뷰를 파괴합니다.
         for (auto& image_view : swapchain_image_views_)
-            vkDestroyImageView(device_, image_view, nullptr);
+            device_table_.vkDestroyImageView(device_, image_view, nullptr);
     }
 
     void fini_render_pass_()
     {
         // 생성한 렌더 패스를 파괴합니다.
-        vkDestroyRenderPass(device_, render_pass_, nullptr);
+        device_table_.vkDestroyRenderPass(device_, render_pass_, nullptr);
     }
 
     void fini_framebuffers_()
     {
         // 생성한 프레임버퍼를 파괴합니다.
         for (auto& framebuffer : framebuffers_)
-            vkDestroyFramebuffer(device_, framebuffer, nullptr);
+            device_table_.vkDestroyFramebuffer(device_, framebuffer, nullptr);
     }
 
     void on_startup()
@@ -772,7 +803,7 @@ private:
 
     void on_shutdown()
     {
-        vkDeviceWaitIdle(device_);
+        device_table_.vkDeviceWaitIdle(device_);
 
         fini_framebuffers_();
         fini_render_pass_();
@@ -786,23 +817,23 @@ private:
         // 스왑체인으로부터 사용가능한 이미지 인덱스를 얻어옵니다.
         // 세마포어를 통해서 GPU에서 스왑체인 이미지가 언제 사용 가능한지 알 수 있습니다.
         uint32_t swapchain_index;
-        vkAcquireNextImageKHR(device_, swapchain_, UINT64_MAX,
-                              semaphores_[image_available_index], VK_NULL_HANDLE,
-                              &swapchain_index);
+        device_table_.vkAcquireNextImageKHR(device_, swapchain_, UINT64_MAX,
+                                            semaphores_[image_available_index], VK_NULL_HANDLE,
+                                            &swapchain_index);
 
         auto& swapchain_image = swapchain_images_[swapchain_index];
 
         // 새로운 프레임을 렌더링하기 위해선 제출한 커맨드 버퍼가 처리되었는지를 확인해야합니다.
         // 다 처리되었는지를 알기 위해서 큐에 커맨드 버퍼를 제출할 때 파라미터로 펜스를 넘길 수 있습니다.
         // 커맨드 버퍼를 리셋하기 전에 펜스의 상태를 확인한 뒤 언시그널드 상태이면 시그널 상태가 될 때까지 기다립니다.
-        if (VK_NOT_READY == vkGetFenceStatus(device_, fence_))
-            vkWaitForFences(device_, 1, &fence_, VK_TRUE, UINT64_MAX);
+        if (VK_NOT_READY == device_table_.vkGetFenceStatus(device_, fence_))
+            device_table_.vkWaitForFences(device_, 1, &fence_, VK_TRUE, UINT64_MAX);
 
         // 펜스를 언시그널 상태로 변경합니다.
-        vkResetFences(device_, 1, &fence_);
+        device_table_.vkResetFences(device_, 1, &fence_);
 
         // 커맨드 버퍼를 재사용하기 위해서 커맨드 버퍼를 리셋합니다.
-        vkResetCommandBuffer(command_buffer_, 0);
+        device_table_.vkResetCommandBuffer(command_buffer_, 0);
         // 커맨드 버퍼에 기록하는 커맨드들은 변하지 않기 때문에 다시 기록할 필요는 없습니다.
         // 하지만 일반적인 경우에 매 프레임마다 필요한 커맨드들이 다르기 때문에 리셋하고 다시 기록합니다.
 
@@ -813,7 +844,7 @@ private:
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         // 커맨드 버퍼를 기록중 상태로 전이합니다.
-        vkBeginCommandBuffer(command_buffer_, &begin_info);
+        device_table_.vkBeginCommandBuffer(command_buffer_, &begin_info);
 
         {
             // 이미지 배리어를 정의하기 위한 변수를 선언합니다.
@@ -834,12 +865,13 @@ private:
             barrier.subresourceRange.layerCount = 1;
 
             // 이미지 레이아웃 변경을 위한 파이프라인 배리어 커맨드를 기록합니다.
-            vkCmdPipelineBarrier(command_buffer_,
-                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                 0,
-                                 0, nullptr,
-                                 0, nullptr,
-                                 1, &barrier);
+            device_table_.vkCmdPipelineBarrier(command_buffer_,
+                                               VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                               0,
+                                               0, nullptr,
+                                               0, nullptr,
+                                               1, &barrier);
         }
 
         // 클리어 색상을 정의하기 위한 변수를 선언합니다.
@@ -862,10 +894,10 @@ private:
         render_pass_begin_info.pClearValues = &clear_value;
 
         // 렌더 패스를 시작합니다.
-        vkCmdBeginRenderPass(command_buffer_, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+        device_table_.vkCmdBeginRenderPass(command_buffer_, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
         // 렌더 패스를 종료합니다.
-        vkCmdEndRenderPass(command_buffer_);
+        device_table_.vkCmdEndRenderPass(command_buffer_);
 
         {
             // 이미지 배리어를 정의하기 위한 변수를 선언합니다.
@@ -888,17 +920,18 @@ private:
             barrier.subresourceRange.layerCount = 1;
 
             // 이미지 레이아웃 변경을 위한 파이프라인 배리어 커맨드를 기록합니다.
-            vkCmdPipelineBarrier(command_buffer_,
-                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                                 0,
-                                 0, nullptr,
-                                 0, nullptr,
-                                 1, &barrier);
+            device_table_.vkCmdPipelineBarrier(command_buffer_,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                               VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                               0,
+                                               0, nullptr,
+                                               0, nullptr,
+                                               1, &barrier);
         }
 
         // 필요한 모든 커맨드들을 기록했기 때문에 커맨드 버퍼의 커맨드 기록을 끝마칩니다.
         // 커맨드 버퍼의 상태는 실행 가능 상태입니다.
-        vkEndCommandBuffer(command_buffer_);
+        device_table_.vkEndCommandBuffer(command_buffer_);
 
         // 세마포어가 반드시 시그널 되야하는 파이프라인 스테이지를 정의합니다.
         constexpr VkPipelineStageFlags wait_dst_stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -920,7 +953,7 @@ private:
         submit_info.pSignalSemaphores = &semaphores_[rendering_done_index];
 
         // 큐에 커맨드 버퍼를 제출합니다.
-        vkQueueSubmit(queue_, 1, &submit_info, fence_);
+        device_table_.vkQueueSubmit(queue_, 1, &submit_info, fence_);
 
         // 화면에 출력되는 이미지를 정의합니다.
         VkPresentInfoKHR present_info {};
@@ -935,15 +968,17 @@ private:
         present_info.pImageIndices = &swapchain_index;
 
         // 화면에 이미지를 출력합니다.
-        vkQueuePresentKHR(queue_, &present_info);
+        device_table_.vkQueuePresentKHR(queue_, &present_info);
     }
 
 private:
     Window* window_;
     VkInstance instance_;
+    Instance_table instance_table_;
     VkPhysicalDevice physical_device_;
     uint32_t queue_family_index_;
     VkDevice device_;
+    Device_table device_table_;
     VkQueue queue_;
     VkCommandPool command_pool_;
     VkCommandBuffer command_buffer_;
@@ -967,12 +1002,30 @@ int main(int argc, char* argv[])
     window_desc.title = L"Chapter07"s;
     window_desc.extent = {512, 512, 1};
 
+#if defined(__linux__)
+    // 헤드리스 윈도우는 기본적으로 5초 동안 실행됩니다.
+    // HEADLESS_FRAME_COUNT, HEADLESS_TIME_BUDGET, HEADLESS_FRAME_RATE 환경 변수로 바꿀 수 있습니다.
+    window_desc.time_budget = 5.0;
+    override_by_env(window_desc);
+#endif
+
     Window window {window_desc};
 
     Chapter7 chapter7 {&window};
 
     window.run();
 
+#if defined(__linux__)
+    // 헤드리스 윈도우에서 측정된 프레임 처리량을 출력합니다.
+    cout << window.frame_count() << " frames";
+
+    // 측정된 시간이 없다면 처리량을 계산할 수 없습니다.
+    if (window.elapsed_time() > 0.0)
+        cout << ", " << window.frame_count() / window.elapsed_time() << " fps";
+
+    cout << endl;
+#endif
+
     return 0;
 }
 
@@ -3,16 +3,54 @@
 // See "LICENSE" for license information.
 //
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <numeric>
+#include <random>
 #include <sstream>
+#include <string>
 #include <vector>
 #include <vulkan/vulkan.h>
+#include <platform/Stream_copy.h>
+#include <rapidjson/document.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
 
 #define VMA_IMPLEMENTATION
-#include "vk_mem_alloc.h"
+#include <vk_mem_alloc.h>
 
 using namespace std;
+using namespace rapidjson;
+using namespace Platform;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// 벤치마크에서 측정하는 전송 크기들입니다. 이미지 복사를 위해 RGBA8 텍셀의 정사각형이 되는 크기를 사용합니다.
+constexpr array<VkDeviceSize, 3> transfer_sizes {64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+
+// 호스트 접근은 이 시간 이상 반복해서 측정합니다.
+constexpr auto min_host_seconds {0.1};
+
+// 큐의 복사는 이 크기 이상 복사해서 측정합니다.
+constexpr VkDeviceSize min_copy_bytes {256 * 1024 * 1024};
+
+// 랜덤 접근은 캐시 라인 단위로 접근합니다.
+constexpr VkDeviceSize cache_line_size {64};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto starts_with(const string& str, const string& prefix)
+{
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -87,21 +125,48 @@ auto& operator<<(ostream& os, const VkMemoryHeap memory_heap)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+enum class Host_access {
+    sequential_write, sequential_read, random_write, random_read, memcpy, stream_copy
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 class Chapter9 {
 public:
-    Chapter9() :
+    Chapter9(const string& device_name, bool validation) :
         instance_ {VK_NULL_HANDLE},
-        physical_device_ {VK_NULL_HANDLE}
+        physical_device_ {VK_NULL_HANDLE},
+        physical_device_properties_ {},
+        physical_device_memory_properties_ {},
+        queue_family_index_ {UINT32_MAX},
+        timestamp_valid_bits_ {0},
+        device_ {VK_NULL_HANDLE},
+        allocator_ {VK_NULL_HANDLE},
+        queue_ {VK_NULL_HANDLE},
+        command_pool_ {VK_NULL_HANDLE},
+        command_buffer_ {VK_NULL_HANDLE},
+        fence_ {VK_NULL_HANDLE},
+        query_pool_ {VK_NULL_HANDLE},
+        sink_ {0}
     {
-        init_instance_();
-        find_best_physical_device_();
+        init_instance_(validation);
+        find_best_physical_device_(device_name);
         find_queue_family_index_();
         init_device_();
         init_allocator_();
+        init_queue_();
+        init_command_pool_();
+        init_command_buffer_();
+        init_fence_();
+        init_query_pool_();
     }
 
     ~Chapter9()
     {
+        fini_query_pool_();
+        fini_fence_();
+        fini_command_pool_();
+        fini_allocator_();
         fini_device_();
         fini_instance_();
     }
@@ -127,21 +192,117 @@ public:
         // 그러므로 반드시 각각의 특징을 이해하고 올바른 메모리 성질을 선택해야합니다.
     }
 
+    void print_memory_statistics()
+    {
+        // 얼로케이터가 할당한 메모리의 통계를 JSON 문자열로 얻어옵니다.
+        // 힙과 메모리 타입별로 블록의 개수, 사용중인 메모리, 사용하지 않는 메모리와 빈 공간의 크기가 포함됩니다.
+        char* statistics;
+        vmaBuildStatsString(allocator_, &statistics, VK_TRUE);
+
+        cout << statistics << endl;
+
+        // 얼로케이터가 생성한 문자열은 반드시 얼로케이터로 해제해야 합니다.
+        vmaFreeStatsString(allocator_, statistics);
+    }
+
+    void run_bandwidth_benchmark(ostream& os)
+    {
+        // 측정 결과를 JSON 문서로 만듭니다. 디바이스마다 메모리 배치 정책을 정하는데 사용합니다.
+        Document document;
+        auto& allocator = document.GetAllocator();
+
+        document.SetObject();
+        document.AddMember("device", Value(physical_device_properties_.deviceName, allocator), allocator);
+        document.AddMember("driver_version", physical_device_properties_.driverVersion, allocator);
+        document.AddMember("timing", StringRef(timestamp_valid_bits_ ? "timestamp" : "host"), allocator);
+        document.AddMember("unit", "MB/s", allocator);
+        document.AddMember("copy_kernel", StringRef(Platform::to_string(stream_copy_kernel())), allocator);
+
+        Value memory_types {kArrayType};
+
+        for (auto i = 0u; i != physical_device_memory_properties_.memoryTypeCount; ++i) {
+            auto& memory_type = physical_device_memory_properties_.memoryTypes[i];
+            auto& memory_heap = physical_device_memory_properties_.memoryHeaps[memory_type.heapIndex];
+
+            Value results {kArrayType};
+
+            for (auto size : transfer_sizes) {
+                // 복사는 원본과 대상을 같은 힙에 할당할 수 있으므로 힙의 절반보다 큰 크기는 측정하지 않습니다.
+                if (size > memory_heap.size / 2)
+                    continue;
+
+                Value result {kObjectType};
+
+                result.AddMember("size", size, allocator);
+
+                // 호스트에서 접근할 수 없는 메모리 타입은 맵을 할 수 없습니다.
+                auto host_visible = memory_type.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+                result.AddMember("sequential_write",
+                                 to_value_(host_visible ? measure_host_(i, size, Host_access::sequential_write) : -1.0),
+                                 allocator);
+                result.AddMember("sequential_read",
+                                 to_value_(host_visible ? measure_host_(i, size, Host_access::sequential_read) : -1.0),
+                                 allocator);
+                result.AddMember("random_write",
+                                 to_value_(host_visible ? measure_host_(i, size, Host_access::random_write) : -1.0),
+                                 allocator);
+                result.AddMember("random_read",
+                                 to_value_(host_visible ? measure_host_(i, size, Host_access::random_read) : -1.0),
+                                 allocator);
+
+                // 업로드는 호스트 메모리에서 복사합니다. memcpy와 캐시를 거치지 않는 복사를 비교합니다.
+                result.AddMember("memcpy",
+                                 to_value_(host_visible ? measure_host_(i, size, Host_access::memcpy) : -1.0),
+                                 allocator);
+                result.AddMember("stream_copy",
+                                 to_value_(host_visible ? measure_host_(i, size, Host_access::stream_copy) : -1.0),
+                                 allocator);
+
+                // 큐의 복사는 이 메모리 타입의 버퍼를 원본으로 디바이스 메모리에 복사합니다.
+                result.AddMember("buffer_copy", to_value_(measure_buffer_copy_(i, size)), allocator);
+                result.AddMember("image_copy", to_value_(measure_image_copy_(i, size)), allocator);
+
+                results.PushBack(result, allocator);
+            }
+
+            Value value {kObjectType};
+
+            value.AddMember("index", i, allocator);
+            value.AddMember("flags", Value(::to_string(memory_type.propertyFlags).c_str(), allocator), allocator);
+            value.AddMember("heap", memory_type.heapIndex, allocator);
+            value.AddMember("heap_size", memory_heap.size, allocator);
+            value.AddMember("results", results, allocator);
+
+            memory_types.PushBack(value, allocator);
+        }
+
+        document.AddMember("memory_types", memory_types, allocator);
+
+        OStreamWrapper stream {os};
+        PrettyWriter<OStreamWrapper> writer {stream};
+
+        document.Accept(writer);
+        os << endl;
+    }
+
 private:
-    void init_instance_()
+    void init_instance_(bool validation)
     {
         // 벌칸 프로그램을 작성하는데 있어서 반드시 필요한 레이어입니다.
         // 하지만 CPU를 굉장히 많이 사용하기 때문에 개발중에만 사용해야 합니다.
-        vector<const char*> layer_names {
-            "VK_LAYER_KHRONOS_validation"
-        };
+        // 벤치마크는 측정값이 왜곡되지 않도록 레이어를 사용하지 않습니다.
+        vector<const char*> layer_names;
+
+        if (validation)
+            layer_names.push_back("VK_LAYER_KHRONOS_validation");
 
         // 생성하려는 인스턴스를 정의합니다.
         VkInstanceCreateInfo create_info {};
 
         create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
         create_info.enabledLayerCount = layer_names.size();
-        create_info.ppEnabledLayerNames = &layer_names[0];
+        create_info.ppEnabledLayerNames = layer_names.data();
 
         // 인스턴스를 생성합니다.
         auto result = vkCreateInstance(&create_info, nullptr, &instance_);
@@ -167,7 +328,7 @@ private:
         assert(result == VK_SUCCESS);
     }
 
-    void find_best_physical_device_()
+    void find_best_physical_device_(const string& device_name)
     {
         // 사용가능한 물리 디바이스의 수를 얻기 위한 변수를 선언합니다.
         uint32_t count {0};
@@ -186,8 +347,26 @@ private:
 
         // 어플리케이션에선 사용가능한 물리 디바이스들 중에서 어플리케이션에
         // 적합한 물리 디바이스를 찾아야 합니다.
-        // 예제의 간소화를 위해서 첫 번째 물리 디바이스를 사용합니다.
-        physical_device_ = physical_devices[0];
+        // 예제의 간소화를 위해서 이름이 일치하는 첫 번째 물리 디바이스를 사용합니다.
+        // CI에서는 llvmpipe를 이름으로 지정해서 lavapipe를 사용합니다.
+        for (auto& physical_device : physical_devices) {
+            vkGetPhysicalDeviceProperties(physical_device, &physical_device_properties_);
+
+            if (string(physical_device_properties_.deviceName).find(device_name) != string::npos) {
+                physical_device_ = physical_device;
+                break;
+            }
+        }
+
+        // 이름이 일치하는 물리 디바이스가 없다면 에러를 출력하고 종료합니다.
+        if (physical_device_ == VK_NULL_HANDLE) {
+            cerr << "fail to find a physical device " << device_name << endl;
+            fini_instance_();
+            exit(EXIT_FAILURE);
+        }
+
+        // 벤치마크에서 사용할 메모리의 성질을 얻어옵니다.
+        vkGetPhysicalDeviceMemoryProperties(physical_device_, &physical_device_memory_properties_);
     }
 
     void find_queue_family_index_()
@@ -215,6 +394,8 @@ private:
             // 큐 패밀리가 그래픽스 기능을 제공하는지 확인합니다.
             if (VK_QUEUE_GRAPHICS_BIT & properties[i].queueFlags) {
                 queue_family_index_ = i;
+                // 타임스탬프를 지원하지 않는 큐는 호스트의 시간으로 측정합니다.
+                timestamp_valid_bits_ = properties[i].timestampValidBits;
                 break;
             }
 
@@ -289,6 +470,71 @@ private:
         assert(result == VK_SUCCESS);
     }
 
+    void init_queue_()
+    {
+        // 디바이스로부터 큐를 얻어옵니다.
+        vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+    }
+
+    void init_command_pool_()
+    {
+        // 생성하려는 커맨드 풀을 정의합니다.
+        // 커맨드 버퍼를 측정마다 다시 기록하기 때문에 리셋할 수 있어야 합니다.
+        VkCommandPoolCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        create_info.queueFamilyIndex = queue_family_index_;
+
+        // 커맨드 풀을 생성합니다.
+        auto result = vkCreateCommandPool(device_, &create_info, nullptr, &command_pool_);
+        assert(result == VK_SUCCESS);
+    }
+
+    void init_command_buffer_()
+    {
+        // 생성하려는 커맨드 버퍼를 정의합니다.
+        VkCommandBufferAllocateInfo allocate_info {};
+
+        allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocate_info.commandPool = command_pool_;
+        allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocate_info.commandBufferCount = 1;
+
+        // 커맨드 버퍼를 생성합니다.
+        auto result = vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer_);
+        assert(result == VK_SUCCESS);
+    }
+
+    void init_fence_()
+    {
+        // 생성하려는 펜스를 정의합니다.
+        VkFenceCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        // 펜스를 생성합니다.
+        auto result = vkCreateFence(device_, &create_info, nullptr, &fence_);
+        assert(result == VK_SUCCESS);
+    }
+
+    void init_query_pool_()
+    {
+        if (!timestamp_valid_bits_)
+            return;
+
+        // 복사의 시작과 끝에 타임스탬프를 기록하기 위한 쿼리 풀을 정의합니다.
+        VkQueryPoolCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        create_info.queryCount = 2;
+
+        // 쿼리 풀을 생성합니다.
+        auto result = vkCreateQueryPool(device_, &create_info, nullptr, &query_pool_);
+        assert(result == VK_SUCCESS);
+    }
+
     void fini_instance_()
     {
         // 생성한 인스턴스를 파괴합니다.
@@ -307,21 +553,473 @@ private:
         vmaDestroyAllocator(allocator_);
     }
 
+    void fini_command_pool_()
+    {
+        // 생성한 커맨드 풀을 파괴합니다. 커맨드 버퍼도 함께 파괴됩니다.
+        vkDestroyCommandPool(device_, command_pool_, nullptr);
+    }
+
+    void fini_fence_()
+    {
+        // 생성한 펜스를 파괴합니다.
+        vkDestroyFence(device_, fence_, nullptr);
+    }
+
+    void fini_query_pool_()
+    {
+        // 생성한 쿼리 풀을 파괴합니다.
+        vkDestroyQueryPool(device_, query_pool_, nullptr);
+    }
+
+    double measure_host_(uint32_t memory_type_index, VkDeviceSize size, Host_access access)
+    {
+        // 측정하려는 메모리 타입에서 메모리를 할당합니다.
+        VkMemoryAllocateInfo allocate_info {};
+
+        allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocate_info.allocationSize = size;
+        allocate_info.memoryTypeIndex = memory_type_index;
+
+        VkDeviceMemory device_memory;
+
+        if (vkAllocateMemory(device_, &allocate_info, nullptr, &device_memory) != VK_SUCCESS)
+            return -1.0;
+
+        // CPU에서 메모리에 접근하기 위한 버추얼 어드레스를 가져옵니다.
+        void* contents;
+
+        if (vkMapMemory(device_, device_memory, 0, VK_WHOLE_SIZE, 0, &contents) != VK_SUCCESS) {
+            vkFreeMemory(device_, device_memory, nullptr);
+            return -1.0;
+        }
+
+        auto data = static_cast<uint64_t*>(contents);
+        auto count = size / sizeof(uint64_t);
+        auto line_count = size / cache_line_size;
+        constexpr auto line_word_count = cache_line_size / sizeof(uint64_t);
+
+        // 랜덤 접근은 섞인 순서로 캐시 라인에 접근합니다. 시드를 고정해서 매번 같은 순서로 접근합니다.
+        vector<uint32_t> lines(line_count);
+
+        iota(begin(lines), end(lines), 0);
+        shuffle(begin(lines), end(lines), mt19937 {0});
+
+        // 복사의 원본은 호스트 메모리입니다.
+        vector<uint8_t> src;
+
+        if (access == Host_access::memcpy || access == Host_access::stream_copy)
+            src.resize(size);
+
+        // HOST_COHERENT가 아닌 메모리는 쓰기 후에 플러시하고 읽기 전에 무효화해야 하므로 측정에 포함합니다.
+        auto coherent = physical_device_memory_properties_.memoryTypes[memory_type_index].propertyFlags &
+                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+        VkMappedMemoryRange range {};
+
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = device_memory;
+        range.size = VK_WHOLE_SIZE;
+
+        uint64_t sum {0};
+        VkDeviceSize bytes {0};
+        chrono::duration<double> elapsed;
+        auto begin_time = chrono::steady_clock::now();
+
+        do {
+            switch (access) {
+                case Host_access::sequential_write:
+                    for (auto i = 0u; i != count; ++i)
+                        data[i] = i;
+                    break;
+                case Host_access::sequential_read:
+                    for (auto i = 0u; i != count; ++i)
+                        sum += data[i];
+                    break;
+                case Host_access::random_write:
+                    for (auto line : lines) {
+                        for (auto i = 0u; i != line_word_count; ++i)
+                            data[line * line_word_count + i] = line;
+                    }
+                    break;
+                case Host_access::random_read:
+                    for (auto line : lines) {
+                        for (auto i = 0u; i != line_word_count; ++i)
+                            sum += data[line * line_word_count + i];
+                    }
+                    break;
+                case Host_access::memcpy:
+                    ::memcpy(data, src.data(), size);
+                    break;
+                case Host_access::stream_copy:
+                    // 임계값과 관계없이 모든 크기에서 커널을 측정합니다.
+                    Platform::stream_copy(data, src.data(), size, stream_copy_kernel());
+                    break;
+            }
+
+            if (!coherent) {
+                if (access == Host_access::sequential_read || access == Host_access::random_read)
+                    vkInvalidateMappedMemoryRanges(device_, 1, &range);
+                else
+                    vkFlushMappedMemoryRanges(device_, 1, &range);
+            }
+
+            bytes += size;
+            elapsed = chrono::steady_clock::now() - begin_time;
+        } while (elapsed.count() < min_host_seconds);
+
+        // 읽은 값을 사용하지 않으면 컴파일러가 읽기를 제거할 수 있습니다.
+        sink_ += sum;
+
+        vkUnmapMemory(device_, device_memory);
+        vkFreeMemory(device_, device_memory, nullptr);
+
+        return bytes / elapsed.count() / 1e6;
+    }
+
+    double measure_buffer_copy_(uint32_t memory_type_index, VkDeviceSize size)
+    {
+        // 원본 버퍼는 측정하려는 메모리 타입에 할당하고 대상 버퍼는 디바이스 메모리에 할당합니다.
+        VkBuffer src_buffer, dst_buffer;
+        VkDeviceMemory src_device_memory, dst_device_memory;
+
+        if (!create_buffer_(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 1u << memory_type_index,
+                            &src_buffer, &src_device_memory))
+            return -1.0;
+
+        if (!create_buffer_(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, ~0u, &dst_buffer, &dst_device_memory)) {
+            destroy_buffer_(src_buffer, src_device_memory);
+            return -1.0;
+        }
+
+        VkBufferCopy region {};
+
+        region.size = size;
+
+        auto copy_count = max<VkDeviceSize>(min_copy_bytes / size, 1);
+        auto seconds = measure_copies_(copy_count, [](VkCommandBuffer) {}, [&](VkCommandBuffer command_buffer) {
+            vkCmdCopyBuffer(command_buffer, src_buffer, dst_buffer, 1, &region);
+        });
+
+        destroy_buffer_(dst_buffer, dst_device_memory);
+        destroy_buffer_(src_buffer, src_device_memory);
+
+        return seconds > 0.0 ? size * copy_count / seconds / 1e6 : -1.0;
+    }
+
+    double measure_image_copy_(uint32_t memory_type_index, VkDeviceSize size)
+    {
+        // 원본 버퍼는 측정하려는 메모리 타입에 할당합니다.
+        VkBuffer src_buffer;
+        VkDeviceMemory src_device_memory;
+
+        if (!create_buffer_(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 1u << memory_type_index,
+                            &src_buffer, &src_device_memory))
+            return -1.0;
+
+        // 대상 이미지는 전송 크기와 같은 크기의 정사각형 RGBA8 이미지입니다.
+        auto extent = static_cast<uint32_t>(sqrt(size / 4));
+
+        VkImage dst_image;
+        VkDeviceMemory dst_device_memory;
+
+        if (!create_image_(extent, &dst_image, &dst_device_memory)) {
+            destroy_buffer_(src_buffer, src_device_memory);
+            return -1.0;
+        }
+
+        VkBufferImageCopy region {};
+
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {extent, extent, 1};
+
+        // 이미지에 복사하기 위해서는 TRANSFER_DST_OPTIMAL이어야 합니다. 레이아웃 전이는 측정에 포함하지 않습니다.
+        auto prologue = [&](VkCommandBuffer command_buffer) {
+            VkImageMemoryBarrier barrier {};
+
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = dst_image;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.layerCount = 1;
+
+            vkCmdPipelineBarrier(command_buffer,
+                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0,
+                                 0, nullptr,
+                                 0, nullptr,
+                                 1, &barrier);
+        };
+
+        auto copy_count = max<VkDeviceSize>(min_copy_bytes / size, 1);
+        auto seconds = measure_copies_(copy_count, prologue, [&](VkCommandBuffer command_buffer) {
+            vkCmdCopyBufferToImage(command_buffer, src_buffer, dst_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   1, &region);
+        });
+
+        vkDestroyImage(device_, dst_image, nullptr);
+        vkFreeMemory(device_, dst_device_memory, nullptr);
+        destroy_buffer_(src_buffer, src_device_memory);
+
+        return seconds > 0.0 ? size * copy_count / seconds / 1e6 : -1.0;
+    }
+
+    double measure_copies_(VkDeviceSize copy_count,
+                           const function<void(VkCommandBuffer)>& prologue,
+                           const function<void(VkCommandBuffer)>& copy)
+    {
+        double seconds {-1.0};
+
+        // 첫 번째 실행은 페이지 폴트와 캐시의 영향을 받기 때문에 두 번째 실행을 측정합니다.
+        for (auto i = 0; i != 2; ++i) {
+            vkResetCommandBuffer(command_buffer_, 0);
+
+            VkCommandBufferBeginInfo begin_info {};
+
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            vkBeginCommandBuffer(command_buffer_, &begin_info);
+
+            prologue(command_buffer_);
+
+            if (query_pool_) {
+                vkCmdResetQueryPool(command_buffer_, query_pool_, 0, 2);
+                vkCmdWriteTimestamp(command_buffer_, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool_, 0);
+            }
+
+            for (auto j = 0u; j != copy_count; ++j) {
+                copy(command_buffer_);
+
+                // 같은 대상에 복사하기 때문에 복사들이 겹치지 않아야 합니다.
+                VkMemoryBarrier barrier {};
+
+                barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+                vkCmdPipelineBarrier(command_buffer_,
+                                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                     0,
+                                     1, &barrier,
+                                     0, nullptr,
+                                     0, nullptr);
+            }
+
+            if (query_pool_)
+                vkCmdWriteTimestamp(command_buffer_, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool_, 1);
+
+            vkEndCommandBuffer(command_buffer_);
+
+            VkSubmitInfo submit_info {};
+
+            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit_info.commandBufferCount = 1;
+            submit_info.pCommandBuffers = &command_buffer_;
+
+            auto begin_time = chrono::steady_clock::now();
+
+            if (vkQueueSubmit(queue_, 1, &submit_info, fence_) != VK_SUCCESS)
+                return -1.0;
+
+            vkWaitForFences(device_, 1, &fence_, VK_TRUE, UINT64_MAX);
+
+            auto end_time = chrono::steady_clock::now();
+
+            vkResetFences(device_, 1, &fence_);
+
+            // 타임스탬프를 지원하지 않으면 제출부터 펜스까지의 시간을 사용합니다.
+            if (!query_pool_) {
+                seconds = chrono::duration<double>(end_time - begin_time).count();
+                continue;
+            }
+
+            array<uint64_t, 2> timestamps;
+
+            vkGetQueryPoolResults(device_, query_pool_, 0, 2, sizeof(timestamps), &timestamps[0],
+                                  sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+
+            auto mask = timestamp_valid_bits_ == 64 ? ~0ull : (1ull << timestamp_valid_bits_) - 1;
+            auto ticks = ((timestamps[1] & mask) - (timestamps[0] & mask)) & mask;
+
+            seconds = ticks * static_cast<double>(physical_device_properties_.limits.timestampPeriod) / 1e9;
+        }
+
+        return seconds;
+    }
+
+    bool create_buffer_(VkDeviceSize size, VkBufferUsageFlags usage, uint32_t memory_type_bits,
+                        VkBuffer* buffer, VkDeviceMemory* device_memory)
+    {
+        // 생성하려는 버퍼를 정의합니다.
+        VkBufferCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        create_info.size = size;
+        create_info.usage = usage;
+
+        if (vkCreateBuffer(device_, &create_info, nullptr, buffer) != VK_SUCCESS)
+            return false;
+
+        // 버퍼가 사용할 수 없는 메모리 타입은 측정하지 않습니다.
+        VkMemoryRequirements requirements;
+
+        vkGetBufferMemoryRequirements(device_, *buffer, &requirements);
+
+        if (!allocate_memory_(requirements, memory_type_bits, device_memory)) {
+            vkDestroyBuffer(device_, *buffer, nullptr);
+            return false;
+        }
+
+        vkBindBufferMemory(device_, *buffer, *device_memory, 0);
+
+        return true;
+    }
+
+    bool create_image_(uint32_t extent, VkImage* image, VkDeviceMemory* device_memory)
+    {
+        // 생성하려는 이미지를 정의합니다.
+        VkImageCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        create_info.imageType = VK_IMAGE_TYPE_2D;
+        create_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+        create_info.extent = {extent, extent, 1};
+        create_info.mipLevels = 1;
+        create_info.arrayLayers = 1;
+        create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        create_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (vkCreateImage(device_, &create_info, nullptr, image) != VK_SUCCESS)
+            return false;
+
+        VkMemoryRequirements requirements;
+
+        vkGetImageMemoryRequirements(device_, *image, &requirements);
+
+        if (!allocate_memory_(requirements, ~0u, device_memory)) {
+            vkDestroyImage(device_, *image, nullptr);
+            return false;
+        }
+
+        vkBindImageMemory(device_, *image, *device_memory, 0);
+
+        return true;
+    }
+
+    bool allocate_memory_(const VkMemoryRequirements& requirements, uint32_t memory_type_bits,
+                          VkDeviceMemory* device_memory)
+    {
+        // 허용된 메모리 타입들 중에서 디바이스 메모리를 우선해서 선택합니다.
+        auto bits = requirements.memoryTypeBits & memory_type_bits;
+        auto memory_type_index = UINT32_MAX;
+
+        for (auto i = 0u; i != physical_device_memory_properties_.memoryTypeCount; ++i) {
+            if (!(bits & (1u << i)))
+                continue;
+
+            if (memory_type_index == UINT32_MAX)
+                memory_type_index = i;
+
+            if (physical_device_memory_properties_.memoryTypes[i].propertyFlags &
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+                memory_type_index = i;
+                break;
+            }
+        }
+
+        if (memory_type_index == UINT32_MAX)
+            return false;
+
+        VkMemoryAllocateInfo allocate_info {};
+
+        allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocate_info.allocationSize = requirements.size;
+        allocate_info.memoryTypeIndex = memory_type_index;
+
+        return vkAllocateMemory(device_, &allocate_info, nullptr, device_memory) == VK_SUCCESS;
+    }
+
+    void destroy_buffer_(VkBuffer buffer, VkDeviceMemory device_memory)
+    {
+        vkDestroyBuffer(device_, buffer, nullptr);
+        vkFreeMemory(device_, device_memory, nullptr);
+    }
+
+    static Value to_value_(double bandwidth)
+    {
+        // 측정할 수 없는 경우는 null로 기록합니다.
+        return bandwidth < 0.0 ? Value {} : Value {bandwidth};
+    }
+
 private:
     VkInstance instance_;
     VkPhysicalDevice  physical_device_;
+    VkPhysicalDeviceProperties physical_device_properties_;
+    VkPhysicalDeviceMemoryProperties physical_device_memory_properties_;
     uint32_t queue_family_index_;
+    uint32_t timestamp_valid_bits_;
     VkDevice device_;
     VmaAllocator allocator_;
+    VkQueue queue_;
+    VkCommandPool command_pool_;
+    VkCommandBuffer command_buffer_;
+    VkFence fence_;
+    VkQueryPool query_pool_;
+    uint64_t sink_;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
 
 int main(int argc, char* argv[])
 {
-    Chapter9 chapter9;
+    auto benchmark {false};
+    string device_name;
+    string output_path;
+
+    for (auto i = 1; i != argc; ++i) {
+        string arg {argv[i]};
 
-    chapter9.print_memory_properties();
+        if (arg == "--benchmark") {
+            benchmark = true;
+        }
+        else if (starts_with(arg, "--device=")) {
+            device_name = arg.substr(9);
+        }
+        else if (starts_with(arg, "--output=")) {
+            output_path = arg.substr(9);
+        }
+        else {
+            cerr << "usage : chapter09 [--benchmark] [--device=<name>] [--output=<path>]" << endl;
+            return 1;
+        }
+    }
+
+    Chapter9 chapter9 {device_name, !benchmark};
+
+    if (!benchmark) {
+        chapter9.print_memory_properties();
+        chapter9.print_memory_statistics();
+
+        return 0;
+    }
+
+    // 메모리 타입별로 호스트의 접근과 큐의 복사 속도를 측정해서 JSON으로 출력합니다.
+    if (output_path.empty()) {
+        chapter9.run_bandwidth_benchmark(cout);
+    }
+    else {
+        ofstream fout {output_path};
+
+        chapter9.run_bandwidth_benchmark(fout);
+    }
 
     return 0;
 }
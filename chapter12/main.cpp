@@ -13,13 +13,16 @@
 #include <iostream>
 #include <vector>
 #include <array>
-#include <vulkan/vulkan.h>
+#include <memory>
+#include <vlk/Vulkan.h>
 #include <platform/Window.h>
 #include <sc/Spirv_compiler.h>
+#include <vlk/Memory_allocator.h>
 
 using namespace std;
 using namespace Platform;
 using namespace Sc;
+using namespace Vlk;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -48,10 +51,13 @@ public:
     Chapter12(Window* window) :
         window_ {window},
         instance_ {VK_NULL_HANDLE},
+        instance_table_ {},
         physical_device_ {VK_NULL_HANDLE},
         physical_device_memory_properties_ {},
         queue_family_index_ {UINT32_MAX},
         device_ {VK_NULL_HANDLE},
+        device_table_ {},
+        memory_allocator_ {},
         queue_ {VK_NULL_HANDLE},
         command_pool_ {VK_NULL_HANDLE},
         command_buffer_ {VK_NULL_HANDLE},
@@ -75,12 +81,16 @@ public:
         descriptor_pool_ {VK_NULL_HANDLE},
         material_descriptor_set_ {VK_NULL_HANDLE}
     {
+        // 벌칸 로더를 열고 인스턴스를 생성하기 위한 함수들을 가져옵니다.
+        load_global_functions();
+
         init_signals_();
         init_instance_();
         find_best_physical_device_();
         init_physical_device_memory_properties_();
         find_queue_family_index_();
         init_device_();
+        init_memory_allocator_();
         init_queue_();
         init_command_pool_();
         init_command_buffer_();
@@ -99,6 +109,7 @@ public:
         fini_fence_();
         fini_semaphores_();
         fini_command_pool_();
+        fini_memory_allocator_();
         fini_device_();
         fini_instance_();
     }
@@ -126,6 +137,8 @@ private:
             "VK_KHR_surface",
 #if defined(_WIN64)
             "VK_KHR_win32_surface"
+#elif defined(__linux__)
+            "VK_EXT_headless_surface"
 #else
             "VK_MVK_macos_surface"
 #endif
@@ -162,6 +175,9 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
+
+        // 인스턴스로부터 인스턴스 함수들을 인스턴스의 테이블로 가져옵니다.
+        instance_table_ = load_instance_table(instance_);
     }
 
     void find_best_physical_device_()
@@ -170,7 +186,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 물리 디바이스의 수를 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, nullptr);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, nullptr);
 
         // 사용가능한 물리 디바이스들의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkPhysicalDevice> physical_devices;
@@ -179,7 +195,7 @@ private:
         physical_devices.resize(count);
 
         // 사용가능한 물리 디바이스들의 핸들을 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
 
         // 어플리케이션에선 사용가능한 물리 디바이스들 중에서 어플리케이션에
         // 적합한 물리 디바이스를 찾아야 합니다.
@@ -190,7 +206,7 @@ private:
     void init_physical_device_memory_properties_()
     {
         // 물리 디바이스 메모리 성질을 얻어옵니다.
-        vkGetPhysicalDeviceMemoryProperties(physical_device_, &physical_device_memory_properties_);
+        instance_table_.vkGetPhysicalDeviceMemoryProperties(physical_device_, &physical_device_memory_properties_);
     }
 
     void find_queue_family_index_()
@@ -199,7 +215,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 큐 패밀리의 수를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
 
         // 사용가능한 큐 패밀리의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkQueueFamilyProperties> properties;
@@ -208,7 +224,7 @@ private:
         properties.resize(count);
 
         // 사용가능한 큐 패밀리의 정보를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
 
         for (auto i = 0; i != properties.size(); ++i) {
             // 큐 패밀리에서 사용가능한 큐가 있는지 확인합니다.
@@ -259,7 +275,7 @@ private:
         create_info.ppEnabledExtensionNames = &extension_names[0];
 
         // 디바이스를 생성합니다.
-        auto result = vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
+        auto result = instance_table_.vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -286,12 +302,15 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
+
+        // 로더를 거치지 않고 호출하기 위해 디바이스로부터 디바이스 함수들을 디바이스의 테이블로 가져옵니다.
+        device_table_ = load_device_table(instance_table_, device_);
     }
 
     void init_queue_()
     {
         // 디바이스로 부터 생성된 큐의 핸들을 얻어옵니다.
-        vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+        device_table_.vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
     }
 
     void init_command_pool_()
@@ -304,7 +323,7 @@ private:
         create_info.queueFamilyIndex = queue_family_index_;
 
         // 커맨드 풀을 생성합니다.
-        auto result = vkCreateCommandPool(device_, &create_info, nullptr, &command_pool_);
+        auto result = device_table_.vkCreateCommandPool(device_, &create_info, nullptr, &command_pool_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -329,7 +348,7 @@ private:
         allocate_info.commandBufferCount = 1;
 
         // 커맨드 버퍼를 생성합니다.
-        auto result = vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer_);
+        auto result = device_table_.vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -356,7 +375,7 @@ private:
         // - 첫 번째 세마포어는 스왑체인 이미지가 준비된 후에 제출한 커맨드 버퍼가 처리되기 위해 사용됩니다.
         // - 두 번째 세마포어는 제출한 커맨드 버퍼가 처리된 후에 화면에 출력을 하기 위해 사용됩니다.
         for (auto& semaphore : semaphores_) {
-            auto result = vkCreateSemaphore(device_, &create_info, nullptr, &semaphore);
+            auto result = device_table_.vkCreateSemaphore(device_, &create_info, nullptr, &semaphore);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -383,7 +402,7 @@ private:
         create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
         // 펜스를 생성합니다.
-        auto result = vkCreateFence(device_, &create_info, nullptr, &fence_);
+        auto result = device_table_.vkCreateFence(device_, &create_info, nullptr, &fence_);
 
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
@@ -398,23 +417,20 @@ private:
         assert(result == VK_SUCCESS);
     }
 
-    uint32_t find_memory_type_index(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties)
+    void init_memory_allocator_()
     {
-        // 메모리 요구사항과 필요한 메모리 성질을 모두 만족하는 메모리 타입 인덱스를 찾습니다.
-        for (auto i = 0; i != physical_device_memory_properties_.memoryTypeCount; ++i) {
-            // 메모리가 i번째 메모리 타입에 할당 가능한지 검사합니다.
-            if (!(requirements.memoryTypeBits & (1 << i)))
-                continue;
-
-            // 개발자가 요구한 메모리 성질을 만족하는지 검사합니다.
-            if ((physical_device_memory_properties_.memoryTypes[i].propertyFlags & properties) != properties)
-                continue;
-
-            return i;
-        }
-
-        assert(false);
-        return UINT32_MAX;
+        // 리소스마다 메모리를 할당하면 할당 횟수가 maxMemoryAllocationCount를 쉽게 넘을 수 있습니다.
+        // 그러므로 큰 메모리 블록을 할당하고 리소스들은 블록의 일부를 나눠서 사용합니다.
+        Memory_allocator_desc desc;
+
+        desc.instance = instance_;
+        desc.physical_device = physical_device_;
+        desc.device = device_;
+        desc.instance_table = &instance_table_;
+        desc.device_table = &device_table_;
+
+        // 메모리 할당자를 생성합니다. 디바이스 함수들을 가져온 후에 생성해야 합니다.
+        memory_allocator_ = make_unique<Memory_allocator>(desc);
     }
 
     void init_vertex_resources_()
@@ -435,36 +451,9 @@ private:
         // 버퍼의 사용처를 VERTEX_BUFFER_BIT을 설정하지 않으면 버텍스 버퍼로 사용할 수 없습니다.
         create_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
 
-        // 버퍼를 생성합니다.
-        auto result = vkCreateBuffer(device_, &create_info, nullptr, &vertex_buffer_);
-        switch (result) {
-            case VK_ERROR_OUT_OF_HOST_MEMORY:
-                cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                break;
-            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                break;
-            default:
-                break;
-        }
-        assert(result == VK_SUCCESS);
-
-        // 메모리 요구사항을 얻어올 변수를 선언합니다.
-        VkMemoryRequirements requirements;
-
-        // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-        vkGetBufferMemoryRequirements(device_, vertex_buffer_, &requirements);
-
-        // 할당하려는 메모리를 정의합니다.
-        VkMemoryAllocateInfo alloc_info {};
-
-        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        alloc_info.allocationSize = requirements.size;
-        // CPU에서 접근 가능하고 CPU와 GPU의 메모리 동기화가 보장되는 메모리 타입을 선택합니다.
-        alloc_info.memoryTypeIndex = find_memory_type_index(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-        // 메모리를 할당합니다.
-        result = vkAllocateMemory(device_, &alloc_info, nullptr, &vertex_device_memory_);
+        // 버퍼를 생성하고 메모리 할당자가 CPU에서 쓰고 GPU에서 읽는 메모리 블록의 일부를 할당해서 바인드합니다.
+        auto result = memory_allocator_->create_buffer(create_info, {VMA_MEMORY_USAGE_CPU_TO_GPU},
+                                                       &vertex_buffer_, &vertex_device_memory_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -480,23 +469,9 @@ private:
         }
         assert(result == VK_SUCCESS);
 
-        // 버퍼와 메모리를 바인드합니다.
-        result = vkBindBufferMemory(device_, vertex_buffer_, vertex_device_memory_, 0);
-        switch (result) {
-            case VK_ERROR_OUT_OF_HOST_MEMORY:
-                cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                break;
-            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                break;
-            default:
-                break;
-        }
-        assert(result == VK_SUCCESS);
-
         // CPU에서 메모리에 접근하기 위한 버추얼 어드레스를 가져옵니다.
         void* contents;
-        result = vkMapMemory(device_, vertex_device_memory_, 0, sizeof(Vertex) * vertices.size(), 0, &contents);
+        result = memory_allocator_->map(vertex_device_memory_, &contents);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -516,7 +491,7 @@ private:
         memcpy(contents, &vertices[0], sizeof(Vertex) * vertices.size());
 
         // CPU에서 메모리의 접근을 끝마칩니다.
-        vkUnmapMemory(device_, vertex_device_memory_);
+        memory_allocator_->unmap(vertex_device_memory_);
 
         // CPU에서 메모리를 자주 접근하는 경우에 언맵을 하지 않고
         // 맵을 통해 얻어온 버츄얼 어드레스를 계속 사용해도 됩니다.
@@ -538,36 +513,9 @@ private:
             create_info.size = sizeof(uint16_t) * indices.size();
             create_info.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
-            // 정의한 인덱스 버퍼를 생성한다.
-            auto result = vkCreateBuffer(device_, &create_info, nullptr, &index_buffer_);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 메모리 요구사항을 얻어올 변수를 선언합니다.
-            VkMemoryRequirements requirements;
-
-            // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-            vkGetBufferMemoryRequirements(device_, index_buffer_, &requirements);
-
-            // 할당하려는 메모리를 정의합니다.
-            VkMemoryAllocateInfo alloc_info {};
-
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = requirements.size;
-            // GPU의 접근이 빠르나 CPU는 접근할 수 없습니다.
-            alloc_info.memoryTypeIndex = find_memory_type_index(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-            // 메모리를 할당합니다.
-            result = vkAllocateMemory(device_, &alloc_info, nullptr, &index_device_memory_);
+            // 버퍼를 생성하고 메모리 할당자가 GPU에서 빠르게 접근할 수 있는 메모리 블록의 일부를 할당해서 바인드합니다.
+            auto result = memory_allocator_->create_buffer(create_info, {VMA_MEMORY_USAGE_GPU_ONLY},
+                                                           &index_buffer_, &index_device_memory_);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -582,28 +530,10 @@ private:
                     break;
             }
             assert(result == VK_SUCCESS);
-
-            // 이 메모리를 CPU가 접근할 수 없기 때문에 메모리의 버추얼 어드레스를 얻어올 수 없습니다.
-            // void* contents;
-            // vkMapMemory(device_, index_device_memory_, 0, VK_WHOLE_SIZE, 0, &contents);
-
-            // 버퍼와 메모리를 바인드합니다.
-            result = vkBindBufferMemory(device_, index_buffer_, index_device_memory_, 0);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
         }
 
         VkBuffer staging_buffer;
-        VkDeviceMemory staging_device_memory;
+        VmaAllocation staging_device_memory;
 
         {
             // 생성하려는 스테이징 버퍼를 정의합니다.
@@ -613,36 +543,9 @@ private:
             create_info.size = sizeof(uint16_t) * indices.size();
             create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
-            // 버퍼를 생성합니다.
-            auto result = vkCreateBuffer(device_, &create_info, nullptr, &staging_buffer);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 메모리 요구사항을 얻어올 변수를 선언합니다.
-            VkMemoryRequirements requirements;
-
-            // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-            vkGetBufferMemoryRequirements(device_, staging_buffer, &requirements);
-
-            // 할당하려는 메모리를 정의합니다.
-            VkMemoryAllocateInfo alloc_info {};
-
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = requirements.size;
-            // CPU에서 접근 가능하고 CPU와 GPU의 메모리 동기화가 보장되는 메모리 타입을 선택합니다.
-            alloc_info.memoryTypeIndex = find_memory_type_index(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-            // 메모리를 할당합니다.
-            result = vkAllocateMemory(device_, &alloc_info, nullptr, &staging_device_memory);
+            // 버퍼를 생성하고 메모리 할당자가 CPU에서 접근 가능한 메모리 블록의 일부를 할당해서 바인드합니다.
+            auto result = memory_allocator_->create_buffer(create_info, {VMA_MEMORY_USAGE_CPU_ONLY},
+                                                           &staging_buffer, &staging_device_memory);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -658,23 +561,9 @@ private:
             }
             assert(result == VK_SUCCESS);
 
-            // 버퍼와 메모리를 바인드합니다.
-            result = vkBindBufferMemory(device_, staging_buffer, staging_device_memory, 0);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
             // CPU에서 메모리에 접근하기 위한 버추얼 어드레스를 가져옵니다.
             void* contents;
-            result = vkMapMemory(device_, staging_device_memory, 0, sizeof(uint16_t) * indices.size(), 0, &contents);
+            result = memory_allocator_->map(staging_device_memory, &contents);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -694,7 +583,7 @@ private:
             memcpy(contents, &indices[0], sizeof(uint16_t) * indices.size());
 
             // CPU에서 메모리의 접근을 끝마칩니다.
-            vkUnmapMemory(device_, staging_device_memory);
+            memory_allocator_->unmap(staging_device_memory);
         }
 
         // 생성할 커맨드 버퍼를 정의합니다.
@@ -707,7 +596,7 @@ private:
 
         // 커맨드 버퍼를 생성합니다.
         VkCommandBuffer command_buffer;
-        vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer);
+        device_table_.vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer);
 
         // 커맨드를 기록하기 위해 커맨드 버퍼의 사용목적을 정의한다.
         VkCommandBufferBeginInfo begin_info {};
@@ -716,7 +605,7 @@ private:
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         // 커맨드 버퍼에 커맨드 기록을 시작한다.
-        vkBeginCommandBuffer(command_buffer, &begin_info);
+        device_table_.vkBeginCommandBuffer(command_buffer, &begin_info);
 
         // 복사할 영역을 정의합니다.
         VkBufferCopy region {};
@@ -724,10 +613,10 @@ private:
         region.size = sizeof(uint16_t) * indices.size();
 
         // 스테이징 버퍼를 인덱스 버퍼로 정의한 영역만큼 복사합니다.
-        vkCmdCopyBuffer(command_buffer, staging_buffer, index_buffer_, 1, &region);
+        device_table_.vkCmdCopyBuffer(command_buffer, staging_buffer, index_buffer_, 1, &region);
 
         // 커맨드 버퍼에 커맨드 기록을 끝마친다.
-        vkEndCommandBuffer(command_buffer);
+        device_table_.vkEndCommandBuffer(command_buffer);
 
         // 어떤 기록된 커맨드를 큐에 제출할지 정의한다.
         VkSubmitInfo submit_info {};
@@ -737,16 +626,13 @@ private:
         submit_info.pCommandBuffers = &command_buffer;
 
         // 기록된 커맨드를 큐에 제출한다.
-        vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
+        device_table_.vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
 
         // 커맨드 버퍼들이 모두 처리될 때까지 기다린다.
-        vkDeviceWaitIdle(device_);
+        device_table_.vkDeviceWaitIdle(device_);
 
-        // 할당된 메모리를 해제합니다.
-        vkFreeMemory(device_, staging_device_memory, nullptr);
-
-        // 생성된 버퍼를 파괴합니다.
-        vkDestroyBuffer(device_, staging_buffer, nullptr);
+        // 생성된 버퍼를 파괴하고 할당된 메모리를 해제합니다.
+        memory_allocator_->destroy_buffer(staging_buffer, staging_device_memory);
     }
 
     void init_uniform_resources_()
@@ -759,37 +645,9 @@ private:
         // 버퍼의 사용처를 UNIFORM_BUFFER_BIT을 설정하지 않으면 유니폼 버퍼로 사용할 수 없습니다.
         create_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 
-        // 버퍼를 생성합니다.
-        auto result = vkCreateBuffer(device_, &create_info, nullptr, &uniform_buffer_);
-        switch (result) {
-            case VK_ERROR_OUT_OF_HOST_MEMORY:
-                cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                break;
-            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                break;
-            default:
-                break;
-        }
-        assert(result == VK_SUCCESS);
-
-        // 메모리 요구사항을 얻어올 변수를 선언합니다.
-        VkMemoryRequirements requirements;
-
-        // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-        vkGetBufferMemoryRequirements(device_, vertex_buffer_, &requirements);
-
-        // 할당하려는 메모리를 정의합니다.
-        VkMemoryAllocateInfo alloc_info {};
-
-        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        alloc_info.allocationSize = requirements.size;
-        // CPU에서 접근 가능하고 CPU와 GPU의 메모리 동기화가 보장되는 메모리 타입을 선택합니다.
-        alloc_info.memoryTypeIndex = find_memory_type_index(requirements,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-        // 메모리를 할당합니다.
-        result = vkAllocateMemory(device_, &alloc_info, nullptr, &uniform_device_memory_);
+        // 버퍼를 생성하고 메모리 할당자가 CPU에서 쓰고 GPU에서 읽는 메모리 블록의 일부를 할당해서 바인드합니다.
+        auto result = memory_allocator_->create_buffer(create_info, {VMA_MEMORY_USAGE_CPU_TO_GPU},
+                                                       &uniform_buffer_, &uniform_device_memory_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -804,20 +662,6 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
-
-        // 버퍼와 메모리를 바인드합니다.
-        result = vkBindBufferMemory(device_, uniform_buffer_, uniform_device_memory_, 0);
-        switch (result) {
-            case VK_ERROR_OUT_OF_HOST_MEMORY:
-                cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                break;
-            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                break;
-            default:
-                break;
-        }
-        assert(result == VK_SUCCESS);
     }
 
     void init_surface_()
@@ -840,7 +684,7 @@ private:
         create_info.pView = (__bridge void*)content_view;
 
         // 서피스를 생성합니다.
-        auto result = vkCreateMacOSSurfaceMVK(instance_, &create_info, nullptr, &surface_);
+        auto result = instance_table_.vkCreateMacOSSurfaceMVK(instance_, &create_info, nullptr, &surface_);
 #elif defined(_WIN64)
         // 생성하려는 서피스를 정의합니다.
         VkWin32SurfaceCreateInfoKHR create_info {};
@@ -850,7 +694,16 @@ private:
         create_info.hwnd = static_cast<HWND>(window_->window());
 
         // 서피스를 생성합니다.
-        auto result = vkCreateWin32SurfaceKHR(instance_, &create_info, nullptr, &surface_);
+        auto result = instance_table_.vkCreateWin32SurfaceKHR(instance_, &create_info, nullptr, &surface_);
+#elif defined(__linux__)
+        // 헤드리스 서피스는 디스플레이 없이 스왑체인을 생성할 수 있게 합니다.
+        // 그러므로 디스플레이가 없는 리눅스에서도 렌더링 경로를 그대로 실행할 수 있습니다.
+        VkHeadlessSurfaceCreateInfoEXT create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+        // 서피스를 생성합니다.
+        auto result = instance_table_.vkCreateHeadlessSurfaceEXT(instance_, &create_info, nullptr, &surface_);
 #endif
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
@@ -871,7 +724,8 @@ private:
         VkBool32 supported;
 
         // 물리 디바이스의 큐 패밀리가 서피스를 지원하는지 확인합니다.
-        vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, queue_family_index_, surface_, &supported);
+        instance_table_.vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, queue_family_index_, surface_,
+                                                             &supported);
         assert(supported == VK_TRUE);
     }
 
@@ -881,7 +735,7 @@ private:
         uint32_t count;
 
         // 사용 가능한 서피스 포맷의 수를 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, nullptr);
+        instance_table_.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, nullptr);
 
         // 사용가능한 서피스 포맷들을 얻기 위한 변수를 선언합니다.
         vector<VkSurfaceFormatKHR> formats;
@@ -890,7 +744,7 @@ private:
         formats.resize(count);
 
         // 사용가능한 서피스 포맷들을 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, &formats[0]);
+        instance_table_.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, &formats[0]);
 
         // 어플리케이션은 여러 조건을 고려해서 최적의 서피스 포맷을 선택해야합니다.
         // 예제의 간소화를 위해서 첫 번째 서피스 포맷을 사용합니다.
@@ -905,7 +759,14 @@ private:
         VkSurfaceCapabilitiesKHR surface_capabilities;
 
         // 서피스의 능력을 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities);
+        instance_table_.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities);
+
+        // 헤드리스 서피스처럼 서피스가 크기를 정하지 않는다면 윈도우의 크기를 사용합니다.
+        if (surface_capabilities.currentExtent.width == UINT32_MAX) {
+            auto extent = window_->extent();
+
+            surface_capabilities.currentExtent = {extent.w, extent.h};
+        }
 
         // 사용할 수 있는 컴포짓 알파 모드를 검색한다.
         VkCompositeAlphaFlagBitsKHR composite_alpha {static_cast<VkCompositeAlphaFlagBitsKHR>(0)};
@@ -942,7 +803,7 @@ private:
         create_info.presentMode = VK_PRESENT_MODE_FIFO_KHR;
 
         // 스왑체인을 생성합니다.
-        auto result = vkCreateSwapchainKHR(device_, &create_info, nullptr, &swapchain_);
+        auto result = device_table_.vkCreateSwapchainKHR(device_, &create_info, nullptr, &swapchain_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -974,13 +835,13 @@ private:
         uint32_t count;
 
         // 사용 가능한 스왑체인 이미지의 개수를 얻어옵니다.
-        vkGetSwapchainImagesKHR(device_, swapchain_, &count, nullptr);
+        device_table_.vkGetSwapchainImagesKHR(device_, swapchain_, &count, nullptr);
 
         // 사용 가능한 스왑체인 이미지를 얻기 위한 메모리를 할당합니다.
         swapchain_images_.resize(count);
 
         // 사용 가능한 스왑체인 이미지를 얻어옵니다.
-        vkGetSwapchainImagesKHR(device_, swapchain_, &count, &swapchain_images_[0]);
+        device_table_.vkGetSwapchainImagesKHR(device_, swapchain_, &count, &swapchain_images_[0]);
 
         // 스왑체인 생성시 정의한 이미지의 개수는 최소 이미지의 개수이기 때문에
         // 실제로 더 많은 이미지가 생성될 수 있습니다.
@@ -992,7 +853,7 @@ private:
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         // 커맨드 버퍼에 커맨드 기록을 시작한다.
-        vkBeginCommandBuffer(command_buffer_, &begin_info);
+        device_table_.vkBeginCommandBuffer(command_buffer_, &begin_info);
 
         // 스왑체인 이미지의 레이아웃을 PRESENT_SRC로 변경하는 배리어를 정의한다.
         // PRESENT_SRC로 변경하는 이유는 렌더링을 위한 커맨드를 단순화하기 위해서이다.
@@ -1014,15 +875,15 @@ private:
         }
 
         // 정의된 배리어를 실행하는 커맨드를 커맨드 버퍼에 기록한다.
-        vkCmdPipelineBarrier(command_buffer_,
-                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                             0,
-                             0, nullptr,
-                             0, nullptr,
-                             barriers.size(), &barriers[0]);
+        device_table_.vkCmdPipelineBarrier(command_buffer_,
+                                           VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                           0,
+                                           0, nullptr,
+                                           0, nullptr,
+                                           barriers.size(), &barriers[0]);
 
         // 커맨드 버퍼에 커맨드 기록을 끝마친다.
-        vkEndCommandBuffer(command_buffer_);
+        device_table_.vkEndCommandBuffer(command_buffer_);
 
         // 어떤 기록된 커맨드를 큐에 제출할지 정의한다.
         VkSubmitInfo submit_info {};
@@ -1032,10 +893,10 @@ private:
         submit_info.pCommandBuffers = &command_buffer_;
 
         // 기록된 커맨드를 큐에 제출한다.
-        vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
+        device_table_.vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
 
         // 커맨드 버퍼들이 모두 처리될 때까지 기다린다.
-        vkDeviceWaitIdle(device_);
+        device_table_.vkDeviceWaitIdle(device_);
     }
 
     void init_swapchain_image_views_()
@@ -1062,7 +923,7 @@ private:
             create_info.image = swapchain_images_[i];
 
             // 이미지 뷰를 생성합니다.
-            auto result = vkCreateImageView(device_, &create_info, nullptr, &swapchain_image_views_[i]);
+            auto result = device_table_.vkCreateImageView(device_, &create_info, nullptr, &swapchain_image_views_[i]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1114,7 +975,7 @@ private:
         create_info.pSubpasses = &subpass_desc;
 
         // 렌더패스를 생성합니다.
-        auto result = vkCreateRenderPass(device_, &create_info, nullptr, &render_pass_);
+        auto result = device_table_.vkCreateRenderPass(device_, &create_info, nullptr, &render_pass_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1147,7 +1008,7 @@ private:
             create_info.pAttachments = &swapchain_image_views_[i];
 
             // 프레임버퍼를 생성합니다.
-            auto result = vkCreateFramebuffer(device_, &create_info, nullptr, &framebuffers_[i]);
+            auto result = device_table_.vkCreateFramebuffer(device_, &create_info, nullptr, &framebuffers_[i]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1191,7 +1052,7 @@ private:
             create_info.pCode = &spirv[0];
 
             // 셰이더 모듈을 생성합니다.
-            auto result = vkCreateShaderModule(device_, &create_info, nullptr, &shader_modules_[0]);
+            auto result = device_table_.vkCreateShaderModule(device_, &create_info, nullptr, &shader_modules_[0]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1234,7 +1095,7 @@ private:
             create_info.pCode = &spirv[0];
 
             // 셰이더 모듈을 생성합니다.
-            auto result = vkCreateShaderModule(device_, &create_info, nullptr, &shader_modules_[1]);
+            auto result = device_table_.vkCreateShaderModule(device_, &create_info, nullptr, &shader_modules_[1]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1268,7 +1129,8 @@ private:
         create_info.pBindings = &binding;
 
         // 디스크립터 셋 레이아웃을 생성합니다.
-        auto result = vkCreateDescriptorSetLayout(device_, &create_info, nullptr, &material_descriptor_set_layout_);
+        auto result = device_table_.vkCreateDescriptorSetLayout(device_, &create_info, nullptr,
+                                                                &material_descriptor_set_layout_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1293,7 +1155,7 @@ private:
         create_info.pSetLayouts = &material_descriptor_set_layout_;
 
         // 파이프라인 레이아웃을 생성합니다.
-        auto result = vkCreatePipelineLayout(device_, &create_info, nullptr, &pipeline_layout_);
+        auto result = device_table_.vkCreatePipelineLayout(device_, &create_info, nullptr, &pipeline_layout_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1459,7 +1321,8 @@ private:
         create_info.renderPass = render_pass_;
 
         // 그래픽스 파이프라인을 생성합니다.
-        auto result = vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &create_info, nullptr, &pipeline_);
+        auto result = device_table_.vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &create_info, nullptr,
+                                                              &pipeline_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1491,7 +1354,7 @@ private:
         create_info.pPoolSizes = &pool_size;
 
         // 디스크립터 풀을 생성합니다.
-        auto result = vkCreateDescriptorPool(device_, &create_info, nullptr, &descriptor_pool_);
+        auto result = device_table_.vkCreateDescriptorPool(device_, &create_info, nullptr, &descriptor_pool_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1516,7 +1379,7 @@ private:
         allocate_info.pSetLayouts = &material_descriptor_set_layout_;
 
         // 디스크립터 셋을 할당 받습니다.
-        auto result = vkAllocateDescriptorSets(device_, &allocate_info, &material_descriptor_set_);
+        auto result = device_table_.vkAllocateDescriptorSets(device_, &allocate_info, &material_descriptor_set_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1536,123 +1399,120 @@ private:
     void fini_instance_()
     {
         // 생성한 인스턴스를 파괴합니다.
-        vkDestroyInstance(instance_, nullptr);
+        instance_table_.vkDestroyInstance(instance_, nullptr);
+    }
+
+    void fini_memory_allocator_()
+    {
+        // 메모리 할당자를 파괴합니다. 할당자에서 메모리를 할당받은 리소스들이 모두 파괴된 후에 파괴해야 합니다.
+        memory_allocator_.reset();
     }
 
     void fini_device_()
     {
         // 생성한 디바이스를 파괴합니다.
-        vkDestroyDevice(device_, nullptr);
+        device_table_.vkDestroyDevice(device_, nullptr);
     }
 
     void fini_command_pool_()
     {
         // 생성한 커맨드 풀을 파괴합니다.
         // 커맨드 풀이 파괴되면 커맨드 버퍼도 파괴됩니다.
-        vkDestroyCommandPool(device_, command_pool_, nullptr);
+        device_table_.vkDestroyCommandPool(device_, command_pool_, nullptr);
     }
 
     void fini_semaphores_()
     {
         // 생성한 세마포어를 파괴합니다.
         for (auto& semaphore : semaphores_)
-            vkDestroySemaphore(device_, semaphore, nullptr);
+            device_table_.vkDestroySemaphore(device_, semaphore, nullptr);
     }
 
     void fini_fence_()
     {
         // 생성한 펜스를 파괴합니다.
-        vkDestroyFence(device_, fence_, nullptr);
+        device_table_.vkDestroyFence(device_, fence_, nullptr);
     }
 
     void fini_vertex_resources_()
     {
-        // 할당된 메모리를 해제합니다.
-        vkFreeMemory(device_, vertex_device_memory_, nullptr);
-
-        // 생성된 버퍼를 파괴합니다.
-        vkDestroyBuffer(device_, vertex_buffer_, nullptr);
+        // 생성된 버퍼를 파괴하고 할당된 메모리를 해제합니다.
+        memory_allocator_->destroy_buffer(vertex_buffer_, vertex_device_memory_);
     }
 
     void fini_index_resources_()
     {
-        // 할당된 메모리를 해제합니다.
-        vkFreeMemory(device_, index_device_memory_, nullptr);
-
-        // 생성된 버퍼를 파괴합니다.
-        vkDestroyBuffer(device_, index_buffer_, nullptr);
+        // 생성된 버퍼를 파괴하고 할당된 메모리를 해제합니다.
+        memory_allocator_->destroy_buffer(index_buffer_, index_device_memory_);
     }
 
     void fini_uniform_resources_()
     {
-        // 할당된 메모리를 해제합니다.
-        vkFreeMemory(device_, uniform_device_memory_, nullptr);
-
-        // 생성된 버퍼를 파괴합니다.
-        vkDestroyBuffer(device_, uniform_buffer_, nullptr);
+        // 생성된 버퍼를 파괴하고 할당된 메모리를 해제합니다.
+        memory_allocator_->destroy_buffer(uniform_buffer_, uniform_device_memory_);
     }
 
     void fini_surface_()
     {
         // 생성한 서피스를 파괴합니다.
-        vkDestroySurfaceKHR(instance_, surface_, nullptr);
+        instance_table_.vkDestroySurfaceKHR(instance_, surface_, nullptr);
     }
 
     void fini_swapchain_()
     {
         // 생성한 스왑체인을 파괴합니다.
-        vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+        device_table_.vkDestroySwapchainKHR(device_, swapchain_, nullptr);
     }
 
     void fini_swapchain_image_views_()
     {
         // 생성한 이미지 뷰를 파괴합니다.
         for (auto& image_view : swapchain_image_views_)
-            vkDestroyImageView(device_, image_view, nullptr);
+            device_table_.vkDestroyImageView(device_, image_view, nullptr);
     }
 
     void fini_render_pass_()
     {
         // 생성한 렌더 패스를 파괴합니다.
-        vkDestroyRenderPass(device_, render_pass_, nullptr);
+        device_table_.vkDestroyRenderPass(device_, render_pass_, nullptr);
     }
 
     void fini_framebuffers_()
     {
         // 생성한 프레임버퍼를 파괴합니다.
         for (auto& framebuffer : framebuffers_)
-            vkDestroyFramebuffer(device_, framebuffer, nullptr);
+            device_table_.vkDestroyFramebuffer(device_, framebuffer, nullptr);
     }
 
     void fini_shader_modules_()
     {
         // 생성한 셰이더 모듈을 파괴합니다.
         for (auto& shader_module : shader_modules_)
-            vkDestroyShaderModule(device_, shader_module, nullptr);
+            device_table_.vkDestroyShaderModule(device_, shader_module, nullptr);
     }
 
     void fini_descriptor_set_layouts_()
     {
         // 생성한 디스크립터 셋 레이아웃을 파괴합니다.
-        vkDestroyDescriptorSetLayout(device_, material_descriptor_set_layout_, nullptr);
+        device_table_.vkDestroyDescriptorSetLayout(device_, material_descriptor_set_layout_, nullptr);
     }
 
     void fini_pipeline_layout_()
     {
         // 생성한 파이프라인 레이아웃을 파괴합니다.
-        vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
+        device_table_.vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
     }
 
     void fini_pipeline_()
     {
         // 생성한 그래픽스 파이프라인을 파괴합니다.
-        vkDestroyPipeline(device_, pipeline_, nullptr);
+        device_table_.vkDestroyPipeline(device_, pipeline_, nullptr);
     }
 
     void fini_descriptor_pool_()
     {
         // 생성한 디스크립터 풀을 파괴합니다.
-        vkDestroyDescriptorPool(device_, descriptor_pool_, nullptr);
+        device_table_.vkDestroyDescriptorPool(device_, descriptor_pool_, nullptr);
     }
 
     void on_startup()
@@ -1673,7 +1533,7 @@ private:
 
     void on_shutdown()
     {
-        vkDeviceWaitIdle(device_);
+        device_table_.vkDeviceWaitIdle(device_);
 
         fini_descriptor_pool_();
         fini_pipeline_();
@@ -1692,20 +1552,20 @@ private:
         // 스왑체인으로부터 사용가능한 이미지 인덱스를 얻어옵니다.
         // 세마포어를 통해서 GPU에서 스왑체인 이미지가 언제 사용 가능한지 알 수 있습니다.
         uint32_t swapchain_index;
-        vkAcquireNextImageKHR(device_, swapchain_, UINT64_MAX,
-                              semaphores_[image_available_index], VK_NULL_HANDLE,
-                              &swapchain_index);
+        device_table_.vkAcquireNextImageKHR(device_, swapchain_, UINT64_MAX,
+                                            semaphores_[image_available_index], VK_NULL_HANDLE,
+                                            &swapchain_index);
 
         auto& swapchain_image = swapchain_images_[swapchain_index];
 
         // 새로운 프레임을 렌더링하기 위해선 제출한 커맨드 버퍼가 처리되었는지를 확인해야합니다.
         // 다 처리되었는지를 알기 위해서 큐에 커맨드 버퍼를 제출할 때 파라미터로 펜스를 넘길 수 있습니다.
         // 커맨드 버퍼를 리셋하기 전에 펜스의 상태를 확인한 뒤 언시그널드 상태이면 시그널 상태가 될 때까지 기다립니다.
-        if (VK_NOT_READY == vkGetFenceStatus(device_, fence_))
-            vkWaitForFences(device_, 1, &fence_, VK_TRUE, UINT64_MAX);
+        if (VK_NOT_READY == device_table_.vkGetFenceStatus(device_, fence_))
+            device_table_.vkWaitForFences(device_, 1, &fence_, VK_TRUE, UINT64_MAX);
 
         // 펜스를 언시그널 상태로 변경합니다.
-        vkResetFences(device_, 1, &fence_);
+        device_table_.vkResetFences(device_, 1, &fence_);
 
         // 디스크립터 셋이 가리킬 버퍼 정보를 정의합니다.
         VkDescriptorBufferInfo buffer_info {};
@@ -1725,7 +1585,7 @@ private:
         descriptor_write.pBufferInfo = &buffer_info;
 
         // 디스크립터 셋을 업데이트 합니다.
-        vkUpdateDescriptorSets(device_, 1, &descriptor_write, 0, nullptr);
+        device_table_.vkUpdateDescriptorSets(device_, 1, &descriptor_write, 0, nullptr);
 
         // 매 프레임마다 디스크립터 셋이 업데이트됩니다. 그러나 동일한 유니폼 버퍼를 가리키기 때문에
         // 처음 한번만 업데이트하면 될 뿐 매 프레임마다 업데이트 할 필요는 없습니다.
@@ -1733,7 +1593,7 @@ private:
 
         // CPU에서 유니폼 버퍼 메모리에 접근하기 위한 버추얼 어드레스를 가져옵니다.
         void* contents;
-        vkMapMemory(device_, uniform_device_memory_, 0, sizeof(Material), 0, &contents);
+        memory_allocator_->map(uniform_device_memory_, &contents);
 
         // CPU에서 정의한 메터리얼 구조체로 캐스팅합니다.
         auto material = static_cast<Material*>(contents);
@@ -1754,10 +1614,10 @@ private:
         material->b = value;
 
         // CPU에서 메모리의 접근을 끝마칩니다.
-        vkUnmapMemory(device_, uniform_device_memory_);
+        memory_allocator_->unmap(uniform_device_memory_);
 
         // 커맨드 버퍼를 재사용하기 위해서 커맨드 버퍼를 리셋합니다.
-        vkResetCommandBuffer(command_buffer_, 0);
+        device_table_.vkResetCommandBuffer(command_buffer_, 0);
         // 커맨드 버퍼에 기록하는 커맨드들은 변하지 않기 때문에 다시 기록할 필요는 없습니다.
         // 하지만 일반적인 경우에 매 프레임마다 필요한 커맨드들이 다르기 때문에 리셋하고 다시 기록합니다.
 
@@ -1768,7 +1628,7 @@ private:
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         // 커맨드 버퍼를 기록중 상태로 전이합니다.
-        vkBeginCommandBuffer(command_buffer_, &begin_info);
+        device_table_.vkBeginCommandBuffer(command_buffer_, &begin_info);
 
         {
             // 이미지 배리어를 정의하기 위한 변수를 선언합니다.
@@ -1786,12 +1646,13 @@ private:
             barrier.subresourceRange.levelCount = 1;
             barrier.subresourceRange.layerCount = 1;
 
-            vkCmdPipelineBarrier(command_buffer_,
-                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                 0,
-                                 0, nullptr,
-                                 0, nullptr,
-                                 1, &barrier);
+            device_table_.vkCmdPipelineBarrier(command_buffer_,
+                                               VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                               0,
+                                               0, nullptr,
+                                               0, nullptr,
+                                               1, &barrier);
         }
 
         // 클리어 색상을 정의하기 위한 변수를 선언합니다.
@@ -1814,28 +1675,28 @@ private:
         render_pass_begin_info.pClearValues = &clear_value;
 
         // 렌더 패스를 시작합니다.
-        vkCmdBeginRenderPass(command_buffer_, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+        device_table_.vkCmdBeginRenderPass(command_buffer_, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
         // 삼각형을 그리기 위해 필요한 버텍스 버퍼를 0번에 바인드 합니다.
         VkDeviceSize vertex_buffer_offset {0};
-        vkCmdBindVertexBuffers(command_buffer_, 0, 1, &vertex_buffer_, &vertex_buffer_offset);
+        device_table_.vkCmdBindVertexBuffers(command_buffer_, 0, 1, &vertex_buffer_, &vertex_buffer_offset);
 
         // 인덱스 버퍼를 바인드 합니다.
-        vkCmdBindIndexBuffer(command_buffer_, index_buffer_, 0, VK_INDEX_TYPE_UINT16);
+        device_table_.vkCmdBindIndexBuffer(command_buffer_, index_buffer_, 0, VK_INDEX_TYPE_UINT16);
 
         // 삼각형을 그리기 위한 그래픽스 파이프라인을 바인딩합니다.
-        vkCmdBindPipeline(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+        device_table_.vkCmdBindPipeline(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
 
         // 디스크립터 셋을 바인드합니다.
-        vkCmdBindDescriptorSets(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                pipeline_layout_, 0, 1, &material_descriptor_set_,
-                                0, nullptr);
+        device_table_.vkCmdBindDescriptorSets(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                              pipeline_layout_, 0, 1, &material_descriptor_set_,
+                                              0, nullptr);
 
         // 인덱스 버퍼를 이용한 드로우 커맨드를 기록합니다.
-        vkCmdDrawIndexed(command_buffer_, 3, 1, 0, 0, 0);
+        device_table_.vkCmdDrawIndexed(command_buffer_, 3, 1, 0, 0, 0);
 
         // 렌더 패스를 종료합니다.
-        vkCmdEndRenderPass(command_buffer_);
+        device_table_.vkCmdEndRenderPass(command_buffer_);
 
         {
             // 이미지 배리어를 정의하기 위한 변수를 선언합니다.
@@ -1856,17 +1717,18 @@ private:
             barrier.subresourceRange.layerCount = 1;
 
             // 이미지 레이아웃 변경을 위한 파이프라인 배리어 커맨드를 기록합니다.
-            vkCmdPipelineBarrier(command_buffer_,
-                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                                 0,
-                                 0, nullptr,
-                                 0, nullptr,
-                                 1, &barrier);
+            device_table_.vkCmdPipelineBarrier(command_buffer_,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                               VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                               0,
+                                               0, nullptr,
+                                               0, nullptr,
+                                               1, &barrier);
         }
 
         // 필요한 모든 커맨드들을 기록했기 때문에 커맨드 버퍼의 커맨드 기록을 끝마칩니다.
         // 커맨드 버퍼의 상태는 실행 가능 상태입니다.
-        vkEndCommandBuffer(command_buffer_);
+        device_table_.vkEndCommandBuffer(command_buffer_);
 
         // 세마포어가 반드시 시그널 되야하는 파이프라인 스테이지를 정의합니다.
         constexpr VkPipelineStageFlags wait_dst_stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -1888,7 +1750,7 @@ private:
         submit_info.pSignalSemaphores = &semaphores_[rendering_done_index];
 
         // 큐에 커맨드 버퍼를 제출합니다.
-        vkQueueSubmit(queue_, 1, &submit_info, fence_);
+        device_table_.vkQueueSubmit(queue_, 1, &submit_info, fence_);
 
         // 화면에 출력되는 이미지를 정의합니다.
         VkPresentInfoKHR present_info {};
@@ -1903,27 +1765,30 @@ private:
         present_info.pImageIndices = &swapchain_index;
 
         // 화면에 이미지를 출력합니다.
-        vkQueuePresentKHR(queue_, &present_info);
+        device_table_.vkQueuePresentKHR(queue_, &present_info);
     }
 
 private:
     Window* window_;
     VkInstance instance_;
+    Instance_table instance_table_;
     VkPhysicalDevice physical_device_;
     VkPhysicalDeviceMemoryProperties physical_device_memory_properties_;
     uint32_t queue_family_index_;
     VkDevice device_;
+    Device_table device_table_;
+    unique_ptr<Memory_allocator> memory_allocator_;
     VkQueue queue_;
     VkCommandPool command_pool_;
     VkCommandBuffer command_buffer_;
     VkFence fence_;
     std::array<VkSemaphore, 2> semaphores_;
     VkBuffer vertex_buffer_;
-    VkDeviceMemory vertex_device_memory_;
+    VmaAllocation vertex_device_memory_;
     VkBuffer index_buffer_;
-    VkDeviceMemory index_device_memory_;
+    VmaAllocation index_device_memory_;
     VkBuffer uniform_buffer_;
-    VkDeviceMemory uniform_device_memory_;
+    VmaAllocation uniform_device_memory_;
     VkSurfaceKHR surface_;
     VkSwapchainKHR swapchain_;
     vector<VkImage> swapchain_images_;
@@ -1948,12 +1813,30 @@ int main(int argc, char* argv[])
     window_desc.title = L"Chapter12"s;
     window_desc.extent = {512, 512, 1};
 
+#if defined(__linux__)
+    // 헤드리스 윈도우는 기본적으로 5초 동안 실행됩니다.
+    // HEADLESS_FRAME_COUNT, HEADLESS_TIME_BUDGET, HEADLESS_FRAME_RATE 환경 변수로 바꿀 수 있습니다.
+    window_desc.time_budget = 5.0;
+    override_by_env(window_desc);
+#endif
+
     Window window {window_desc};
 
     Chapter12 chapter12 {&window};
 
     window.run();
 
+#if defined(__linux__)
+    // 헤드리스 윈도우에서 측정된 프레임 처리량을 출력합니다.
+    cout << window.frame_count() << " frames";
+
+    // 측정된 시간이 없다면 처리량을 계산할 수 없습니다.
+    if (window.elapsed_time() > 0.0)
+        cout << ", " << window.frame_count() / window.elapsed_time() << " fps";
+
+    cout << endl;
+#endif
+
     return 0;
 }
 
@@ -11,18 +11,105 @@
 #endif
 
 #include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
 #include <vector>
 #include <array>
+#include <memory>
 #include <filesystem>
-#include <vulkan/vulkan.h>
+#include <new>
+#include <vlk/Vulkan.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// 디코딩된 비트맵의 메모리를 그대로 임포트하려면 포인터와 크기가 임포트 정렬의 배수이어야 합니다.
+// 또한 다른 할당과 페이지를 공유하면 관계없는 힙 데이터가 디바이스에 노출되기 때문에
+// stb_image의 할당을 정렬된 페이지들에 따로 할당합니다.
+static std::size_t image_alignment {alignof(std::max_align_t)};
+
+// 할당의 앞에 정렬된 헤더를 두고 헤더의 끝에 요청된 크기, 정렬, 헤더의 크기를 기록합니다.
+struct Image_header {
+    std::size_t size;
+    std::size_t alignment;
+    std::size_t offset;
+};
+
+static Image_header* image_header(void* pointer)
+{
+    return static_cast<Image_header*>(pointer) - 1;
+}
+
+static void* image_malloc(std::size_t size)
+{
+    auto alignment = image_alignment;
+    // 정렬과 64는 2의 거듭제곱이기 때문에 더 큰 쪽이 둘의 배수이고 헤더를 담을 수 있습니다.
+    auto offset = std::max<std::size_t>(alignment, 64);
+    auto aligned_size = (size + alignment - 1) / alignment * alignment;
+    auto memory = static_cast<std::byte*>(operator new(offset + aligned_size, std::align_val_t {alignment},
+                                                       std::nothrow));
+
+    if (!memory)
+        return nullptr;
+
+    auto pointer = memory + offset;
+
+    *image_header(pointer) = {size, alignment, offset};
+
+    return pointer;
+}
+
+static void image_free(void* pointer)
+{
+    if (!pointer)
+        return;
+
+    auto header = *image_header(pointer);
+
+    operator delete(static_cast<std::byte*>(pointer) - header.offset, std::align_val_t {header.alignment});
+}
+
+static void* image_realloc(void* pointer, std::size_t size)
+{
+    auto new_pointer = image_malloc(size);
+
+    if (!new_pointer || !pointer)
+        return new_pointer;
+
+    std::memcpy(new_pointer, pointer, std::min(image_header(pointer)->size, size));
+    image_free(pointer);
+
+    return new_pointer;
+}
+
+#define STBI_MALLOC(size) image_malloc(size)
+#define STBI_REALLOC(pointer, size) image_realloc(pointer, size)
+#define STBI_FREE(pointer) image_free(pointer)
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <platform/Window.h>
+#include <platform/Mapped_file.h>
+#include <platform/Frame_arena.h>
+#include <platform/Allocation_counter.h>
+#include <platform/Stream_copy.h>
+#include <platform/Job_system.h>
+#include <platform/Frame_loop.h>
 #include <sc/Spirv_compiler.h>
+#include <sc/Variant_manager.h>
+#include <vlk/Submit_thread.h>
+#include <vlk/Host_allocator.h>
+#include <vlk/Memory_allocator.h>
+#include <vlk/Defragmenter.h>
+#include <vlk/Mapped_buffer.h>
+#include <vlk/Residency_manager.h>
+#include <vlk/Host_importer.h>
+#include <vlk/Frame_ring.h>
 
 using namespace std;
 using namespace Platform;
 using namespace Sc;
+using namespace Vlk;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -31,6 +118,12 @@ constexpr auto swapchain_image_count {2};
 constexpr auto image_available_index {0};
 constexpr auto rendering_done_index {1};
 
+// 초당 변하는 색상의 각속도를 정의합니다.
+constexpr auto angular_speed {3.0};
+
+// 큐 제출과 출력을 별도의 스레드에서 처리할지 정의합니다.
+constexpr auto use_submit_thread {true};
+
 //----------------------------------------------------------------------------------------------------------------------
 
 // 위치와 색상 정보를 가진 버텍스 정보를 정의합니다.
@@ -49,15 +142,34 @@ struct Material {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+// 업데이트가 계산하고 렌더링이 사용하는 프레임 데이터를 정의합니다.
+struct Frame_data {
+    double time;       // 시뮬레이션 시간
+    Material material; // 메터리얼 정보
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 class Chapter15 {
 public:
     Chapter15(Window* window) :
         window_ {window},
         instance_ {VK_NULL_HANDLE},
+        instance_table_ {},
         physical_device_ {VK_NULL_HANDLE},
         physical_device_memory_properties_ {},
         queue_family_index_ {UINT32_MAX},
         device_ {VK_NULL_HANDLE},
+        device_table_ {},
+        physical_device_properties2_ {false},
+        external_memory_capabilities_ {false},
+        memory_budget_ {false},
+        external_memory_host_ {false},
+        memory_allocator_ {},
+        defragmenter_ {},
+        residency_manager_ {},
+        host_importer_ {},
+        flush_batch_ {},
         queue_ {VK_NULL_HANDLE},
         command_pool_ {VK_NULL_HANDLE},
         frame_index_ {0},
@@ -66,10 +178,10 @@ public:
         semaphores_ {},
         vertex_buffer_ {VK_NULL_HANDLE},
         vertex_device_memory_ {VK_NULL_HANDLE},
+        vertex_resident_id_ {0},
         index_buffer_ {VK_NULL_HANDLE},
         index_device_memory_ {VK_NULL_HANDLE},
-        uniform_buffers_ {},
-        uniform_device_memories_ {},
+        frame_ring_ {},
         texture_image_ {VK_NULL_HANDLE},
         texture_device_memory_ {VK_NULL_HANDLE},
         texture_image_view_ {VK_NULL_HANDLE},
@@ -85,15 +197,34 @@ public:
         pipeline_layout_ {VK_NULL_HANDLE},
         pipeline_ {VK_NULL_HANDLE},
         descriptor_pool_ {VK_NULL_HANDLE},
-        material_descriptor_sets_ {},
-        texture_descriptor_sets_ {}
+        material_descriptor_set_ {VK_NULL_HANDLE},
+        texture_descriptor_sets_ {},
+        variant_manager_ {},
+        fragment_preamble_ {},
+        fragment_variant_id_ {0},
+        fragment_exact_ {false},
+        fragment_failed_ {false},
+        submit_thread_ {},
+        job_system_ {},
+        frame_loop_ {job_system_,
+                     [this](const Frame_data& frame_data, Frame_data& next_frame_data, const Frame_clock& clock) {
+                         update_(frame_data, next_frame_data, clock);
+                     },
+                     [this](const Frame_data& frame_data) { render_(frame_data); }}
     {
+        // 벌칸 로더를 열고 인스턴스를 생성하기 위한 함수들을 가져옵니다.
+        load_global_functions();
+
         init_signals_();
         init_instance_();
         find_best_physical_device_();
         init_physical_device_memory_properties_();
         find_queue_family_index_();
         init_device_();
+        init_memory_allocator_();
+        init_defragmenter_();
+        init_residency_manager_();
+        init_host_importer_();
         init_queue_();
         init_command_pool_();
         init_command_buffer_();
@@ -107,6 +238,12 @@ public:
 
     ~Chapter15()
     {
+        // 리소스를 파괴하기 전에 디바이스 메모리의 사용량을 기록합니다.
+        dump_memory_report_();
+
+        fini_host_importer_();
+        fini_residency_manager_();
+        fini_defragmenter_();
         fini_texture_resources_();
         fini_uniform_resources_();
         fini_index_resources_();
@@ -114,8 +251,11 @@ public:
         fini_fence_();
         fini_semaphores_();
         fini_command_pool_();
+        fini_memory_allocator_();
         fini_device_();
         fini_instance_();
+
+        print_host_allocation_stats_();
     }
 
 private:
@@ -141,11 +281,40 @@ private:
             "VK_KHR_surface",
 #if defined(_WIN64)
             "VK_KHR_win32_surface"
+#elif defined(__linux__)
+            "VK_EXT_headless_surface"
 #else
             "VK_MVK_macos_surface"
 #endif
         };
 
+        // 벌칸 1.0에서 디바이스의 확장된 속성들을 가져오려면 인스턴스 익스텐션이 필요합니다.
+        // 메모리 버짓 익스텐션이 의존하기 때문에 지원되는 경우에만 사용합니다.
+        {
+            uint32_t count {0};
+
+            vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+
+            vector<VkExtensionProperties> properties(count);
+
+            vkEnumerateInstanceExtensionProperties(nullptr, &count, properties.data());
+
+            for (auto& props : properties) {
+                if (!strcmp(props.extensionName, "VK_KHR_get_physical_device_properties2"))
+                    physical_device_properties2_ = true;
+
+                if (!strcmp(props.extensionName, "VK_KHR_external_memory_capabilities"))
+                    external_memory_capabilities_ = true;
+            }
+
+            if (physical_device_properties2_)
+                extension_names.push_back("VK_KHR_get_physical_device_properties2");
+
+            // 외부 메모리 익스텐션이 의존하는 인스턴스 익스텐션입니다.
+            if (external_memory_capabilities_)
+                extension_names.push_back("VK_KHR_external_memory_capabilities");
+        }
+
         // 생성하려는 인스턴스를 정의합니다.
         VkInstanceCreateInfo create_info {};
 
@@ -156,7 +325,7 @@ private:
         create_info.ppEnabledExtensionNames = &extension_names[0];
 
         // 인스턴스를 생성합니다.
-        auto result = vkCreateInstance(&create_info, nullptr, &instance_);
+        auto result = vkCreateInstance(&create_info, host_allocator_.callbacks(), &instance_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -177,6 +346,9 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
+
+        // 인스턴스로부터 인스턴스 함수들을 인스턴스의 테이블로 가져옵니다.
+        instance_table_ = load_instance_table(instance_);
     }
 
     void find_best_physical_device_()
@@ -185,7 +357,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 물리 디바이스의 수를 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, nullptr);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, nullptr);
 
         // 사용가능한 물리 디바이스들의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkPhysicalDevice> physical_devices;
@@ -194,7 +366,7 @@ private:
         physical_devices.resize(count);
 
         // 사용가능한 물리 디바이스들의 핸들을 얻어옵니다.
-        vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
+        instance_table_.vkEnumeratePhysicalDevices(instance_, &count, &physical_devices[0]);
 
         // 어플리케이션에선 사용가능한 물리 디바이스들 중에서 어플리케이션에
         // 적합한 물리 디바이스를 찾아야 합니다.
@@ -205,7 +377,7 @@ private:
     void init_physical_device_memory_properties_()
     {
         // 물리 디바이스 메모리 성질을 얻어옵니다.
-        vkGetPhysicalDeviceMemoryProperties(physical_device_, &physical_device_memory_properties_);
+        instance_table_.vkGetPhysicalDeviceMemoryProperties(physical_device_, &physical_device_memory_properties_);
     }
 
     void find_queue_family_index_()
@@ -214,7 +386,7 @@ private:
         uint32_t count {0};
 
         // 사용가능한 큐 패밀리의 수를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, 0);
 
         // 사용가능한 큐 패밀리의 정보를 얻기 위한 변수를 선언합니다.
         vector<VkQueueFamilyProperties> properties;
@@ -223,7 +395,7 @@ private:
         properties.resize(count);
 
         // 사용가능한 큐 패밀리의 정보를 얻어옵니다.
-        vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
+        instance_table_.vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &properties[0]);
 
         for (auto i = 0; i != properties.size(); ++i) {
             // 큐 패밀리에서 사용가능한 큐가 있는지 확인합니다.
@@ -264,6 +436,47 @@ private:
             "VK_KHR_swapchain",
         };
 
+        // 메모리 버짓 익스텐션은 다른 프로세스를 포함한 힙의 실제 사용량과 사용 가능한 양을 알려줍니다.
+        // 선택적으로 사용하는 익스텐션이기 때문에 지원되는 경우에만 사용합니다.
+        // 버짓은 확장된 메모리 속성으로 가져오기 때문에 인스턴스 익스텐션이 활성화되어 있어야 합니다.
+        {
+            uint32_t count {0};
+
+            instance_table_.vkEnumerateDeviceExtensionProperties(physical_device_, nullptr, &count, nullptr);
+
+            vector<VkExtensionProperties> properties(count);
+
+            instance_table_.vkEnumerateDeviceExtensionProperties(physical_device_, nullptr, &count, properties.data());
+
+            auto external_memory = false;
+            auto external_memory_host = false;
+
+            for (auto& props : properties) {
+                if (!strcmp(props.extensionName, "VK_EXT_memory_budget"))
+                    memory_budget_ = physical_device_properties2_;
+
+                if (!strcmp(props.extensionName, "VK_KHR_external_memory"))
+                    external_memory = true;
+
+                if (!strcmp(props.extensionName, "VK_EXT_external_memory_host"))
+                    external_memory_host = true;
+            }
+
+            // 외부 메모리 호스트 익스텐션은 인스턴스 익스텐션들과 외부 메모리 익스텐션에 의존합니다.
+            external_memory_host_ = external_memory_host && external_memory &&
+                                    physical_device_properties2_ && external_memory_capabilities_;
+
+            if (memory_budget_)
+                extension_names.push_back("VK_EXT_memory_budget");
+
+            // 외부 메모리 호스트 익스텐션은 호스트 메모리를 디바이스 메모리로 임포트합니다.
+            // 벌칸 1.0에서는 의존하는 외부 메모리 익스텐션도 함께 활성화해야 합니다.
+            if (external_memory_host_) {
+                extension_names.push_back("VK_KHR_external_memory");
+                extension_names.push_back("VK_EXT_external_memory_host");
+            }
+        }
+
         // 생성하려는 디바이스를 정의합니다.
         VkDeviceCreateInfo create_info {};
 
@@ -274,7 +487,8 @@ private:
         create_info.ppEnabledExtensionNames = &extension_names[0];
 
         // 디바이스를 생성합니다.
-        auto result = vkCreateDevice(physical_device_, &create_info, nullptr, &device_);
+        auto result = instance_table_.vkCreateDevice(physical_device_, &create_info, host_allocator_.callbacks(),
+                                                     &device_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -301,12 +515,15 @@ private:
                 break;
         }
         assert(result == VK_SUCCESS);
+
+        // 로더를 거치지 않고 호출하기 위해 디바이스로부터 디바이스 함수들을 디바이스의 테이블로 가져옵니다.
+        device_table_ = load_device_table(instance_table_, device_);
     }
 
     void init_queue_()
     {
         // 디바이스로 부터 생성된 큐의 핸들을 얻어옵니다.
-        vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+        device_table_.vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
     }
 
     void init_command_pool_()
@@ -319,7 +536,8 @@ private:
         create_info.queueFamilyIndex = queue_family_index_;
 
         // 커맨드 풀을 생성합니다.
-        auto result = vkCreateCommandPool(device_, &create_info, nullptr, &command_pool_);
+        auto result = device_table_.vkCreateCommandPool(device_, &create_info, host_allocator_.callbacks(),
+                                                        &command_pool_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -345,7 +563,7 @@ private:
         allocate_info.commandBufferCount = swapchain_image_count;
 
         // 커맨드 버퍼를 생성합니다.
-        auto result = vkAllocateCommandBuffers(device_, &allocate_info, &command_buffers_[0]);
+        auto result = device_table_.vkAllocateCommandBuffers(device_, &allocate_info, &command_buffers_[0]);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -374,7 +592,8 @@ private:
         // - 두 번째 세마포어는 제출한 커맨드 버퍼가 처리된 후에 화면에 출력을 하기 위해 사용됩니다.
         for (auto& semaphores : semaphores_) {
             for (auto& semaphore : semaphores) {
-                auto result = vkCreateSemaphore(device_, &create_info, nullptr, &semaphore);
+                auto result = device_table_.vkCreateSemaphore(device_, &create_info, host_allocator_.callbacks(),
+                                                              &semaphore);
                 switch (result) {
                     case VK_ERROR_OUT_OF_HOST_MEMORY:
                         cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -403,7 +622,7 @@ private:
 
         // 버퍼링을 위해서 스왑체인 이미지의 개수만큼 펜스를 생성합니다.
         for (auto& fence : fences_) {
-            auto result = vkCreateFence(device_, &create_info, nullptr, &fence);
+            auto result = device_table_.vkCreateFence(device_, &create_info, host_allocator_.callbacks(), &fence);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -418,23 +637,62 @@ private:
         }
     }
 
-    uint32_t find_memory_type_index(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties)
+    void init_memory_allocator_()
     {
-        // 메모리 요구사항과 필요한 메모리 성질을 모두 만족하는 메모리 타입 인덱스를 찾습니다.
-        for (auto i = 0; i != physical_device_memory_properties_.memoryTypeCount; ++i) {
-            // 메모리가 i번째 메모리 타입에 할당 가능한지 검사합니다.
-            if (!(requirements.memoryTypeBits & (1 << i)))
-                continue;
+        // 리소스마다 메모리를 할당하면 할당 횟수가 maxMemoryAllocationCount를 쉽게 넘을 수 있습니다.
+        // 그러므로 큰 메모리 블록을 할당하고 리소스들은 블록의 일부를 나눠서 사용합니다.
+        Memory_allocator_desc desc;
+
+        desc.instance = instance_;
+        desc.physical_device = physical_device_;
+        desc.device = device_;
+        desc.instance_table = &instance_table_;
+        desc.device_table = &device_table_;
+        desc.allocation_callbacks = host_allocator_.callbacks();
+        // 익스텐션이 없으면 힙 크기의 80%를 버짓으로 사용합니다.
+        desc.memory_budget = memory_budget_;
+
+        // 메모리 할당자를 생성합니다. 디바이스 함수들을 가져온 후에 생성해야 합니다.
+        memory_allocator_ = make_unique<Memory_allocator>(desc);
+    }
 
-            // 개발자가 요구한 메모리 성질을 만족하는지 검사합니다.
-            if ((physical_device_memory_properties_.memoryTypes[i].propertyFlags & properties) != properties)
-                continue;
+    void init_defragmenter_()
+    {
+        // 리소스를 오랫동안 할당하고 해제하면 메모리 블록에 빈 공간이 흩어집니다.
+        // 조각 모음은 프레임마다 정해진 양의 버퍼만 옮겨서 화면이 멈추지 않고 빈 블록을 해제합니다.
+        Defragmenter_desc desc;
 
-            return i;
-        }
+        // 조각 모음이 기록된 프레임은 같은 프레임을 다시 렌더링할 때 끝났다는 것이 보장됩니다.
+        desc.frames_in_flight = swapchain_image_count;
+
+        // 조각 모음을 생성합니다.
+        defragmenter_ = make_unique<Defragmenter>(*memory_allocator_, desc);
+    }
+
+    void init_residency_manager_()
+    {
+        // 디바이스 메모리가 버짓을 넘으면 드라이버가 임의로 메모리를 옮기거나 할당이 실패합니다.
+        // 레지던시 매니저는 오랫동안 사용하지 않은 리소스를 호스트 메모리로 내보내서 버짓을 지킵니다.
+        Residency_desc desc;
+
+        // 옮겨진 리소스의 이전 메모리는 같은 프레임을 다시 렌더링할 때 해제됩니다.
+        desc.frames_in_flight = swapchain_image_count;
+
+        // 레지던시 매니저를 생성합니다.
+        residency_manager_ = make_unique<Residency_manager>(*memory_allocator_, desc);
+    }
 
-        assert(false);
-        return UINT32_MAX;
+    void init_host_importer_()
+    {
+        // 익스텐션이 지원되지 않으면 임포터를 생성하지 않고 스테이징 버퍼로 업로드합니다.
+        if (!external_memory_host_)
+            return;
+
+        // 호스트 임포터를 생성합니다. 임포트할 수 있는 포인터의 정렬을 가져옵니다.
+        host_importer_ = make_unique<Host_importer>(*memory_allocator_);
+
+        // 이후에 디코딩되는 비트맵은 임포트 정렬에 맞춰 할당됩니다.
+        image_alignment = max<size_t>(host_importer_->alignment(), alignof(max_align_t));
     }
 
     void init_vertex_resources_()
@@ -447,50 +705,62 @@ private:
             {-0.5,  0.5, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0}
         };
 
-        // 생성하려는 버텍스 버퍼를 정의합니다.
-        VkBufferCreateInfo create_info {};
-
-        create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        create_info.size = sizeof(Vertex) * vertices.size();
+        // 버텍스 정보는 변경되지 않기 때문에 GPU가 빠르게 접근할 수 있는 메모리에 할당합니다.
         // 버퍼의 사용처를 VERTEX_BUFFER_BIT을 설정하지 않으면 버텍스 버퍼로 사용할 수 없습니다.
-        create_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        auto create_info = init_immutable_buffer_(&vertices[0], sizeof(Vertex) * vertices.size(),
+                                                  VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                                  "vertex buffer", &vertex_buffer_, &vertex_device_memory_);
 
-        // 버퍼를 생성합니다.
-        auto result = vkCreateBuffer(device_, &create_info, nullptr, &vertex_buffer_);
-        switch (result) {
-            case VK_ERROR_OUT_OF_HOST_MEMORY:
-                cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                break;
-            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                break;
-            default:
-                break;
-        }
-        assert(result == VK_SUCCESS);
+        // 버텍스 버퍼는 메모리가 부족할 때 호스트 메모리로 내보내질 수 있도록 레지던시 매니저에 추가합니다.
+        // 레지던시 매니저가 옮기는 버퍼는 조각 모음에 추가하지 않아야 합니다.
+        vertex_resident_id_ = residency_manager_->add_buffer(create_info, &vertex_buffer_, &vertex_device_memory_);
+    }
+
+    void init_index_resources_()
+    {
+        // 일반적으로 인덱스 정보는 변경되지 않습니다. 즉 CPU의 접근이 필요하지 않고 GPU의 접근만 필요합니다.
+        // 그러므로 GPU가 빠르게 접근할 수 있는 메모리 타입에 할당하는것이 효율적입니다.
 
-        // 메모리 요구사항을 얻어올 변수를 선언합니다.
-        VkMemoryRequirements requirements;
+        // 인덱스 정보를 정의합니다.
+        vector<uint16_t> indices {0, 1, 2};
 
-        // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-        vkGetBufferMemoryRequirements(device_, vertex_buffer_, &requirements);
+        auto create_info = init_immutable_buffer_(&indices[0], sizeof(uint16_t) * indices.size(),
+                                                  VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                                  "index buffer", &index_buffer_, &index_device_memory_);
 
-        // 할당하려는 메모리를 정의합니다.
-        VkMemoryAllocateInfo alloc_info {};
+        // 버퍼가 조각 모음으로 옮겨질 수 있도록 추가합니다.
+        defragmenter_->add_buffer(create_info, &index_buffer_, index_device_memory_);
+    }
 
-        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        alloc_info.allocationSize = requirements.size;
-        // CPU에서 접근 가능하고 CPU와 GPU의 메모리 동기화가 보장되는 메모리 타입을 선택합니다.
-        alloc_info.memoryTypeIndex = find_memory_type_index(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    VkBufferCreateInfo init_immutable_buffer_(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+                                              const char* name, VkBuffer* buffer, VmaAllocation* device_memory)
+    {
+        // 생성하려는 버퍼를 정의합니다.
+        VkBufferCreateInfo create_info {};
 
-        // 메모리를 할당합니다.
-        result = vkAllocateMemory(device_, &alloc_info, nullptr, &vertex_device_memory_);
+        create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        create_info.size = size;
+        // 조각 모음이나 레지던시 매니저가 버퍼를 옮기려면 버퍼를 복사할 수 있어야 합니다.
+        // 스테이징 버퍼로부터 복사를 받을 때도 TRANSFER_DST_BIT이 필요합니다.
+        create_info.usage = usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+        // 메모리 할당자가 변경되지 않는 버퍼에 가장 적합한 메모리 타입을 선택합니다.
+        // ReBAR를 지원하거나 내장 그래픽처럼 메모리를 공유하는 디바이스는 GPU가 빠르게 접근할 수 있는 메모리에
+        // CPU가 바로 쓸 수 있기 때문에 스테이징 버퍼가 필요하지 않습니다.
+        auto placement = memory_allocator_->place_buffer(create_info, Memory_access::immutable);
+
+        // 버퍼를 생성하고 메모리 할당자가 선택된 메모리 타입의 메모리 블록의 일부를 할당해서 바인드합니다.
+        auto result = memory_allocator_->create_buffer(create_info,
+                                                       {VMA_MEMORY_USAGE_UNKNOWN, VK_NULL_HANDLE, name,
+                                                        1u << placement.memory_type},
+                                                       buffer, device_memory);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
                 break;
             case VK_ERROR_OUT_OF_DEVICE_MEMORY:
                 cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
+                dump_memory_report_();
                 break;
             case VK_ERROR_TOO_MANY_OBJECTS:
                 cout << "VK_ERROR_TOO_MANY_OBJECTS" << endl;
@@ -500,23 +770,23 @@ private:
         }
         assert(result == VK_SUCCESS);
 
-        // 버퍼와 메모리를 바인드합니다.
-        result = vkBindBufferMemory(device_, vertex_buffer_, vertex_device_memory_, 0);
-        switch (result) {
-            case VK_ERROR_OUT_OF_HOST_MEMORY:
-                cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                break;
-            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                break;
-            default:
-                break;
-        }
-        assert(result == VK_SUCCESS);
+        if (placement.staging)
+            upload_buffer_(data, size, *buffer);
+        else
+            write_buffer_(data, size, *device_memory);
+
+        // CPU에서 메모리를 자주 접근하는 경우에 언맵을 하지 않고
+        // 맵을 통해 얻어온 버츄얼 어드레스를 계속 사용해도 됩니다.
+        // 하지만 조각 모음이나 레지던시 매니저가 옮기는 버퍼는 CPU에서 접근하지 않아야 합니다.
 
+        return create_info;
+    }
+
+    void write_buffer_(const void* data, VkDeviceSize size, VmaAllocation device_memory)
+    {
         // CPU에서 메모리에 접근하기 위한 버추얼 어드레스를 가져옵니다.
         void* contents;
-        result = vkMapMemory(device_, vertex_device_memory_, 0, sizeof(Vertex) * vertices.size(), 0, &contents);
+        auto result = memory_allocator_->map(device_memory, &contents);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -532,143 +802,41 @@ private:
         }
         assert(result == VK_SUCCESS);
 
-        // 버텍스 정보를 메모리에 복사합니다.
-        memcpy(contents, &vertices[0], sizeof(Vertex) * vertices.size());
+        // 정보를 메모리에 복사합니다. 캐시되지 않는 메모리라면 큰 정보는 캐시를 거치지 않고 씁니다.
+        stream_copy(contents, data, size, memory_allocator_->write_combined(device_memory));
 
         // CPU에서 메모리의 접근을 끝마칩니다.
-        vkUnmapMemory(device_, vertex_device_memory_);
-
-        // CPU에서 메모리를 자주 접근하는 경우에 언맵을 하지 않고
-        // 맵을 통해 얻어온 버츄얼 어드레스를 계속 사용해도 됩니다.
+        memory_allocator_->unmap(device_memory);
     }
 
-    void init_index_resources_()
+    void upload_buffer_(const void* data, VkDeviceSize size, VkBuffer buffer)
     {
-        // 일반적으로 인덱스 정보는 변경되지 않습니다. 즉 CPU의 접근이 필요하지 않고 GPU의 접근만 필요합니다.
-        // 그러므로 GPU가 빠르게 접근할 수 있는 메모리 타입에 할당하는것이 효율적입니다.
-
-        // 인덱스 정보를 정의합니다.
-        vector<uint16_t> indices {0, 1, 2};
-
-        {
-            // 생성하려는 인덱스 버퍼를 정의한다.
-            VkBufferCreateInfo create_info {};
-
-            create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-            create_info.size = sizeof(uint16_t) * indices.size();
-            create_info.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-
-            // 정의한 인덱스 버퍼를 생성한다.
-            auto result = vkCreateBuffer(device_, &create_info, nullptr, &index_buffer_);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 메모리 요구사항을 얻어올 변수를 선언합니다.
-            VkMemoryRequirements requirements;
-
-            // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-            vkGetBufferMemoryRequirements(device_, index_buffer_, &requirements);
-
-            // 할당하려는 메모리를 정의합니다.
-            VkMemoryAllocateInfo alloc_info {};
-
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = requirements.size;
-            // GPU의 접근이 빠르나 CPU는 접근할 수 없습니다.
-            alloc_info.memoryTypeIndex = find_memory_type_index(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-            // 메모리를 할당합니다.
-            result = vkAllocateMemory(device_, &alloc_info, nullptr, &index_device_memory_);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                case VK_ERROR_TOO_MANY_OBJECTS:
-                    cout << "VK_ERROR_TOO_MANY_OBJECTS" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 이 메모리를 CPU가 접근할 수 없기 때문에 메모리의 버추얼 어드레스를 얻어올 수 없습니다.
-            // void* contents;
-            // vkMapMemory(device_, index_device_memory_, 0, VK_WHOLE_SIZE, 0, &contents);
-
-            // 버퍼와 메모리를 바인드합니다.
-            result = vkBindBufferMemory(device_, index_buffer_, index_device_memory_, 0);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-        }
-
         VkBuffer staging_buffer;
-        VkDeviceMemory staging_device_memory;
+        VmaAllocation staging_device_memory;
 
         {
             // 생성하려는 스테이징 버퍼를 정의합니다.
             VkBufferCreateInfo create_info {};
 
             create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-            create_info.size = sizeof(uint16_t) * indices.size();
+            create_info.size = size;
             create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
-            // 버퍼를 생성합니다.
-            auto result = vkCreateBuffer(device_, &create_info, nullptr, &staging_buffer);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 메모리 요구사항을 얻어올 변수를 선언합니다.
-            VkMemoryRequirements requirements;
-
-            // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-            vkGetBufferMemoryRequirements(device_, staging_buffer, &requirements);
+            // 스테이징 버퍼는 한번 쓰고 한번 읽기 때문에 GPU가 빠르게 접근할 수 있는 메모리를 사용하지 않습니다.
+            auto placement = memory_allocator_->place_buffer(create_info, Memory_access::streaming);
 
-            // 할당하려는 메모리를 정의합니다.
-            VkMemoryAllocateInfo alloc_info {};
-
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = requirements.size;
-            // CPU에서 접근 가능하고 CPU와 GPU의 메모리 동기화가 보장되는 메모리 타입을 선택합니다.
-            alloc_info.memoryTypeIndex = find_memory_type_index(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-            // 메모리를 할당합니다.
-            result = vkAllocateMemory(device_, &alloc_info, nullptr, &staging_device_memory);
+            // 버퍼를 생성하고 메모리 할당자가 CPU에서 접근 가능한 메모리 블록의 일부를 할당해서 바인드합니다.
+            auto result = memory_allocator_->create_buffer(create_info,
+                                                           {VMA_MEMORY_USAGE_UNKNOWN, VK_NULL_HANDLE,
+                                                            "staging buffer", 1u << placement.memory_type},
+                                                           &staging_buffer, &staging_device_memory);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
                     break;
                 case VK_ERROR_OUT_OF_DEVICE_MEMORY:
                     cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
+                    dump_memory_report_();
                     break;
                 case VK_ERROR_TOO_MANY_OBJECTS:
                     cout << "VK_ERROR_TOO_MANY_OBJECTS" << endl;
@@ -678,43 +846,7 @@ private:
             }
             assert(result == VK_SUCCESS);
 
-            // 버퍼와 메모리를 바인드합니다.
-            result = vkBindBufferMemory(device_, staging_buffer, staging_device_memory, 0);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // CPU에서 메모리에 접근하기 위한 버추얼 어드레스를 가져옵니다.
-            void* contents;
-            result = vkMapMemory(device_, staging_device_memory, 0, sizeof(uint16_t) * indices.size(), 0, &contents);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                case VK_ERROR_MEMORY_MAP_FAILED:
-                    cout << "VK_ERROR_MEMORY_MAP_FAILED" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 인덱스 정보를 메모리에 복사한다.
-            memcpy(contents, &indices[0], sizeof(uint16_t) * indices.size());
-
-            // CPU에서 메모리의 접근을 끝마칩니다.
-            vkUnmapMemory(device_, staging_device_memory);
+            write_buffer_(data, size, staging_device_memory);
         }
 
         // 생성할 커맨드 버퍼를 정의합니다.
@@ -727,7 +859,7 @@ private:
 
         // 커맨드 버퍼를 생성합니다.
         VkCommandBuffer command_buffer;
-        vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer);
+        device_table_.vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer);
 
         // 커맨드를 기록하기 위해 커맨드 버퍼의 사용목적을 정의한다.
         VkCommandBufferBeginInfo begin_info {};
@@ -736,18 +868,18 @@ private:
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         // 커맨드 버퍼에 커맨드 기록을 시작한다.
-        vkBeginCommandBuffer(command_buffer, &begin_info);
+        device_table_.vkBeginCommandBuffer(command_buffer, &begin_info);
 
         // 복사할 영역을 정의합니다.
         VkBufferCopy region {};
 
-        region.size = sizeof(uint16_t) * indices.size();
+        region.size = size;
 
-        // 스테이징 버퍼를 인덱스 버퍼로 정의한 영역만큼 복사합니다.
-        vkCmdCopyBuffer(command_buffer, staging_buffer, index_buffer_, 1, &region);
+        // 스테이징 버퍼를 버퍼로 정의한 영역만큼 복사합니다.
+        device_table_.vkCmdCopyBuffer(command_buffer, staging_buffer, buffer, 1, &region);
 
         // 커맨드 버퍼에 커맨드 기록을 끝마친다.
-        vkEndCommandBuffer(command_buffer);
+        device_table_.vkEndCommandBuffer(command_buffer);
 
         // 어떤 기록된 커맨드를 큐에 제출할지 정의한다.
         VkSubmitInfo submit_info {};
@@ -757,16 +889,13 @@ private:
         submit_info.pCommandBuffers = &command_buffer;
 
         // 기록된 커맨드를 큐에 제출한다.
-        vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
+        device_table_.vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
 
         // 커맨드 버퍼들이 모두 처리될 때까지 기다린다.
-        vkDeviceWaitIdle(device_);
+        device_table_.vkDeviceWaitIdle(device_);
 
-        // 할당된 메모리를 해제합니다.
-        vkFreeMemory(device_, staging_device_memory, nullptr);
-
-        // 생성된 버퍼를 파괴합니다.
-        vkDestroyBuffer(device_, staging_buffer, nullptr);
+        // 생성된 버퍼를 파괴하고 할당된 메모리를 해제합니다.
+        memory_allocator_->destroy_buffer(staging_buffer, staging_device_memory);
     }
 
     void init_uniform_resources_()
@@ -776,76 +905,27 @@ private:
         // 왜냐하면 커맨드 버퍼를 큐에 제출했을 뿐 GPU가 처리하지는 않았기 때문입니다.
         // 그러므로 한 개의 유니폼 버퍼를 사용한다면 제출한 커맨드 버퍼가 처리될 때 다음 프레임을 위한 데이터가 사용될 수 있습니다.
 
-        // 각 프레임에 해당하는 유니폼 버퍼를 생성합니다.
-        for (auto i = 0; i != swapchain_image_count; ++i) {
-            // 생성하려는 유니폼 버퍼를 정의합니다.
-            VkBufferCreateInfo create_info {};
-
-            create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-            create_info.size = sizeof(Material);
-            // 버퍼의 사용처를 UNIFORM_BUFFER_BIT을 설정하지 않으면 유니폼 버퍼로 사용할 수 없습니다.
-            create_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-
-            // 버퍼를 생성합니다.
-            auto result = vkCreateBuffer(device_, &create_info, nullptr, &uniform_buffers_[i]);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 메모리 요구사항을 얻어올 변수를 선언합니다.
-            VkMemoryRequirements requirements;
-
-            // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-            vkGetBufferMemoryRequirements(device_, vertex_buffer_, &requirements);
+        // 유니폼 버퍼들의 쓰여진 영역을 모아서 한번에 플러시합니다.
+        flush_batch_ = make_unique<Flush_batch>(*memory_allocator_);
 
-            // 할당하려는 메모리를 정의합니다.
-            VkMemoryAllocateInfo alloc_info {};
+        // 오브젝트마다 유니폼 버퍼를 생성하지 않고 프레임 링에서 프레임 동안만 사용하는 영역을 나눠서 사용합니다.
+        // 프레임 링은 한 개의 버퍼를 버퍼링의 개수만큼의 영역으로 나누고 각 프레임은 자신의 영역을 처음부터 할당합니다.
+        // 할당은 오프셋을 증가시킬 뿐이고 버퍼는 파괴될 때까지 매핑된 상태로 유지되기 때문에
+        // 수천개의 오브젝트를 그리더라도 버퍼의 생성이나 매핑이 필요하지 않습니다.
+        Frame_ring_desc desc;
 
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = requirements.size;
-            // CPU에서 접근 가능하고 CPU와 GPU의 메모리 동기화가 보장되는 메모리 타입을 선택합니다.
-            alloc_info.memoryTypeIndex = find_memory_type_index(requirements,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        desc.frame_count = swapchain_image_count;
+        // 유니폼뿐만 아니라 매 프레임마다 변하는 버텍스와 인덱스도 할당할 수 있습니다.
+        desc.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
 
-            // 메모리를 할당합니다.
-            result = vkAllocateMemory(device_, &alloc_info, nullptr, &uniform_device_memories_[i]);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                case VK_ERROR_TOO_MANY_OBJECTS:
-                    cout << "VK_ERROR_TOO_MANY_OBJECTS" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
+        // 매 프레임마다 CPU에서 쓰는 버퍼는 GPU가 빠르게 접근할 수 있으면서 CPU에서 접근 가능한 메모리에 할당합니다.
+        // 매핑된 버퍼는 쓰여진 영역을 직접 플러시하기 때문에 HOST_COHERENT가 아닌 메모리 타입도 사용할 수 있습니다.
+        frame_ring_ = make_unique<Frame_ring>(*memory_allocator_, desc, "frame ring");
 
-            // 버퍼와 메모리를 바인드합니다.
-            result = vkBindBufferMemory(device_, uniform_buffers_[i], uniform_device_memories_[i], 0);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-        }
+        // HOST_COHERENT가 아닌 메모리에 할당된 버퍼는 CPU에서 쓴 내용을 플러시해야 GPU에서 볼 수 있습니다.
+        flush_batch_->add(frame_ring_->mapped_buffer());
     }
 
 
@@ -865,9 +945,15 @@ private:
     {
         auto path = find_asset_path() / "logo.png";
 
+        // 이미지 파일을 매핑합니다. 파일을 버퍼로 복사하지 않고 페이지 캐시에서 바로 읽습니다.
+        Mapped_file file {path.string()};
+
+        file.advise(Access_pattern::sequential);
+        file.prefetch();
+
         int w, h, c;
         // 이미지 파일을 읽는다.
-        auto data = stbi_load(path.c_str(), &w, &h, &c, STBI_rgb_alpha);
+        auto data = stbi_load_from_memory(file.data(), static_cast<int>(file.size()), &w, &h, &c, STBI_rgb_alpha);
 
         {
             // 생성하려는 이미지를 정의합니다.
@@ -886,59 +972,20 @@ private:
             create_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
             create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-            // 이미지를 생성합니다.
-            auto result = vkCreateImage(device_, &create_info, nullptr, &texture_image_);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 메모리 요구사항을 얻어올 변수를 선언합니다.
-            VkMemoryRequirements requirements;
-
-            // 이미지를 위해 필요한 메모리 요구사항을 얻어옵니다.
-            vkGetImageMemoryRequirements(device_, texture_image_, &requirements);
-
-            // 할당하려는 메모리를 정의한다.
-            VkMemoryAllocateInfo alloc_info {};
-
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = requirements.size;
-            // GPU에서 접근이 빠른 메모리 타입을 선택합니다.
-            alloc_info.memoryTypeIndex = find_memory_type_index(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-            // 메모리를 할당합니다.
-            result = vkAllocateMemory(device_, &alloc_info, nullptr, &texture_device_memory_);
+            // 이미지를 생성하고 메모리 할당자가 GPU에서 빠르게 접근할 수 있는 메모리 블록의 일부를 할당해서 바인드합니다.
+            auto result = memory_allocator_->create_image(create_info,
+                                                          {VMA_MEMORY_USAGE_GPU_ONLY, VK_NULL_HANDLE, "texture image"},
+                                                          &texture_image_, &texture_device_memory_);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
                     break;
                 case VK_ERROR_OUT_OF_DEVICE_MEMORY:
                     cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
+                    dump_memory_report_();
                     break;
                 case VK_ERROR_TOO_MANY_OBJECTS:
-                    cout << "VK_ERROR_TOO_MANY_OBJECTS" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 이미지와 메모리를 바인딩합니다.
-            result = vkBindImageMemory(device_, texture_image_, texture_device_memory_, 0);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
+                    cout << "VK_ERROR_TOO_MANY_OBJECTS" << endl;
                     break;
                 default:
                     break;
@@ -950,10 +997,22 @@ private:
         // 이미지는 파일로부터 한번 읽고 특수한 경우를 제외하곤 변경되지 않는다.
         // 그러므로 GPU의 접근이 용이한 메모리를 할당한다.
 
-        VkBuffer staging_buffer;
-        VkDeviceMemory staging_device_memory;
+        // 익스텐션이 지원되면 디코딩된 비트맵의 메모리를 임포트해서 복사의 원본으로 사용합니다.
+        // 스테이징 버퍼의 할당과 비트맵의 복사가 사라지고 디바이스가 호스트 메모리를 직접 읽습니다.
+        // 임포트된 메모리는 비트맵의 할당이기 때문에 복사가 끝난 후에 비트맵을 해제합니다.
+        Imported_buffer imported_buffer;
 
-        {
+        // 비트맵은 임포트 정렬에 맞춰 할당되었기 때문에 정렬된 크기까지 할당에 속합니다.
+        auto import_size = (w * h * STBI_rgb_alpha + image_alignment - 1) / image_alignment * image_alignment;
+        auto imported = host_importer_ &&
+                        host_importer_->import_buffer(data, import_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                      &imported_buffer);
+
+        VkBuffer staging_buffer {VK_NULL_HANDLE};
+        VmaAllocation staging_device_memory {VK_NULL_HANDLE};
+
+        // 임포트가 실패하면 스테이징 버퍼로 업로드합니다.
+        if (!imported) {
             // 생성하려는 스테이징 버퍼를 정의합니다.
             VkBufferCreateInfo create_info {};
 
@@ -961,43 +1020,21 @@ private:
             create_info.size = w * h * STBI_rgb_alpha;
             create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
-            // 버퍼를 생성합니다.
-            auto result = vkCreateBuffer(device_, &create_info, nullptr, &staging_buffer);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
-            // 메모리 요구사항을 얻어올 변수를 선언합니다.
-            VkMemoryRequirements requirements;
-
-            // 버퍼를 위해 필요한 메모리 요구사항을 얻어옵니다.
-            vkGetBufferMemoryRequirements(device_, staging_buffer, &requirements);
-
-            // 할당하려는 메모리를 정의합니다.
-            VkMemoryAllocateInfo alloc_info {};
-
-            alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-            alloc_info.allocationSize = requirements.size;
-            // CPU에서 접근 가능하고 CPU와 GPU의 메모리 동기화가 보장되는 메모리 타입을 선택합니다.
-            alloc_info.memoryTypeIndex = find_memory_type_index(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-                                                                              | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            // 스테이징 버퍼는 한번 쓰고 한번 읽기 때문에 GPU가 빠르게 접근할 수 있는 메모리를 사용하지 않습니다.
+            auto placement = memory_allocator_->place_buffer(create_info, Memory_access::streaming);
 
-            // 메모리를 할당합니다.
-            result = vkAllocateMemory(device_, &alloc_info, nullptr, &staging_device_memory);
+            // 버퍼를 생성하고 메모리 할당자가 CPU에서 접근 가능한 메모리 블록의 일부를 할당해서 바인드합니다.
+            auto result = memory_allocator_->create_buffer(create_info,
+                                                           {VMA_MEMORY_USAGE_UNKNOWN, VK_NULL_HANDLE,
+                                                            "texture staging buffer", 1u << placement.memory_type},
+                                                           &staging_buffer, &staging_device_memory);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
                     break;
                 case VK_ERROR_OUT_OF_DEVICE_MEMORY:
                     cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
+                    dump_memory_report_();
                     break;
                 case VK_ERROR_TOO_MANY_OBJECTS:
                     cout << "VK_ERROR_TOO_MANY_OBJECTS" << endl;
@@ -1007,23 +1044,9 @@ private:
             }
             assert(result == VK_SUCCESS);
 
-            // 버퍼와 메모리를 바인드합니다.
-            result = vkBindBufferMemory(device_, staging_buffer, staging_device_memory, 0);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
-
             // CPU에서 메모리에 접근하기 위한 버추얼 어드레스를 가져옵니다.
             void* contents;
-            result = vkMapMemory(device_, staging_device_memory, 0, w * h * STBI_rgb_alpha, 0, &contents);
+            result = memory_allocator_->map(staging_device_memory, &contents);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1039,18 +1062,17 @@ private:
             }
             assert(result == VK_SUCCESS);
 
-            // 비트맵을 메모리에 복사합니다.
-            memcpy(contents, data, w * h * STBI_rgb_alpha);
+            // 비트맵을 메모리에 복사합니다. 캐시되지 않는 메모리라면 큰 비트맵이 캐시를 밀어내지 않도록
+            // 캐시를 거치지 않고 씁니다.
+            stream_copy(contents, data, w * h * STBI_rgb_alpha,
+                        memory_allocator_->write_combined(staging_device_memory));
 
             // CPU에서 메모리의 접근을 끝마칩니다.
-            vkUnmapMemory(device_, staging_device_memory);
+            memory_allocator_->unmap(staging_device_memory);
         }
 
-        // 이미지를 읽기 위한 메모리를 해제한다.
-        stbi_image_free(data);
-
-        // 비록 이미지를 생성했지만 이미지 데이터는 스테이징 버퍼에 담겨있다.
-        // 그러므로 스테이징 버퍼의 내용을 이미지로 복사해주는 작업을 해야한다.
+        // 비록 이미지를 생성했지만 이미지 데이터는 임포트된 버퍼나 스테이징 버퍼에 담겨있다.
+        // 그러므로 버퍼의 내용을 이미지로 복사해주는 작업을 해야한다.
 
         {
             // 생성할 커맨드 버퍼를 정의합니다.
@@ -1063,7 +1085,7 @@ private:
 
             // 커맨드 버퍼를 생성합니다.
             VkCommandBuffer command_buffer;
-            vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer);
+            device_table_.vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer);
 
             // 커맨드를 기록하기 위해 커맨드 버퍼의 사용목적을 정의한다.
             VkCommandBufferBeginInfo begin_info {};
@@ -1072,7 +1094,7 @@ private:
             begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
             // 커맨드 버퍼에 커맨드 기록을 시작한다.
-            vkBeginCommandBuffer(command_buffer, &begin_info);
+            device_table_.vkBeginCommandBuffer(command_buffer, &begin_info);
 
             {
                 // 이미지 배리어를 정의하기 위한 변수를 선언합니다.
@@ -1090,12 +1112,12 @@ private:
                 barrier.subresourceRange.levelCount = 1;
                 barrier.subresourceRange.layerCount = 1;
 
-                vkCmdPipelineBarrier(command_buffer,
-                                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                     0,
-                                     0, nullptr,
-                                     0, nullptr,
-                                     1, &barrier);
+                device_table_.vkCmdPipelineBarrier(command_buffer,
+                                                   VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                   0,
+                                                   0, nullptr,
+                                                   0, nullptr,
+                                                   1, &barrier);
             }
 
             // 복사될 이미지 서브리소스를 정의합니다.
@@ -1112,11 +1134,11 @@ private:
             region.imageSubresource = subresource_layers;
             region.imageExtent = {static_cast<uint32_t>(w), static_cast<uint32_t>(h), 1};
 
-            // 스테이징 버퍼를 이미지로 정의한 영역만큼 복사합니다.
-            vkCmdCopyBufferToImage(command_buffer,
-                                   staging_buffer,
-                                   texture_image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                   1, &region);
+            // 임포트된 버퍼나 스테이징 버퍼를 이미지로 정의한 영역만큼 복사합니다.
+            device_table_.vkCmdCopyBufferToImage(command_buffer,
+                                                 imported ? imported_buffer.buffer : staging_buffer,
+                                                 texture_image_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                 1, &region);
 
             {
                 // 이미지 배리어를 정의하기 위한 변수를 선언합니다.
@@ -1134,16 +1156,16 @@ private:
                 barrier.subresourceRange.levelCount = 1;
                 barrier.subresourceRange.layerCount = 1;
 
-                vkCmdPipelineBarrier(command_buffer,
-                                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                                     0,
-                                     0, nullptr,
-                                     0, nullptr,
-                                     1, &barrier);
+                device_table_.vkCmdPipelineBarrier(command_buffer,
+                                                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                                   0,
+                                                   0, nullptr,
+                                                   0, nullptr,
+                                                   1, &barrier);
             }
 
             // 커맨드 버퍼에 커맨드 기록을 끝마칩니다.
-            vkEndCommandBuffer(command_buffer);
+            device_table_.vkEndCommandBuffer(command_buffer);
 
             // 어떤 기록된 커맨드를 큐에 제출할지 정의합니다.
             VkSubmitInfo submit_info {};
@@ -1153,21 +1175,24 @@ private:
             submit_info.pCommandBuffers = &command_buffer;
 
             // 기록된 커맨드를 큐에 제출합니다.
-            vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
+            device_table_.vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
 
             // 커맨드 버퍼들이 모두 처리될 때까지 기다립니다.
-            vkDeviceWaitIdle(device_);
+            device_table_.vkDeviceWaitIdle(device_);
 
             // 커맨드 버퍼를 해제합니다.
-            vkFreeCommandBuffers(device_, command_pool_, 1, &command_buffer);
-
-            // 할당된 메모리를 해제합니다.
-            vkFreeMemory(device_, staging_device_memory, nullptr);
+            device_table_.vkFreeCommandBuffers(device_, command_pool_, 1, &command_buffer);
 
-            // 생성된 버퍼를 파괴합니다.
-            vkDestroyBuffer(device_, staging_buffer, nullptr);
+            // 생성된 버퍼를 파괴하고 할당된 메모리를 해제합니다.
+            if (imported)
+                host_importer_->destroy_buffer(imported_buffer);
+            else
+                memory_allocator_->destroy_buffer(staging_buffer, staging_device_memory);
         }
 
+        // 이미지를 읽기 위한 메모리를 해제한다.
+        stbi_image_free(data);
+
         {
             // 그래픽스 파이프라인에서 이미지를 접근하기 위해선 이미지 뷰가 필요합니다.
 
@@ -1183,7 +1208,8 @@ private:
             create_info.subresourceRange.layerCount = 1;
 
             // 이미지 뷰를 생성합니다.
-            auto result = vkCreateImageView(device_, &create_info, nullptr, &texture_image_view_);
+            auto result = device_table_.vkCreateImageView(device_, &create_info, host_allocator_.callbacks(),
+                                                          &texture_image_view_);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1210,7 +1236,8 @@ private:
             create_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
 
             // 샘플러를 생성합니다.
-            auto result = vkCreateSampler(device_, &create_info, nullptr, &texture_sampler_);
+            auto result = device_table_.vkCreateSampler(device_, &create_info, host_allocator_.callbacks(),
+                                                        &texture_sampler_);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1248,7 +1275,8 @@ private:
         create_info.pView = (__bridge void*)content_view;
 
         // 서피스를 생성합니다.
-        auto result = vkCreateMacOSSurfaceMVK(instance_, &create_info, nullptr, &surface_);
+        auto result = instance_table_.vkCreateMacOSSurfaceMVK(instance_, &create_info, host_allocator_.callbacks(),
+                                                              &surface_);
 #elif defined(_WIN64)
         // 생성하려는 서피스를 정의합니다.
         VkWin32SurfaceCreateInfoKHR create_info {};
@@ -1258,7 +1286,18 @@ private:
         create_info.hwnd = static_cast<HWND>(window_->window());
 
         // 서피스를 생성합니다.
-        auto result = vkCreateWin32SurfaceKHR(instance_, &create_info, nullptr, &surface_);
+        auto result = instance_table_.vkCreateWin32SurfaceKHR(instance_, &create_info, host_allocator_.callbacks(),
+                                                              &surface_);
+#elif defined(__linux__)
+        // 헤드리스 서피스는 디스플레이 없이 스왑체인을 생성할 수 있게 합니다.
+        // 그러므로 디스플레이가 없는 리눅스에서도 렌더링 경로를 그대로 실행할 수 있습니다.
+        VkHeadlessSurfaceCreateInfoEXT create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+        // 서피스를 생성합니다.
+        auto result = instance_table_.vkCreateHeadlessSurfaceEXT(instance_, &create_info, host_allocator_.callbacks(),
+                                                                 &surface_);
 #endif
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
@@ -1279,7 +1318,8 @@ private:
         VkBool32 supported;
 
         // 물리 디바이스의 큐 패밀리가 서피스를 지원하는지 확인합니다.
-        vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, queue_family_index_, surface_, &supported);
+        instance_table_.vkGetPhysicalDeviceSurfaceSupportKHR(physical_device_, queue_family_index_, surface_,
+                                                             &supported);
         assert(supported == VK_TRUE);
     }
 
@@ -1289,7 +1329,7 @@ private:
         uint32_t count;
 
         // 사용 가능한 서피스 포맷의 수를 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, nullptr);
+        instance_table_.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, nullptr);
 
         // 사용가능한 서피스 포맷들을 얻기 위한 변수를 선언합니다.
         vector<VkSurfaceFormatKHR> formats;
@@ -1298,7 +1338,7 @@ private:
         formats.resize(count);
 
         // 사용가능한 서피스 포맷들을 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, &formats[0]);
+        instance_table_.vkGetPhysicalDeviceSurfaceFormatsKHR(physical_device_, surface_, &count, &formats[0]);
 
         // 어플리케이션은 여러 조건을 고려해서 최적의 서피스 포맷을 선택해야합니다.
         // 예제의 간소화를 위해서 첫 번째 서피스 포맷을 사용합니다.
@@ -1313,7 +1353,14 @@ private:
         VkSurfaceCapabilitiesKHR surface_capabilities;
 
         // 서피스의 능력을 얻어옵니다.
-        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities);
+        instance_table_.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device_, surface_, &surface_capabilities);
+
+        // 헤드리스 서피스처럼 서피스가 크기를 정하지 않는다면 윈도우의 크기를 사용합니다.
+        if (surface_capabilities.currentExtent.width == UINT32_MAX) {
+            auto extent = window_->extent();
+
+            surface_capabilities.currentExtent = {extent.w, extent.h};
+        }
 
         // 사용할 수 있는 컴포짓 알파 모드를 검색한다.
         VkCompositeAlphaFlagBitsKHR composite_alpha {static_cast<VkCompositeAlphaFlagBitsKHR>(0)};
@@ -1350,7 +1397,8 @@ private:
         create_info.presentMode = VK_PRESENT_MODE_FIFO_KHR;
 
         // 스왑체인을 생성합니다.
-        auto result = vkCreateSwapchainKHR(device_, &create_info, nullptr, &swapchain_);
+        auto result = device_table_.vkCreateSwapchainKHR(device_, &create_info, host_allocator_.callbacks(),
+                                                         &swapchain_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1382,13 +1430,13 @@ private:
         uint32_t count;
 
         // 사용 가능한 스왑체인 이미지의 개수를 얻어옵니다.
-        vkGetSwapchainImagesKHR(device_, swapchain_, &count, nullptr);
+        device_table_.vkGetSwapchainImagesKHR(device_, swapchain_, &count, nullptr);
 
         // 사용 가능한 스왑체인 이미지를 얻기 위한 메모리를 할당합니다.
         swapchain_images_.resize(count);
 
         // 사용 가능한 스왑체인 이미지를 얻어옵니다.
-        vkGetSwapchainImagesKHR(device_, swapchain_, &count, &swapchain_images_[0]);
+        device_table_.vkGetSwapchainImagesKHR(device_, swapchain_, &count, &swapchain_images_[0]);
 
         // 스왑체인 생성시 정의한 이미지의 개수는 최소 이미지의 개수이기 때문에
         // 실제로 더 많은 이미지가 생성될 수 있습니다.
@@ -1405,7 +1453,7 @@ private:
         VkCommandBuffer command_buffer;
 
         // 커맨드 버퍼를 할당받습니다.
-        vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer);
+        device_table_.vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer);
 
         // 커맨드를 기록하기 위해 커맨드 버퍼의 사용목적을 정의한다.
         VkCommandBufferBeginInfo begin_info {};
@@ -1414,7 +1462,7 @@ private:
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         // 커맨드 버퍼에 커맨드 기록을 시작한다.
-        vkBeginCommandBuffer(command_buffer, &begin_info);
+        device_table_.vkBeginCommandBuffer(command_buffer, &begin_info);
 
         // 스왑체인 이미지의 레이아웃을 PRESENT_SRC로 변경하는 배리어를 정의한다.
         // PRESENT_SRC로 변경하는 이유는 렌더링을 위한 커맨드를 단순화하기 위해서이다.
@@ -1436,15 +1484,15 @@ private:
         }
 
         // 정의된 배리어를 실행하는 커맨드를 커맨드 버퍼에 기록한다.
-        vkCmdPipelineBarrier(command_buffer,
-                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                             0,
-                             0, nullptr,
-                             0, nullptr,
-                             barriers.size(), &barriers[0]);
+        device_table_.vkCmdPipelineBarrier(command_buffer,
+                                           VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                           0,
+                                           0, nullptr,
+                                           0, nullptr,
+                                           barriers.size(), &barriers[0]);
 
         // 커맨드 버퍼에 커맨드 기록을 끝마친다.
-        vkEndCommandBuffer(command_buffer);
+        device_table_.vkEndCommandBuffer(command_buffer);
 
         // 어떤 기록된 커맨드를 큐에 제출할지 정의한다.
         VkSubmitInfo submit_info {};
@@ -1454,13 +1502,13 @@ private:
         submit_info.pCommandBuffers = &command_buffer;
 
         // 기록된 커맨드를 큐에 제출한다.
-        vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
+        device_table_.vkQueueSubmit(queue_, 1, &submit_info, VK_NULL_HANDLE);
 
         // 커맨드 버퍼들이 모두 처리될 때까지 기다린다.
-        vkDeviceWaitIdle(device_);
+        device_table_.vkDeviceWaitIdle(device_);
 
         // 커맨드 버퍼를 해제합니다.
-        vkFreeCommandBuffers(device_, command_pool_, 1, &command_buffer);
+        device_table_.vkFreeCommandBuffers(device_, command_pool_, 1, &command_buffer);
     }
 
     void init_swapchain_image_views_()
@@ -1487,7 +1535,8 @@ private:
             create_info.image = swapchain_images_[i];
 
             // 이미지 뷰를 생성합니다.
-            auto result = vkCreateImageView(device_, &create_info, nullptr, &swapchain_image_views_[i]);
+            auto result = device_table_.vkCreateImageView(device_, &create_info, host_allocator_.callbacks(),
+                                                          &swapchain_image_views_[i]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1539,7 +1588,8 @@ private:
         create_info.pSubpasses = &subpass_desc;
 
         // 렌더패스를 생성합니다.
-        auto result = vkCreateRenderPass(device_, &create_info, nullptr, &render_pass_);
+        auto result = device_table_.vkCreateRenderPass(device_, &create_info, host_allocator_.callbacks(),
+                                                       &render_pass_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1572,7 +1622,8 @@ private:
             create_info.pAttachments = &swapchain_image_views_[i];
 
             // 프레임버퍼를 생성합니다.
-            auto result = vkCreateFramebuffer(device_, &create_info, nullptr, &framebuffers_[i]);
+            auto result = device_table_.vkCreateFramebuffer(device_, &create_info, host_allocator_.callbacks(),
+                                                            &framebuffers_[i]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1621,7 +1672,8 @@ private:
             create_info.pCode = &spirv[0];
 
             // 셰이더 모듈을 생성합니다.
-            auto result = vkCreateShaderModule(device_, &create_info, nullptr, &shader_modules_[0]);
+            auto result = device_table_.vkCreateShaderModule(device_, &create_info, host_allocator_.callbacks(),
+                                                             &shader_modules_[0]);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1655,47 +1707,70 @@ private:
                 "void main() {                                       \n"
                 "    vec3 col = i_col;                               \n"
                 "    col *= material.col;                            \n"
+                // USE_TEXTURE가 정의된 배리언트에서만 텍스처를 사용합니다.
+                "#ifdef USE_TEXTURE                                  \n"
                      // 텍스처 좌표 정보를 이용해서 컴바인드 이미지 샘플러로부터 텍셀을 가져옵니다.
                 "    col *= texture(tex, i_uv).rgb;                  \n"
+                "#endif                                              \n"
                 "                                                    \n"
                 "    fragment_color0 = vec4(col, 1.0);               \n"
                 "}                                                   \n"
             };
 
-            // 런타임 컴파일러를 사용해서 VKSL을 SPIRV로 컴파일합니다.
-            auto spirv = Spirv_compiler().compile(Shader_type::fragment, vksl);
+            // 셰이더를 배리언트 매니저에 등록합니다.
+            // 프리앰블이 없는 폴백 배리언트는 등록할 때 바로 컴파일됩니다.
+            variant_manager_.add_shader("fragment", {Shader_type::fragment, vksl, {}});
 
-            // 생성하려는 셰이더 모듈을 정의합니다.
-            VkShaderModuleCreateInfo create_info {};
+            // 텍스처를 사용하는 배리언트를 정의합니다.
+            fragment_preamble_.token("#define USE_TEXTURE");
 
-            create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-            create_info.codeSize = spirv.size() * sizeof(uint32_t);
-            create_info.pCode = &spirv[0];
+            // 배리언트가 캐시되어 있지 않다면 폴백 배리언트를 반환하고 배리언트는 백그라운드에서 컴파일됩니다.
+            // 그러므로 모든 배리언트가 컴파일될 때까지 기다리지 않고 파이프라인을 생성할 수 있습니다.
+            // 매 프레임 키를 만들지 않도록 배리언트의 아이디로 조회합니다.
+            fragment_variant_id_ = variant_manager_.variant_id("fragment", fragment_preamble_);
 
-            // 셰이더 모듈을 생성합니다.
-            auto result = vkCreateShaderModule(device_, &create_info, nullptr, &shader_modules_[1]);
-            switch (result) {
-                case VK_ERROR_OUT_OF_HOST_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                    break;
-                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                    break;
-                default:
-                    break;
-            }
-            assert(result == VK_SUCCESS);
+            auto variant = variant_manager_.variant(fragment_variant_id_);
+
+            fragment_exact_ = variant.exact;
+            init_fragment_shader_module_(*variant.spirv);
         }
     }
 
+    void init_fragment_shader_module_(const vector<uint32_t>& spirv)
+    {
+        // 생성하려는 셰이더 모듈을 정의합니다.
+        VkShaderModuleCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        create_info.codeSize = spirv.size() * sizeof(uint32_t);
+        create_info.pCode = &spirv[0];
+
+        // 셰이더 모듈을 생성합니다.
+        auto result = device_table_.vkCreateShaderModule(device_, &create_info, host_allocator_.callbacks(),
+                                                         &shader_modules_[1]);
+        switch (result) {
+            case VK_ERROR_OUT_OF_HOST_MEMORY:
+                cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
+                break;
+            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
+                cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
+                break;
+            default:
+                break;
+        }
+        assert(result == VK_SUCCESS);
+    }
+
     void init_descriptor_set_layouts_()
     {
         {
             // 유니폼 블록을 위한 디스크립터 셋 레이아웃 바인딩을 정의합니다.
+            // 다이나믹 유니폼 버퍼는 디스크립터 셋을 바인드할 때 오프셋을 지정하기 때문에
+            // 한 개의 디스크립터 셋으로 프레임 링에 할당된 모든 유니폼을 가리킬 수 있습니다.
             VkDescriptorSetLayoutBinding binding {};
 
             binding.binding = 0;
-            binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
             binding.descriptorCount = 1;
             // 프래그먼트 셰이더에서만 접근됩니다.
             binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -1708,7 +1783,8 @@ private:
             create_info.pBindings = &binding;
 
             // 디스크립터 셋 레이아웃을 생성합니다.
-            auto result = vkCreateDescriptorSetLayout(device_, &create_info, nullptr, &material_descriptor_set_layout_);
+            auto result = device_table_.vkCreateDescriptorSetLayout(device_, &create_info, host_allocator_.callbacks(),
+                                                                    &material_descriptor_set_layout_);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1740,7 +1816,8 @@ private:
             create_info.pBindings = &binding;
 
             // 디스크립터 셋 레이아웃을 생성합니다.
-            auto result = vkCreateDescriptorSetLayout(device_, &create_info, nullptr, &texture_descriptor_set_layout_);
+            auto result = device_table_.vkCreateDescriptorSetLayout(device_, &create_info, host_allocator_.callbacks(),
+                                                                    &texture_descriptor_set_layout_);
             switch (result) {
                 case VK_ERROR_OUT_OF_HOST_MEMORY:
                     cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1774,7 +1851,8 @@ private:
         create_info.pSetLayouts = &set_layouts[0];
 
         // 파이프라인 레이아웃을 생성합니다.
-        auto result = vkCreatePipelineLayout(device_, &create_info, nullptr, &pipeline_layout_);
+        auto result = device_table_.vkCreatePipelineLayout(device_, &create_info, host_allocator_.callbacks(),
+                                                           &pipeline_layout_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1952,7 +2030,9 @@ private:
         create_info.renderPass = render_pass_;
 
         // 그래픽스 파이프라인을 생성합니다.
-        auto result = vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &create_info, nullptr, &pipeline_);
+        auto result = device_table_.vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &create_info,
+                                                              host_allocator_.callbacks(),
+                                                              &pipeline_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -1971,9 +2051,9 @@ private:
         // 파이프라인에서 자원을 접근하기 위해서는 디스크립터 셋이 필요합니다.
         // 디스크립터 셋은 디스크립터 풀을 통해 할당받을 수 있습니다.
 
-        // 각 프레임에 해당하는 디스크립터 셋을 할당하기 위해 데스크립터 풀 크기를 변경합니다.
+        // 메터리얼 디스크립터 셋은 모든 프레임이 공유하고 텍스처 디스크립터 셋은 각 프레임마다 할당합니다.
         vector<VkDescriptorPoolSize> pool_size {
-            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
             {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2}
         };
 
@@ -1981,13 +2061,15 @@ private:
         VkDescriptorPoolCreateInfo create_info {};
 
         create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        // 유니폼 버퍼와 컴바인드 이미지 샘플러를 위한 디스크립터 셋이 2개 * 버퍼링의 개수만큼 필요합니다.
-        create_info.maxSets = 4;
+        // 다이나믹 유니폼 버퍼를 위한 디스크립터 셋 1개와 컴바인드 이미지 샘플러를 위한 디스크립터 셋이
+        // 버퍼링의 개수만큼 필요합니다.
+        create_info.maxSets = 3;
         create_info.poolSizeCount = pool_size.size();
         create_info.pPoolSizes = &pool_size[0];
 
         // 디스크립터 풀을 생성합니다.
-        auto result = vkCreateDescriptorPool(device_, &create_info, nullptr, &descriptor_pool_);
+        auto result = device_table_.vkCreateDescriptorPool(device_, &create_info, host_allocator_.callbacks(),
+                                                           &descriptor_pool_);
         switch (result) {
             case VK_ERROR_OUT_OF_HOST_MEMORY:
                 cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -2003,35 +2085,56 @@ private:
 
     void init_descriptor_sets_()
     {
-        // 각 프레임에 해당하는 디스크립터 셋을 할당 받습니다.
-        for (auto i = 0; i != swapchain_image_count; ++i) {
-            {
-                // 할당 받으려는 디스크립터 셋을 정의합니다.
-                VkDescriptorSetAllocateInfo allocate_info {};
+        {
+            // 할당 받으려는 디스크립터 셋을 정의합니다.
+            VkDescriptorSetAllocateInfo allocate_info {};
 
-                allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-                allocate_info.descriptorPool = descriptor_pool_;
-                allocate_info.descriptorSetCount = 1;
-                allocate_info.pSetLayouts = &material_descriptor_set_layout_;
+            allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocate_info.descriptorPool = descriptor_pool_;
+            allocate_info.descriptorSetCount = 1;
+            allocate_info.pSetLayouts = &material_descriptor_set_layout_;
 
-                // 디스크립터 셋을 할당 받습니다.
-                auto result = vkAllocateDescriptorSets(device_, &allocate_info, &material_descriptor_sets_[i]);
-                switch (result) {
-                    case VK_ERROR_OUT_OF_HOST_MEMORY:
-                        cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
-                        break;
-                    case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                        cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
-                        break;
-                    case VK_ERROR_OUT_OF_POOL_MEMORY:
-                        cout << "VK_ERROR_OUT_OF_POOL_MEMORY" << endl;
-                        break;
-                    default:
-                        break;
-                }
-                assert(result == VK_SUCCESS);
+            // 모든 프레임과 드로우가 공유하는 메터리얼 디스크립터 셋을 할당 받습니다.
+            auto result = device_table_.vkAllocateDescriptorSets(device_, &allocate_info, &material_descriptor_set_);
+            switch (result) {
+                case VK_ERROR_OUT_OF_HOST_MEMORY:
+                    cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
+                    break;
+                case VK_ERROR_OUT_OF_DEVICE_MEMORY:
+                    cout << "VK_ERROR_OUT_OF_DEVICE_MEMORY" << endl;
+                    break;
+                case VK_ERROR_OUT_OF_POOL_MEMORY:
+                    cout << "VK_ERROR_OUT_OF_POOL_MEMORY" << endl;
+                    break;
+                default:
+                    break;
             }
+            assert(result == VK_SUCCESS);
+
+            // 디스크립터 셋이 가리킬 버퍼 정보를 정의합니다.
+            // 오프셋은 바인드할 때 지정하는 다이나믹 오프셋에 더해지기 때문에 0으로 정의합니다.
+            VkDescriptorBufferInfo buffer_info {};
+
+            buffer_info.buffer = frame_ring_->buffer();
+            buffer_info.offset = 0;
+            buffer_info.range = sizeof(Material);
+
+            // 디스크립터 셋이 어떤 리소스를 가리킬지 정의합니다.
+            VkWriteDescriptorSet descriptor_write {};
+
+            descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_write.dstSet = material_descriptor_set_;
+            descriptor_write.dstBinding = 0;
+            descriptor_write.descriptorCount = 1;
+            descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            descriptor_write.pBufferInfo = &buffer_info;
+
+            // 프레임 링의 버퍼는 바뀌지 않기 때문에 디스크립터 셋은 한번만 업데이트합니다.
+            device_table_.vkUpdateDescriptorSets(device_, 1, &descriptor_write, 0, nullptr);
+        }
 
+        // 각 프레임에 해당하는 디스크립터 셋을 할당 받습니다.
+        for (auto i = 0; i != swapchain_image_count; ++i) {
             {
                 // 할당 받으려는 디스크립터 셋을 정의합니다.
                 VkDescriptorSetAllocateInfo allocate_info {};
@@ -2042,7 +2145,8 @@ private:
                 allocate_info.pSetLayouts = &texture_descriptor_set_layout_;
 
                 // 디스크립터 셋을 할당 받습니다.
-                auto result = vkAllocateDescriptorSets(device_, &allocate_info, &texture_descriptor_sets_[i]);
+                auto result = device_table_.vkAllocateDescriptorSets(device_, &allocate_info,
+                                                                     &texture_descriptor_sets_[i]);
                 switch (result) {
                    case VK_ERROR_OUT_OF_HOST_MEMORY:
                        cout << "VK_ERROR_OUT_OF_HOST_MEMORY" << endl;
@@ -2061,23 +2165,64 @@ private:
         }
     }
 
+    void init_submit_thread_()
+    {
+        if (!use_submit_thread)
+            return;
+
+        // 준비된 프레임을 큐에 제출하고 화면에 출력하는 제출 스레드를 생성합니다.
+        submit_thread_ = make_unique<Vlk::Submit_thread>(device_table_, queue_, swapchain_image_count);
+    }
+
     void fini_instance_()
     {
         // 생성한 인스턴스를 파괴합니다.
-        vkDestroyInstance(instance_, nullptr);
+        instance_table_.vkDestroyInstance(instance_, host_allocator_.callbacks());
+    }
+
+    void fini_host_importer_()
+    {
+        // 호스트 임포터를 파괴합니다.
+        host_importer_.reset();
+    }
+
+    void fini_residency_manager_()
+    {
+        // 레지던시 매니저를 파괴합니다. 디바이스가 유휴 상태일 때 파괴해야 합니다.
+        residency_manager_.reset();
+    }
+
+    void fini_defragmenter_()
+    {
+        // 조각 모음을 파괴합니다. 디바이스가 유휴 상태일 때 파괴해야 합니다.
+        defragmenter_.reset();
+    }
+
+    void fini_memory_allocator_()
+    {
+        // 파괴되지 않은 리소스가 남아있다면 누수입니다. 이름과 할당한 위치를 출력합니다.
+        for (auto& record : memory_allocator_->live_allocations()) {
+            cout << "leak : " << record.name << ", "
+                 << record.size << " bytes, "
+                 << "memory type " << record.memory_type << ", "
+                 << record.file << ':' << record.line << endl;
+        }
+
+        // 메모리 할당자를 파괴합니다. 할당자에서 메모리를 할당받은 리소스들이 모두 파괴된 후에 파괴해야 합니다.
+        memory_allocator_.reset();
     }
 
     void fini_device_()
     {
         // 생성한 디바이스를 파괴합니다.
-        vkDestroyDevice(device_, nullptr);
+        device_table_.vkDestroyDevice(device_, host_allocator_.callbacks());
     }
 
     void fini_command_pool_()
     {
         // 생성한 커맨드 풀을 파괴합니다.
         // 커맨드 풀이 파괴되면 커맨드 버퍼도 파괴됩니다.
-        vkDestroyCommandPool(device_, command_pool_, nullptr);
+        device_table_.vkDestroyCommandPool(device_, command_pool_, host_allocator_.callbacks());
     }
 
     void fini_semaphores_()
@@ -2085,7 +2230,7 @@ private:
         // 생성한 세마포어를 파괴합니다.
         for (auto& semaphores : semaphores_) {
             for (auto& semaphore : semaphores)
-                vkDestroySemaphore(device_, semaphore, nullptr);
+                device_table_.vkDestroySemaphore(device_, semaphore, host_allocator_.callbacks());
         }
     }
 
@@ -2093,114 +2238,114 @@ private:
     {
         // 생성한 펜스를 파괴합니다.
         for (auto& fence : fences_)
-            vkDestroyFence(device_, fence, nullptr);
+            device_table_.vkDestroyFence(device_, fence, host_allocator_.callbacks());
     }
 
     void fini_vertex_resources_()
     {
-        // 할당된 메모리를 해제합니다.
-        vkFreeMemory(device_, vertex_device_memory_, nullptr);
-
-        // 생성된 버퍼를 파괴합니다.
-        vkDestroyBuffer(device_, vertex_buffer_, nullptr);
+        // 생성된 버퍼를 파괴하고 할당된 메모리를 해제합니다.
+        // 레지던시 매니저가 옮긴 버퍼라면 마지막으로 옮겨진 버퍼입니다.
+        memory_allocator_->destroy_buffer(vertex_buffer_, vertex_device_memory_);
     }
 
     void fini_index_resources_()
     {
-        // 할당된 메모리를 해제합니다.
-        vkFreeMemory(device_, index_device_memory_, nullptr);
-
-        // 생성된 버퍼를 파괴합니다.
-        vkDestroyBuffer(device_, index_buffer_, nullptr);
+        // 생성된 버퍼를 파괴하고 할당된 메모리를 해제합니다.
+        memory_allocator_->destroy_buffer(index_buffer_, index_device_memory_);
     }
 
     void fini_uniform_resources_()
     {
-        // 할당된 메모리를 해제합니다.
-        for (auto& memory : uniform_device_memories_)
-            vkFreeMemory(device_, memory, nullptr);
+        flush_batch_.reset();
 
-        // 생성된 버퍼를 파괴합니다.
-        for (auto& buffer : uniform_buffers_)
-            vkDestroyBuffer(device_, buffer, nullptr);
+        // 생성된 프레임 링을 파괴하고 할당된 메모리를 해제합니다.
+        frame_ring_.reset();
     }
 
     void fini_texture_resources_()
     {
         // 생성한 샘플러를 파괴합니다.
-        vkDestroySampler(device_, texture_sampler_, nullptr);
+        device_table_.vkDestroySampler(device_, texture_sampler_, host_allocator_.callbacks());
 
         // 생성한 이미지 뷰를 파괴합니다.
-        vkDestroyImageView(device_, texture_image_view_, nullptr);
-
-        // 할당된 메모리를 해제합니다.
-        vkFreeMemory(device_, texture_device_memory_, nullptr);
+        device_table_.vkDestroyImageView(device_, texture_image_view_, host_allocator_.callbacks());
 
-        // 생성한 이미지를 파괴합니다.
-        vkDestroyImage(device_, texture_image_, nullptr);
+        // 생성된 이미지를 파괴하고 할당된 메모리를 해제합니다.
+        memory_allocator_->destroy_image(texture_image_, texture_device_memory_);
     }
 
     void fini_surface_()
     {
         // 생성한 서피스를 파괴합니다.
-        vkDestroySurfaceKHR(instance_, surface_, nullptr);
+        instance_table_.vkDestroySurfaceKHR(instance_, surface_, host_allocator_.callbacks());
     }
 
     void fini_swapchain_()
     {
         // 생성한 스왑체인을 파괴합니다.
-        vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+        device_table_.vkDestroySwapchainKHR(device_, swapchain_, host_allocator_.callbacks());
     }
 
     void fini_swapchain_image_views_()
     {
         // 생성한 이미지 뷰를 파괴합니다.
         for (auto& image_view : swapchain_image_views_)
-            vkDestroyImageView(device_, image_view, nullptr);
+            device_table_.vkDestroyImageView(device_, image_view, host_allocator_.callbacks());
     }
 
     void fini_render_pass_()
     {
         // 생성한 렌더 패스를 파괴합니다.
-        vkDestroyRenderPass(device_, render_pass_, nullptr);
+        device_table_.vkDestroyRenderPass(device_, render_pass_, host_allocator_.callbacks());
     }
 
     void fini_framebuffers_()
     {
         // 생성한 프레임버퍼를 파괴합니다.
         for (auto& framebuffer : framebuffers_)
-            vkDestroyFramebuffer(device_, framebuffer, nullptr);
+            device_table_.vkDestroyFramebuffer(device_, framebuffer, host_allocator_.callbacks());
     }
 
     void fini_shader_modules_()
     {
         // 생성한 셰이더 모듈을 파괴합니다.
         for (auto& shader_module : shader_modules_)
-            vkDestroyShaderModule(device_, shader_module, nullptr);
+            device_table_.vkDestroyShaderModule(device_, shader_module, host_allocator_.callbacks());
     }
 
     void fini_descriptor_set_layouts_()
     {
         // 생성한 디스크립터 셋 레이아웃을 파괴합니다.
-        vkDestroyDescriptorSetLayout(device_, material_descriptor_set_layout_, nullptr);
+        device_table_.vkDestroyDescriptorSetLayout(device_, material_descriptor_set_layout_,
+                                                   host_allocator_.callbacks());
     }
 
     void fini_pipeline_layout_()
     {
         // 생성한 파이프라인 레이아웃을 파괴합니다.
-        vkDestroyPipelineLayout(device_, pipeline_layout_, nullptr);
+        device_table_.vkDestroyPipelineLayout(device_, pipeline_layout_, host_allocator_.callbacks());
     }
 
     void fini_pipeline_()
     {
         // 생성한 그래픽스 파이프라인을 파괴합니다.
-        vkDestroyPipeline(device_, pipeline_, nullptr);
+        device_table_.vkDestroyPipeline(device_, pipeline_, host_allocator_.callbacks());
     }
 
     void fini_descriptor_pool_()
     {
         // 생성한 디스크립터 풀을 파괴합니다.
-        vkDestroyDescriptorPool(device_, descriptor_pool_, nullptr);
+        device_table_.vkDestroyDescriptorPool(device_, descriptor_pool_, host_allocator_.callbacks());
+    }
+
+    void fini_submit_thread_()
+    {
+        if (!submit_thread_)
+            return;
+
+        // 모든 프레임이 제출되고 출력될 때까지 기다린 뒤 제출 스레드를 파괴합니다.
+        submit_thread_->wait_idle();
+        submit_thread_.reset();
     }
 
     void on_startup()
@@ -2217,11 +2362,15 @@ private:
         init_pipeline_();
         init_descriptor_pool_();
         init_descriptor_sets_();
+        init_submit_thread_();
     }
 
     void on_shutdown()
     {
-        vkDeviceWaitIdle(device_);
+        // 제출 스레드가 큐를 사용하지 않을 때까지 기다린 뒤 파괴합니다.
+        fini_submit_thread_();
+
+        device_table_.vkDeviceWaitIdle(device_);
 
         fini_descriptor_pool_();
         fini_pipeline_();
@@ -2235,19 +2384,146 @@ private:
         fini_surface_();
     }
 
+    void print_host_allocation_stats_()
+    {
+        constexpr const char* scope_names[] = {"command", "object", "cache", "device", "instance"};
+
+        // 드라이버가 할당한 호스트 메모리를 범위별로 출력합니다.
+        // 모든 오브젝트를 파괴한 뒤에도 남아있는 메모리가 있다면 누수입니다.
+        for (auto i = 0; i != 5; ++i) {
+            auto stats = host_allocator_.stats(static_cast<VkSystemAllocationScope>(i));
+
+            cout << scope_names[i] << " : "
+                 << "live " << stats.live_bytes << " bytes, "
+                 << "peak " << stats.peak_bytes << " bytes, "
+                 << "allocations " << stats.allocation_count << ", "
+                 << "internal " << stats.internal_bytes << " bytes" << endl;
+        }
+    }
+
+    void dump_memory_report_()
+    {
+        auto report = memory_allocator_->report();
+
+        // 힙별로 사용중인 메모리와 사용하지 않는 메모리, 가장 큰 빈 공간을 출력합니다.
+        // 빈 공간이 충분한데도 할당에 실패한다면 조각화를 의심해야 합니다.
+        for (auto i = 0u; i != report.heaps.size(); ++i) {
+            auto& usage = report.heaps[i];
+
+            cout << i << " Memory Heap : "
+                 << "size " << report.heap_sizes[i] << " bytes, "
+                 << "blocks " << usage.block_count << ", "
+                 << "allocations " << usage.allocation_count << ", "
+                 << "used " << usage.used_bytes << " bytes, "
+                 << "unused " << usage.unused_bytes << " bytes, "
+                 << "largest free " << usage.largest_free_bytes << " bytes, "
+                 << "fragmentation " << usage.fragmentation << endl;
+        }
+
+        // 힙별로 버짓과 다른 프로세스를 포함한 사용량을 출력합니다.
+        auto budgets = memory_allocator_->budgets();
+
+        for (auto i = 0u; i != memory_allocator_->heap_count(); ++i) {
+            cout << i << " Memory Heap : "
+                 << "budget " << budgets[i].budget << " bytes, "
+                 << "usage " << budgets[i].usage << " bytes" << endl;
+        }
+
+        // 레지던시 매니저가 내보내고 돌아온 양을 출력합니다.
+        if (residency_manager_) {
+            auto stats = residency_manager_->stats();
+
+            cout << "Residency : "
+                 << "evicted " << stats.evicted_bytes << " bytes, "
+                 << "restored " << stats.restored_bytes << " bytes, "
+                 << "evictions " << stats.eviction_count << ", "
+                 << "restores " << stats.restore_count << endl;
+        }
+
+        // 모든 할당의 이름과 할당한 위치를 JSON 파일로 저장합니다.
+        ofstream fout {"memory_report.json"};
+
+        fout << memory_allocator_->dump_json();
+    }
+
+    void update_fragment_variant_()
+    {
+        // 이미 요청한 배리언트를 사용하고 있거나 컴파일에 실패했다면 교체할 필요가 없습니다.
+        if (fragment_exact_ || fragment_failed_)
+            return;
+
+        // 백그라운드 컴파일이 끝났는지 확인합니다.
+        auto variant = variant_manager_.variant(fragment_variant_id_);
+
+        // 컴파일에 실패했다면 에러를 출력하고 더 이상 확인하지 않고 폴백 배리언트를 계속 사용합니다.
+        if (!variant.error.empty()) {
+            Allocation_exemption allocation_exemption;
+
+            cout << variant.error << endl;
+            fragment_failed_ = true;
+            return;
+        }
+
+        if (!variant.exact)
+            return;
+
+        // 배리언트를 교체하는 동안은 셰이더 모듈과 파이프라인을 다시 생성하기 때문에 힙 메모리를 할당합니다.
+        Allocation_exemption allocation_exemption;
+
+        // 폴백 배리언트로 생성된 파이프라인이 사용중일 수 있기 때문에 모든 커맨드가 처리될 때까지 기다립니다.
+        // 제출 스레드가 큐를 사용하고 있다면 모든 프레임이 제출될 때까지 먼저 기다립니다.
+        if (submit_thread_)
+            submit_thread_->wait_idle();
+
+        device_table_.vkDeviceWaitIdle(device_);
+
+        // 폴백 배리언트로 생성된 셰이더 모듈과 파이프라인을 파괴합니다.
+        device_table_.vkDestroyShaderModule(device_, shader_modules_[1], host_allocator_.callbacks());
+        fini_pipeline_();
+
+        // 컴파일이 끝난 배리언트로 셰이더 모듈과 파이프라인을 다시 생성합니다.
+        init_fragment_shader_module_(*variant.spirv);
+        init_pipeline_();
+
+        fragment_exact_ = true;
+    }
+
     void on_render()
     {
-        // 현재 프레임에 해당하는 세마포어를 사용합니다.
-        auto& semaphores = semaphores_[frame_index_];
+        // 배리언트를 교체하거나 버퍼를 옮기는 경우를 제외하면 프레임 동안 힙 메모리를 할당하지 않아야 합니다.
+        // PLATFORM_COUNT_ALLOCATIONS 옵션으로 빌드하면 힙 메모리를 할당할 때 어서트가 발생합니다.
+        Allocation_guard allocation_guard;
 
-        // 스왑체인으로부터 사용가능한 이미지 인덱스를 얻어옵니다.
-        // 세마포어를 통해서 GPU에서 스왑체인 이미지가 언제 사용 가능한지 알 수 있습니다.
-        uint32_t swapchain_index;
-        auto result = vkAcquireNextImageKHR(device_, swapchain_, UINT64_MAX,
-                              semaphores[image_available_index], VK_NULL_HANDLE,
-                              &swapchain_index);
+        // 다음 프레임의 업데이트는 다른 스레드에서 실행되고 현재 프레임은 이 스레드에서 렌더링됩니다.
+        frame_loop_.run_frame();
+    }
 
-        auto& swapchain_image = swapchain_images_[swapchain_index];
+    void update_(const Frame_data& frame_data, Frame_data& next_frame_data, const Frame_clock& clock)
+    {
+        // 프레임 레이트와 상관없이 고정된 시간 간격으로 시뮬레이션을 진행합니다.
+        next_frame_data.time = frame_data.time + clock.step_count() * clock.time_step();
+
+        // 남은 시간의 비율로 마지막 두 스텝 사이의 시간을 보간합니다.
+        auto time = next_frame_data.time - (1.0 - clock.alpha()) * clock.time_step();
+
+        // 색상을 계산합니다.
+        // 시간을 이용해서 코사인 값을 계산합니다. 코사인의 결과는 [-1, 1] 범위의 값을 가지고 있습니다.
+        // 코사인 결과에 1.0을 더한 뒤 2.0을 나눠서 [0, 1]의 범위의 값으로 변경합니다.
+        auto value = static_cast<float>((cos(time * angular_speed) + 1.0) / 2.0);
+
+        next_frame_data.material = {value, value, value};
+    }
+
+    void render_(const Frame_data& frame_data)
+    {
+        // 배리언트가 준비됐다면 폴백 배리언트를 교체합니다.
+        update_fragment_variant_();
+
+        // 프레임 동안만 사용하는 메모리는 프레임이 시작할 때 한번에 해제합니다.
+        frame_arena_.reset();
+
+        // 현재 프레임에 해당하는 세마포어를 사용합니다.
+        auto& semaphores = semaphores_[frame_index_];
 
         // 현재 프레임에 해당하는 펜스를 사용합니다.
         auto& fence = fences_[frame_index_];
@@ -2255,49 +2531,41 @@ private:
         // 새로운 프레임을 렌더링하기 위해선 제출한 커맨드 버퍼가 처리되었는지를 확인해야합니다.
         // 다 처리되었는지를 알기 위해서 큐에 커맨드 버퍼를 제출할 때 파라미터로 펜스를 넘길 수 있습니다.
         // 커맨드 버퍼를 리셋하기 전에 펜스의 상태를 확인한 뒤 언시그널드 상태이면 시그널 상태가 될 때까지 기다립니다.
-        if (VK_NOT_READY == vkGetFenceStatus(device_, fence))
-            vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX);
+        // 제출 스레드를 사용하면 이전 프레임이 아직 제출되지 않았을 수 있기 때문에 이미지를 얻기 전에 기다립니다.
+        if (VK_NOT_READY == device_table_.vkGetFenceStatus(device_, fence))
+            device_table_.vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX);
 
         // 펜스를 언시그널 상태로 변경합니다.
-        vkResetFences(device_, 1, &fence);
-
-        // 현재 프레임에 해당하는 유니폼 버퍼와 메터리얼 디스크립터 셋을 사용합니다.
-        auto& uniform_buffer = uniform_buffers_[frame_index_];
-        auto& material_descriptor_set = material_descriptor_sets_[frame_index_];
-
-        {
-            // 디스크립터 셋이 가리킬 버퍼 정보를 정의합니다.
-            VkDescriptorBufferInfo buffer_info {};
-
-            buffer_info.buffer = uniform_buffer;
-            buffer_info.offset = 0;
-            buffer_info.range = sizeof(Material);
+        device_table_.vkResetFences(device_, 1, &fence);
 
-            // 디스크립터 셋이 어떤 리소스를 가리킬지 정의합니다.
-            VkWriteDescriptorSet descriptor_write {};
+        // 스왑체인으로부터 사용가능한 이미지 인덱스를 얻어옵니다.
+        // 세마포어를 통해서 GPU에서 스왑체인 이미지가 언제 사용 가능한지 알 수 있습니다.
+        // 스왑체인은 출력과 동기화되어야 하기 때문에 제출 스레드를 사용하면 제출 스레드를 통해서 얻어옵니다.
+        uint32_t swapchain_index;
+        auto result = submit_thread_ ?
+                      submit_thread_->acquire_next_image(device_, swapchain_,
+                                                         semaphores[image_available_index], &swapchain_index) :
+                      device_table_.vkAcquireNextImageKHR(device_, swapchain_, UINT64_MAX,
+                                                          semaphores[image_available_index], VK_NULL_HANDLE,
+                                                          &swapchain_index);
 
-            descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptor_write.dstSet = material_descriptor_set;
-            descriptor_write.dstBinding = 0;
-            descriptor_write.descriptorCount = 1;
-            descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptor_write.pBufferInfo = &buffer_info;
+        auto& swapchain_image = swapchain_images_[swapchain_index];
 
-            // 디스크립터 셋을 업데이트 합니다.
-            vkUpdateDescriptorSets(device_, 1, &descriptor_write, 0, nullptr);
-        }
+        // 업데이트할 디스크립터 셋들을 모아서 한번에 업데이트합니다.
+        // 프레임 동안만 사용하는 배열이기 때문에 프레임 아레나에서 할당합니다.
+        pmr::vector<VkWriteDescriptorSet> descriptor_writes {&frame_arena_};
 
         // 현재 프레임에 해당하는 텍스처 디스크립터 셋을 사용합니다.
         auto& texture_descriptor_set = texture_descriptor_sets_[frame_index_];
 
-        {
-            // 디스크립터 셋이 가리킬 컴바인드 이미지 샘플러 정보를 정의합니다.
-            VkDescriptorImageInfo image_info {};
+        // 디스크립터 셋이 가리킬 컴바인드 이미지 샘플러 정보를 정의합니다.
+        VkDescriptorImageInfo image_info {};
 
-            image_info.sampler = texture_sampler_;
-            image_info.imageView = texture_image_view_;
-            image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        image_info.sampler = texture_sampler_;
+        image_info.imageView = texture_image_view_;
+        image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
+        {
             // 디스크립터 셋이 어떤 리소스를 가리킬지 정의합니다.
             VkWriteDescriptorSet descriptor_write {};
 
@@ -2308,47 +2576,34 @@ private:
             descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
             descriptor_write.pImageInfo = &image_info;
 
-            // 디스크립터 셋을 업데이트 합니다.
-            vkUpdateDescriptorSets(device_, 1, &descriptor_write, 0, nullptr);
+            descriptor_writes.push_back(descriptor_write);
         }
 
-        // 현재 프레임에 해당하는 유니폼 메모리를 사용합니다.
-        auto& uniform_device_memory = uniform_device_memories_[frame_index_];
+        // 디스크립터 셋들을 업데이트 합니다.
+        device_table_.vkUpdateDescriptorSets(device_, static_cast<uint32_t>(descriptor_writes.size()),
+                                             descriptor_writes.data(),
+                                             0, nullptr);
 
-        // 매 프레임마다 디스크립터 셋이 업데이트됩니다. 그러나 동일한 유니폼 버퍼를 가리키기 때문에
+        // 매 프레임마다 디스크립터 셋이 업데이트됩니다. 그러나 동일한 이미지를 가리키기 때문에
         // 처음 한번만 업데이트하면 될 뿐 매 프레임마다 업데이트 할 필요는 없습니다.
         // 단지 벌칸을 보다 쉽게 이해하기 위해 매 프레임마다 업데이트 합니다.
 
-        // CPU에서 유니폼 버퍼 메모리에 접근하기 위한 버추얼 어드레스를 가져옵니다.
-        void* contents;
-        vkMapMemory(device_, uniform_device_memory, 0, sizeof(Material), 0, &contents);
-
-        // CPU에서 정의한 메터리얼 구조체로 캐스팅합니다.
-        auto material = static_cast<Material*>(contents);
-
-        // 흘러간 시간을 저장할 변수를 선언합니다.
-        static auto time = 0.0f;
-
-        // 색상을 계산합니다.
-        // 시간을 이용해서 코사인 값을 계산합니다. 코사인의 결과는 [-1, 1] 범위의 값을 가지고 있습니다.
-        // 코사인 결과에 1.0을 더한 뒤 2.0을 나눠서 [0, 1]의 범위의 값으로 변경합니다.
-        float value = (cos(time) + 1.0f) / 2.0f;
-
-        time += 0.05f;
+        // 현재 프레임의 영역을 처음부터 할당합니다. 펜스를 기다렸기 때문에 GPU는 이 영역을 더 이상 읽지 않습니다.
+        frame_ring_->begin_frame(frame_index_);
 
-        // 메터리얼 데이터를 업데이트 합니다.
-        material->r = value;
-        material->g = value;
-        material->b = value;
+        // 업데이트가 계산한 메터리얼 데이터를 프레임 링에 씁니다.
+        // 드로우마다 할당하면 각 드로우는 할당된 오프셋을 다이나믹 오프셋으로 사용합니다.
+        Ring_allocation material_allocation;
 
-        // CPU에서 메모리의 접근을 끝마칩니다.
-        vkUnmapMemory(device_, uniform_device_memory);
+        // 프레임 링이 가득 찼다면 메터리얼이 없기 때문에 드로우를 건너뛰고 렌더 패스는 화면만 지웁니다.
+        auto material_written = frame_ring_->write_uniform(&frame_data.material, sizeof(Material),
+                                                           &material_allocation);
 
         // 현재 프레임에 해당하는 커맨드 버퍼를 새용합니다.
         auto& command_buffer = command_buffers_[frame_index_];
 
         // 커맨드 버퍼를 재사용하기 위해서 커맨드 버퍼를 리셋합니다.
-        vkResetCommandBuffer(command_buffer, 0);
+        device_table_.vkResetCommandBuffer(command_buffer, 0);
         // 커맨드 버퍼에 기록하는 커맨드들은 변하지 않기 때문에 다시 기록할 필요는 없습니다.
         // 하지만 일반적인 경우에 매 프레임마다 필요한 커맨드들이 다르기 때문에 리셋하고 다시 기록합니다.
 
@@ -2359,7 +2614,18 @@ private:
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
         // 커맨드 버퍼를 기록중 상태로 전이합니다.
-        vkBeginCommandBuffer(command_buffer, &begin_info);
+        device_table_.vkBeginCommandBuffer(command_buffer, &begin_info);
+
+        // 조각 모음이 옮길 버퍼들의 복사를 기록합니다. 옮겨진 버퍼는 새로운 핸들로 바뀌기 때문에
+        // 버텍스 버퍼와 인덱스 버퍼를 바인드하기 전에 기록해야 합니다.
+        defragmenter_->record(command_buffer);
+
+        // 이번 프레임에 사용하는 리소스를 알려줍니다. 내보내진 리소스는 버짓에 여유가 있을 때 돌아옵니다.
+        residency_manager_->touch(vertex_resident_id_);
+
+        // 버짓을 넘은 힙의 리소스를 내보내거나 돌아오는 리소스의 복사를 기록합니다.
+        // 옮겨진 버퍼는 새로운 핸들로 바뀌기 때문에 버텍스 버퍼를 바인드하기 전에 기록해야 합니다.
+        residency_manager_->record(command_buffer);
 
         {
             // 이미지 배리어를 정의하기 위한 변수를 선언합니다.
@@ -2377,12 +2643,13 @@ private:
             barrier.subresourceRange.levelCount = 1;
             barrier.subresourceRange.layerCount = 1;
 
-            vkCmdPipelineBarrier(command_buffer,
-                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                 0,
-                                 0, nullptr,
-                                 0, nullptr,
-                                 1, &barrier);
+            device_table_.vkCmdPipelineBarrier(command_buffer,
+                                               VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                               0,
+                                               0, nullptr,
+                                               0, nullptr,
+                                               1, &barrier);
         }
 
         // 클리어 색상을 정의하기 위한 변수를 선언합니다.
@@ -2405,31 +2672,33 @@ private:
         render_pass_begin_info.pClearValues = &clear_value;
 
         // 렌더 패스를 시작합니다.
-        vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+        device_table_.vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
-        // 삼각형을 그리기 위해 필요한 버텍스 버퍼를 0번에 바인드 합니다.
-        VkDeviceSize vertex_buffer_offset {0};
-        vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer_, &vertex_buffer_offset);
+        if (material_written) {
+            // 삼각형을 그리기 위해 필요한 버텍스 버퍼를 0번에 바인드 합니다.
+            VkDeviceSize vertex_buffer_offset {0};
+            device_table_.vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer_, &vertex_buffer_offset);
 
-        // 인덱스 버퍼를 바인드 합니다.
-        vkCmdBindIndexBuffer(command_buffer, index_buffer_, 0, VK_INDEX_TYPE_UINT16);
+            // 인덱스 버퍼를 바인드 합니다.
+            device_table_.vkCmdBindIndexBuffer(command_buffer, index_buffer_, 0, VK_INDEX_TYPE_UINT16);
 
-        // 삼각형을 그리기 위한 그래픽스 파이프라인을 바인딩합니다.
-        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+            // 삼각형을 그리기 위한 그래픽스 파이프라인을 바인딩합니다.
+            device_table_.vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
 
-        // 디스크립터 셋을 바인드합니다.
-        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                pipeline_layout_, 0, 1, &material_descriptor_set,
-                                0, nullptr);
-        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                pipeline_layout_, 1, 1, &texture_descriptor_set,
-                                0, nullptr);
+            // 디스크립터 셋을 바인드합니다. 메터리얼은 프레임 링에 할당된 오프셋을 다이나믹 오프셋으로 지정합니다.
+            device_table_.vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                  pipeline_layout_, 0, 1, &material_descriptor_set_,
+                                                  1, &material_allocation.offset);
+            device_table_.vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                  pipeline_layout_, 1, 1, &texture_descriptor_set,
+                                                  0, nullptr);
 
-        // 인덱스 버퍼를 이용한 드로우 커맨드를 기록합니다.
-        vkCmdDrawIndexed(command_buffer, 3, 1, 0, 0, 0);
+            // 인덱스 버퍼를 이용한 드로우 커맨드를 기록합니다.
+            device_table_.vkCmdDrawIndexed(command_buffer, 3, 1, 0, 0, 0);
+        }
 
         // 렌더 패스를 종료합니다.
-        vkCmdEndRenderPass(command_buffer);
+        device_table_.vkCmdEndRenderPass(command_buffer);
 
         {
             // 이미지 배리어를 정의하기 위한 변수를 선언합니다.
@@ -2450,21 +2719,47 @@ private:
             barrier.subresourceRange.layerCount = 1;
 
             // 이미지 레이아웃 변경을 위한 파이프라인 배리어 커맨드를 기록합니다.
-            vkCmdPipelineBarrier(command_buffer,
-                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                                 0,
-                                 0, nullptr,
-                                 0, nullptr,
-                                 1, &barrier);
+            device_table_.vkCmdPipelineBarrier(command_buffer,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                               VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                               0,
+                                               0, nullptr,
+                                               0, nullptr,
+                                               1, &barrier);
         }
 
         // 필요한 모든 커맨드들을 기록했기 때문에 커맨드 버퍼의 커맨드 기록을 끝마칩니다.
         // 커맨드 버퍼의 상태는 실행 가능 상태입니다.
-        vkEndCommandBuffer(command_buffer);
+        device_table_.vkEndCommandBuffer(command_buffer);
+
+        // 제출하기 전에 이번 프레임에 CPU에서 쓴 영역들을 한번에 플러시합니다.
+        // 프레임 링은 이번 프레임에 할당된 영역을 한 개의 영역으로 기록합니다.
+        frame_ring_->end_frame();
+        flush_batch_->flush();
 
         // 세마포어가 반드시 시그널 되야하는 파이프라인 스테이지를 정의합니다.
         constexpr VkPipelineStageFlags wait_dst_stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 
+        // 제출 스레드를 사용하면 제출과 출력을 제출 스레드에 맡기고 바로 다음 프레임을 시작합니다.
+        // 드라이버의 제출과 출력이 오래 걸리더라도 이 스레드는 기다리지 않습니다.
+        if (submit_thread_) {
+            Vlk::Submit_frame submit_frame;
+
+            submit_frame.command_buffer = command_buffer;
+            submit_frame.wait_semaphore = semaphores[image_available_index];
+            submit_frame.wait_stage_mask = wait_dst_stage_mask;
+            submit_frame.signal_semaphore = semaphores[rendering_done_index];
+            submit_frame.fence = fence;
+            submit_frame.swapchain = swapchain_;
+            submit_frame.swapchain_index = swapchain_index;
+
+            submit_thread_->push(submit_frame);
+
+            // 다음 프레임에 해당하는 리소스를 참조하기 위해 프레임 인덱스를 1만큼 증가시킵니다.
+            frame_index_ = ++frame_index_ % swapchain_image_count;
+            return;
+        }
+
         // 큐에 제출할 커맨드 버퍼와 동기화를 정의하기 위한 변수를 선언합니다.
         VkSubmitInfo submit_info {};
 
@@ -2482,7 +2777,7 @@ private:
         submit_info.pSignalSemaphores = &semaphores[rendering_done_index];
 
         // 큐에 커맨드 버퍼를 제출합니다.
-        vkQueueSubmit(queue_, 1, &submit_info, fence);
+        device_table_.vkQueueSubmit(queue_, 1, &submit_info, fence);
 
         // 화면에 출력되는 이미지를 정의합니다.
         VkPresentInfoKHR present_info {};
@@ -2497,19 +2792,31 @@ private:
         present_info.pImageIndices = &swapchain_index;
 
         // 화면에 이미지를 출력합니다.
-        vkQueuePresentKHR(queue_, &present_info);
+        device_table_.vkQueuePresentKHR(queue_, &present_info);
 
         // 다음 프레임에 해당하는 리소스를 참조하기 위해 프레임 인덱스를 1만큼 증가시킵니다.
         frame_index_ = ++frame_index_ % swapchain_image_count;
     }
 
 private:
+    Host_allocator host_allocator_;
     Window* window_;
     VkInstance instance_;
+    Instance_table instance_table_;
     VkPhysicalDevice physical_device_;
     VkPhysicalDeviceMemoryProperties physical_device_memory_properties_;
     uint32_t queue_family_index_;
     VkDevice device_;
+    Device_table device_table_;
+    bool physical_device_properties2_;
+    bool external_memory_capabilities_;
+    bool memory_budget_;
+    bool external_memory_host_;
+    unique_ptr<Memory_allocator> memory_allocator_;
+    unique_ptr<Defragmenter> defragmenter_;
+    unique_ptr<Residency_manager> residency_manager_;
+    unique_ptr<Host_importer> host_importer_;
+    unique_ptr<Flush_batch> flush_batch_;
     VkQueue queue_;
     VkCommandPool command_pool_;
     uint32_t frame_index_;
@@ -2517,13 +2824,13 @@ private:
     array<VkFence, swapchain_image_count> fences_;
     array<array<VkSemaphore, 2>, swapchain_image_count> semaphores_;
     VkBuffer vertex_buffer_;
-    VkDeviceMemory vertex_device_memory_;
+    VmaAllocation vertex_device_memory_;
+    Resident_id vertex_resident_id_;
     VkBuffer index_buffer_;
-    VkDeviceMemory index_device_memory_;
-    array<VkBuffer, swapchain_image_count> uniform_buffers_;
-    array<VkDeviceMemory, swapchain_image_count> uniform_device_memories_;
+    VmaAllocation index_device_memory_;
+    unique_ptr<Frame_ring> frame_ring_;
     VkImage texture_image_;
-    VkDeviceMemory texture_device_memory_;
+    VmaAllocation texture_device_memory_;
     VkImageView texture_image_view_;
     VkSampler texture_sampler_;
     VkSurfaceKHR surface_;
@@ -2539,8 +2846,17 @@ private:
     VkPipelineLayout pipeline_layout_;
     VkPipeline pipeline_;
     VkDescriptorPool descriptor_pool_;
-    array<VkDescriptorSet, swapchain_image_count> material_descriptor_sets_;
+    VkDescriptorSet material_descriptor_set_;
     array<VkDescriptorSet, swapchain_image_count> texture_descriptor_sets_;
+    Variant_manager variant_manager_;
+    Preamble fragment_preamble_;
+    Variant_id fragment_variant_id_;
+    bool fragment_exact_;
+    bool fragment_failed_;
+    unique_ptr<Vlk::Submit_thread> submit_thread_;
+    Job_system job_system_;
+    Frame_loop<Frame_data> frame_loop_;
+    Frame_arena frame_arena_;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2552,12 +2868,30 @@ int main(int argc, char* argv[])
     window_desc.title = L"Chapter15"s;
     window_desc.extent = {512, 512, 1};
 
+#if defined(__linux__)
+    // 헤드리스 윈도우는 기본적으로 5초 동안 실행됩니다.
+    // HEADLESS_FRAME_COUNT, HEADLESS_TIME_BUDGET, HEADLESS_FRAME_RATE 환경 변수로 바꿀 수 있습니다.
+    window_desc.time_budget = 5.0;
+    override_by_env(window_desc);
+#endif
+
     Window window {window_desc};
 
     Chapter15 chapter15 {&window};
 
     window.run();
 
+#if defined(__linux__)
+    // 헤드리스 윈도우에서 측정된 프레임 처리량을 출력합니다.
+    cout << window.frame_count() << " frames";
+
+    // 측정된 시간이 없다면 처리량을 계산할 수 없습니다.
+    if (window.elapsed_time() > 0.0)
+        cout << ", " << window.frame_count() / window.elapsed_time() << " fps";
+
+    cout << endl;
+#endif
+
     return 0;
 }
 
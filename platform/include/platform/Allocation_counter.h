@@ -0,0 +1,72 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_ALLOCATION_COUNTER_GUARD
+#define PLATFORM_ALLOCATION_COUNTER_GUARD
+
+#include <cassert>
+#include <cstdint>
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the allocations of the global operator new on the calling thread.
+// they are counted only when the platform is built with PLATFORM_COUNT_ALLOCATIONS, otherwise it is always zero.
+uint64_t allocation_count() noexcept;
+
+// the allocations between these aren't counted, they nest.
+void suspend_allocation_count() noexcept;
+
+void resume_allocation_count() noexcept;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// asserts that the calling thread doesn't allocate from the heap in its scope.
+class Allocation_guard final {
+public:
+    Allocation_guard() noexcept :
+        count_ {allocation_count()}
+    {
+    }
+
+    Allocation_guard(const Allocation_guard&) = delete;
+
+    ~Allocation_guard()
+    {
+        assert(allocation_count() == count_);
+    }
+
+    Allocation_guard& operator=(const Allocation_guard&) = delete;
+
+private:
+    uint64_t count_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// exempts a rare path which must allocate, e.g. moving a buffer, from the Allocation_guard of the calling thread.
+class Allocation_exemption final {
+public:
+    Allocation_exemption() noexcept
+    {
+        suspend_allocation_count();
+    }
+
+    Allocation_exemption(const Allocation_exemption&) = delete;
+
+    ~Allocation_exemption()
+    {
+        resume_allocation_count();
+    }
+
+    Allocation_exemption& operator=(const Allocation_exemption&) = delete;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_ALLOCATION_COUNTER_GUARD
@@ -0,0 +1,44 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_CPU_TOPOLOGY_GUARD
+#define PLATFORM_CPU_TOPOLOGY_GUARD
+
+#include <cstdint>
+#include <vector>
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+enum class Core_type : uint8_t {
+    any = 0, performance, efficiency
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Cpu {
+    uint32_t index;
+    uint32_t core;  // logical CPUs which share a core are SMT siblings
+    Core_type type;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// CPUs whose maximum frequency is lower than the fastest are efficiency cores.
+// only the CPUs which the process may run on are listed, so the indices may have holes.
+// every CPU is a performance core on its own core when the topology is unknown.
+std::vector<Cpu> cpu_topology();
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// pins the calling thread to a logical CPU, it returns false when the platform doesn't support it.
+bool set_thread_affinity(uint32_t cpu) noexcept;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_CPU_TOPOLOGY_GUARD
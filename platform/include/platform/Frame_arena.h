@@ -0,0 +1,75 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_FRAME_ARENA_GUARD
+#define PLATFORM_FRAME_ARENA_GUARD
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a linear allocator for memory which lives for a frame, deallocations are ignored and reset frees everything.
+// memory over the capacity comes from the upstream and the next reset grows the arena to fit the whole frame,
+// so steady frames don't allocate from the upstream.
+class Frame_arena final : public std::pmr::memory_resource {
+public:
+    explicit Frame_arena(size_t capacity = 64 * 1024,
+                         std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    Frame_arena(const Frame_arena&) = delete;
+
+    ~Frame_arena() override;
+
+    Frame_arena& operator=(const Frame_arena&) = delete;
+
+    void reset();
+
+    inline auto used() const noexcept
+    { return offset_ + overflow_size_; }
+
+    inline auto capacity() const noexcept
+    { return capacity_; }
+
+    // the allocations from the upstream since the last reset.
+    inline auto overflow_count() const noexcept
+    { return overflows_.size(); }
+
+private:
+    struct Overflow_ {
+        void* pointer;
+        size_t size;
+        size_t alignment;
+    };
+
+    void* do_allocate(size_t size, size_t alignment) override;
+
+    void do_deallocate(void* pointer, size_t size, size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    void init_buffer_(size_t capacity);
+
+    void term_buffer_() noexcept;
+
+    void term_overflows_() noexcept;
+
+private:
+    std::pmr::memory_resource* upstream_;
+    std::byte* buffer_;
+    size_t capacity_;
+    size_t offset_;
+    size_t overflow_size_;
+    std::vector<Overflow_> overflows_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_FRAME_ARENA_GUARD
@@ -0,0 +1,62 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_FRAME_CLOCK_GUARD
+#define PLATFORM_FRAME_CLOCK_GUARD
+
+#include <chrono>
+#include <cstdint>
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a clock for a simulation with a fixed time step.
+// each tick accumulates the time of a frame and consumes it in fixed steps, the rest is left as the alpha
+// to interpolate between the last two steps. a long frame is clamped so the simulation can catch up.
+class Frame_clock final {
+public:
+    explicit Frame_clock(double time_step = 1.0 / 60.0, double max_frame_time = 0.25);
+
+    // measures the time since the last tick and returns the number of steps to simulate.
+    uint32_t tick();
+
+    uint32_t advance(double frame_time);
+
+    void reset();
+
+    inline auto time_step() const noexcept
+    { return time_step_; }
+
+    inline auto frame_time() const noexcept
+    { return frame_time_; }
+
+    inline auto step_count() const noexcept
+    { return step_count_; }
+
+    inline auto time() const noexcept
+    { return time_; }
+
+    inline auto alpha() const noexcept
+    { return accumulator_ / time_step_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    double time_step_;
+    double max_frame_time_;
+    Clock::time_point last_time_;
+    double frame_time_;
+    double accumulator_;
+    double time_;
+    uint32_t step_count_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_FRAME_CLOCK_GUARD
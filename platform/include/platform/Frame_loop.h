@@ -0,0 +1,89 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_FRAME_LOOP_GUARD
+#define PLATFORM_FRAME_LOOP_GUARD
+
+#include <array>
+#include <functional>
+#include "platform/Frame_clock.h"
+#include "platform/Job_system.h"
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// overlaps the update of the next frame with the rendering of the current frame.
+// the update of frame N + 1 runs as a job while frame N is rendered on the calling thread,
+// the frames have their own frame data so the update and the rendering never share it.
+template<typename Frame_data>
+class Frame_loop final {
+public:
+    using Update = std::function<void(const Frame_data&, Frame_data&, const Frame_clock&)>;
+    using Render = std::function<void(const Frame_data&)>;
+
+    Frame_loop(Job_system& job_system, Update update, Render render, double time_step = 1.0 / 60.0) :
+        job_system_ {job_system},
+        update_ {std::move(update)},
+        render_ {std::move(render)},
+        clock_ {time_step},
+        frames_ {},
+        frame_index_ {0},
+        counter_ {},
+        started_ {false}
+    {
+    }
+
+    Frame_loop(const Frame_loop&) = delete;
+
+    Frame_loop& operator=(const Frame_loop&) = delete;
+
+    ~Frame_loop()
+    {
+        job_system_.wait(counter_);
+    }
+
+    void run_frame()
+    {
+        auto& frame = frames_[frame_index_];
+        auto& next_frame = frames_[frame_index_ ^ 1];
+
+        // the first frame has no update in flight, so it is updated in place.
+        if (started_) {
+            job_system_.wait(counter_);
+        }
+        else {
+            clock_.tick();
+            update_(next_frame, frame, clock_);
+            started_ = true;
+        }
+
+        // the clock isn't ticked again until the update finishes, so the update can read it.
+        clock_.tick();
+        job_system_.schedule([this, &frame, &next_frame]() { update_(frame, next_frame, clock_); }, &counter_);
+
+        render_(frame);
+        frame_index_ ^= 1;
+    }
+
+    inline const auto& clock() const noexcept
+    { return clock_; }
+
+private:
+    Job_system& job_system_;
+    Update update_;
+    Render render_;
+    Frame_clock clock_;
+    std::array<Frame_data, 2> frames_;
+    uint32_t frame_index_;
+    Job_counter counter_;
+    bool started_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_FRAME_LOOP_GUARD
@@ -0,0 +1,117 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_IO_SERVICE_GUARD
+#define PLATFORM_IO_SERVICE_GUARD
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <ghc/filesystem.hpp>
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace fs = ghc::filesystem;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+enum class Io_backend {
+    io_uring, thread_pool
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// io_uring is used on Linux when the kernel allows it, otherwise reads are done by a pool of threads.
+struct Io_service_desc {
+    uint32_t queue_depth {256};
+    uint32_t thread_count {4};
+    bool use_io_uring {true};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the buffer may be any memory such as a mapped staging buffer, it must stay valid until the read completes.
+struct Io_read_desc {
+    fs::path path;
+    void* buffer {nullptr};
+    size_t size {0};
+    uint64_t offset {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// called on a thread of the service with the read size, which is less than the requested one at the end of a file.
+using Io_callback = std::function<void(size_t, std::error_code)>;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// reads which are requested while others are in flight are submitted together.
+class Io_service final {
+public:
+    Io_service();
+
+    explicit Io_service(const Io_service_desc& desc);
+
+    Io_service(const Io_service&) = delete;
+
+    ~Io_service();
+
+    Io_service& operator=(const Io_service&) = delete;
+
+    void read(const Io_read_desc& desc, Io_callback callback);
+
+    // the future throws a system_error when the read fails.
+    std::future<size_t> read(const Io_read_desc& desc);
+
+    // waits until every requested read completes.
+    void wait();
+
+    inline auto backend() const noexcept
+    { return backend_; }
+
+private:
+    struct Request_;
+
+    class Io_uring_;
+
+    void init_io_uring_(const Io_service_desc& desc);
+
+    void init_thread_pool_(const Io_service_desc& desc);
+
+    void term_threads_();
+
+    void run_io_uring_();
+
+    void run_worker_();
+
+    void complete_(std::unique_ptr<Request_> request, std::error_code error);
+
+private:
+    Io_backend backend_;
+    std::unique_ptr<Io_uring_> ring_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    std::deque<std::unique_ptr<Request_>> pending_;
+    uint64_t outstanding_;
+    bool running_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_IO_SERVICE_GUARD
@@ -0,0 +1,276 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_JOB_SYSTEM_GUARD
+#define PLATFORM_JOB_SYSTEM_GUARD
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Cpu_topology.h"
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Job_;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a callable which is stored in place, so scheduling a job doesn't allocate.
+// a lambda which captures a few pointers fits, a larger one fails to compile.
+class Job_function final {
+public:
+    static constexpr size_t capacity {48};
+
+    Job_function() noexcept = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Job_function>>>
+    Job_function(F&& function)
+    {
+        using T = std::decay_t<F>;
+
+        static_assert(sizeof(T) <= capacity, "a job function must fit in place.");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "a job function must fit in place.");
+
+        new (storage_) T(std::forward<F>(function));
+        ops_ = &ops_of_<T>;
+    }
+
+    Job_function(const Job_function& other)
+    {
+        if (other.ops_)
+            other.ops_->copy(storage_, other.storage_);
+
+        ops_ = other.ops_;
+    }
+
+    ~Job_function()
+    {
+        reset();
+    }
+
+    Job_function& operator=(const Job_function& other)
+    {
+        if (this != &other) {
+            reset();
+
+            if (other.ops_)
+                other.ops_->copy(storage_, other.storage_);
+
+            ops_ = other.ops_;
+        }
+
+        return *this;
+    }
+
+    void operator()()
+    { ops_->invoke(storage_); }
+
+    explicit operator bool() const noexcept
+    { return ops_; }
+
+    void reset() noexcept
+    {
+        if (ops_)
+            ops_->destroy(storage_);
+
+        ops_ = nullptr;
+    }
+
+private:
+    struct Ops_ {
+        void (*invoke)(void*);
+        void (*copy)(void*, const void*);
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<typename T>
+    static void invoke_(void* storage)
+    { (*static_cast<T*>(storage))(); }
+
+    template<typename T>
+    static void copy_(void* storage, const void* other)
+    { new (storage) T(*static_cast<const T*>(other)); }
+
+    template<typename T>
+    static void destroy_(void* storage) noexcept
+    { static_cast<T*>(storage)->~T(); }
+
+    template<typename T>
+    static inline const Ops_ ops_of_ {&invoke_<T>, &copy_<T>, &destroy_<T>};
+
+    alignas(std::max_align_t) unsigned char storage_[capacity];
+    const Ops_* ops_ {nullptr};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// counts the unfinished jobs which were scheduled with it, jobs may depend on a counter reaching zero.
+// a counter must outlive its jobs, so destroy it after Job_system::wait returns.
+class Job_counter final {
+public:
+    Job_counter() = default;
+
+    Job_counter(const Job_counter&) = delete;
+
+    Job_counter& operator=(const Job_counter&) = delete;
+
+    inline auto done() const noexcept
+    { return !count_.load(std::memory_order_acquire); }
+
+    inline auto count() const noexcept
+    { return count_.load(std::memory_order_acquire); }
+
+private:
+    friend class Job_system;
+
+    std::atomic<uint32_t> count_ {0};
+    mutable std::mutex mutex_;
+    std::vector<Job_*> dependents_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// jobs must not throw.
+struct Job_desc {
+    Job_function function;
+    Job_counter* counter {nullptr};
+    Job_counter* dependency {nullptr};
+    Core_type core_type {Core_type::any};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a thread count of zero creates a worker per core, SMT siblings get workers only when use_smt is set.
+// jobs come from a pool of job_capacity jobs, only the jobs beyond it are allocated.
+struct Job_system_desc {
+    uint32_t thread_count {0};
+    bool use_smt {false};
+    bool pin_threads {false};
+    uint32_t job_capacity {4096};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Job_system final {
+public:
+    Job_system();
+
+    explicit Job_system(const Job_system_desc& desc);
+
+    ~Job_system();
+
+    void schedule(const Job_desc& desc);
+
+    void schedule(Job_function function, Job_counter* counter = nullptr);
+
+    // runs other jobs on the calling thread until the counter reaches zero.
+    void wait(const Job_counter& counter);
+
+    inline auto thread_count() const noexcept
+    { return static_cast<uint32_t>(workers_.size()); }
+
+private:
+    // a Chase-Lev deque, the owner pushes and pops at the bottom and thieves steal from the top.
+    class Deque_ final {
+    public:
+        Deque_();
+
+        bool push(Job_* job) noexcept;
+
+        Job_* pop() noexcept;
+
+        Job_* steal() noexcept;
+
+    private:
+        static constexpr int64_t capacity_ {4096};
+
+        std::atomic<int64_t> top_;
+        std::atomic<int64_t> bottom_;
+        std::unique_ptr<std::atomic<Job_*>[]> jobs_;
+    };
+
+    // a shared queue for jobs from threads which aren't workers and for jobs with a core type.
+    // it is a ring which only grows when it is full, so pushes don't allocate once it holds the pool.
+    class Queue_ final {
+    public:
+        void reserve(size_t capacity);
+
+        void push(Job_* job);
+
+        Job_* pop();
+
+    private:
+        void grow_(size_t capacity);
+
+    private:
+        std::mutex mutex_;
+        std::vector<Job_*> jobs_;
+        size_t head_ {0};
+        size_t count_ {0};
+    };
+
+    struct Worker_ {
+        Deque_ deque;
+        Core_type core_type {Core_type::any};
+        int32_t cpu {-1};
+        std::thread thread;
+    };
+
+    void init_jobs_(const Job_system_desc& desc);
+
+    void init_workers_(const Job_system_desc& desc);
+
+    void term_workers_();
+
+    void run_worker_(uint32_t index);
+
+    void enqueue_(Job_* job);
+
+    [[nodiscard]]
+    Job_* dequeue_(Worker_* worker, bool any_core_type = false) noexcept;
+
+    [[nodiscard]]
+    Job_* allocate_job_();
+
+    void free_job_(Job_* job) noexcept;
+
+    void execute_(Job_* job);
+
+    void wake_(bool all);
+
+    [[nodiscard]]
+    Worker_* current_worker_() const noexcept;
+
+private:
+    std::unique_ptr<Job_[]> jobs_;
+    std::vector<Job_*> free_jobs_;
+    std::mutex jobs_mutex_;
+    std::vector<std::unique_ptr<Worker_>> workers_;
+    Queue_ queues_[3];
+    bool core_types_[3];
+    std::atomic<int64_t> pending_;
+    // counts the enqueued jobs, sleeping workers wake when it changes.
+    std::atomic<uint64_t> epoch_;
+    std::atomic<uint32_t> sleeping_;
+    std::atomic<bool> running_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_JOB_SYSTEM_GUARD
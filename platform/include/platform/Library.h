@@ -8,7 +8,7 @@
 
 #include "build_target.h"
 
-#if TARGET_OS_OSX || defined(__ANDROID__)
+#if TARGET_OS_OSX || defined(__ANDROID__) || defined(__linux__)
 #include "posix/Posix_library.h"
 #elif defined(_WIN32)
 #include "windows/Windows_library.h"
@@ -18,7 +18,7 @@ namespace Platform {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-#if TARGET_OS_OSX || defined(__ANDROID__)
+#if TARGET_OS_OSX || defined(__ANDROID__) || defined(__linux__)
 using Library = Posix_library;
 #elif defined(_WIN32)
 using Library = Windows_library;
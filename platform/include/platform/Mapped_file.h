@@ -0,0 +1,31 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_MAPPED_FILE_GUARD
+#define PLATFORM_MAPPED_FILE_GUARD
+
+#include "build_target.h"
+
+#if TARGET_OS_OSX || defined(__ANDROID__) || defined(__linux__)
+#include "posix/Posix_mapped_file.h"
+#elif defined(_WIN32)
+#include "windows/Windows_mapped_file.h"
+#endif
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if TARGET_OS_OSX || defined(__ANDROID__) || defined(__linux__)
+using Mapped_file = Posix_mapped_file;
+#elif defined(_WIN32)
+using Mapped_file = Windows_mapped_file;
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_MAPPED_FILE_GUARD
@@ -0,0 +1,83 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_RENDER_THREAD_GUARD
+#define PLATFORM_RENDER_THREAD_GUARD
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "platform/enums.h"
+#include "platform/Extent.h"
+#include "platform/Spsc_queue.h"
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+enum class Event_type : uint8_t {
+    resize, key_down, key_up
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Event {
+    Event_type type {Event_type::resize};
+    Extent extent {0, 0, 1};
+    Key key {Key::one};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// renders frames on its own thread, so slow events of the event loop don't stall frames.
+// the thread of the event loop posts events and they are dispatched at the start of the next frame.
+// every event goes through the same queue, so events are dispatched in the order they are posted.
+// resizes which follow each other are coalesced, so a frame dispatches only the latest one of them.
+class Render_thread final {
+public:
+    using Dispatch = std::function<void(const Event&)>;
+    using Frame = std::function<bool()>;
+
+    // a frame returns false to stop the thread.
+    Render_thread(Dispatch dispatch, Frame frame);
+
+    ~Render_thread();
+
+    void start();
+
+    void stop();
+
+    // waits until a frame stops the thread.
+    void wait();
+
+    // posts from the thread of the event loop or the render thread, events which the render thread posts to itself
+    // are dispatched at the start of the next frame too.
+    void post(const Event& event);
+
+    inline auto running() const noexcept
+    { return running_.load(std::memory_order_acquire); }
+
+private:
+    void run_();
+
+    void dispatch_events_();
+
+private:
+    Dispatch dispatch_;
+    Frame frame_;
+    // the event loop is the only producer of the queue.
+    Spsc_queue<Event, 256> events_;
+    // only the render thread touches the events which it posts to itself.
+    std::vector<Event> deferred_events_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_RENDER_THREAD_GUARD
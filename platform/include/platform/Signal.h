@@ -0,0 +1,127 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_SIGNAL_GUARD
+#define PLATFORM_SIGNAL_GUARD
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename Signature>
+class Signal;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a signal for a single thread, so emitting neither locks nor copies the slots.
+// slots which are connected or disconnected while the signal is emitted take effect from the next emission.
+template<typename... Args>
+class Signal<void(Args...)> final {
+public:
+    using Connection = uint64_t;
+
+    Signal() = default;
+
+    Signal(const Signal&) = delete;
+
+    Signal& operator=(const Signal&) = delete;
+
+    template<typename Function>
+    Connection connect(Function function)
+    {
+        auto storage = std::make_shared<Function>(std::move(function));
+        auto object = storage.get();
+        auto call = [](void* object, Args... args) { (*static_cast<Function*>(object))(args...); };
+
+        return connect_(object, call, std::move(storage));
+    }
+
+    template<typename Instance, typename Member>
+    Connection connect(Instance* instance, Member Instance::* member)
+    {
+        return connect([instance, member](Args... args) { (instance->*member)(args...); });
+    }
+
+    void disconnect(Connection connection)
+    {
+        auto& slots = modifiable_slots_();
+
+        slots.erase(std::remove_if(slots.begin(), slots.end(),
+                                   [connection](const Slot_& slot) { return slot.connection == connection; }),
+                    slots.end());
+    }
+
+    void clear()
+    {
+        modifiable_slots_().clear();
+    }
+
+    inline auto size() const noexcept
+    { return slots_->size(); }
+
+    inline auto empty() const noexcept
+    { return slots_->empty(); }
+
+    void operator()(Args... args)
+    {
+        // slots are replaced instead of modified while they are emitted, the old ones are retired after.
+        auto& slots = *slots_;
+
+        ++emit_depth_;
+
+        for (auto& slot : slots)
+            slot.call(slot.object, args...);
+
+        if (!--emit_depth_)
+            retired_slots_.clear();
+    }
+
+private:
+    using Call_ = void (*)(void*, Args...);
+
+    struct Slot_ {
+        Connection connection;
+        void* object;
+        Call_ call;
+        std::shared_ptr<void> storage;
+    };
+
+    Connection connect_(void* object, Call_ call, std::shared_ptr<void> storage)
+    {
+        modifiable_slots_().push_back({++last_connection_, object, call, std::move(storage)});
+
+        return last_connection_;
+    }
+
+    std::vector<Slot_>& modifiable_slots_()
+    {
+        if (emit_depth_) {
+            auto slots = std::make_unique<std::vector<Slot_>>(*slots_);
+
+            retired_slots_.push_back(std::move(slots_));
+            slots_ = std::move(slots);
+        }
+
+        return *slots_;
+    }
+
+private:
+    std::unique_ptr<std::vector<Slot_>> slots_ {std::make_unique<std::vector<Slot_>>()};
+    std::vector<std::unique_ptr<std::vector<Slot_>>> retired_slots_;
+    uint32_t emit_depth_ {0};
+    Connection last_connection_ {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_SIGNAL_GUARD
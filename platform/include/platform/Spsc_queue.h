@@ -0,0 +1,69 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_SPSC_QUEUE_GUARD
+#define PLATFORM_SPSC_QUEUE_GUARD
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a lock-free ring buffer for a single producer thread and a single consumer thread.
+template<typename T, size_t Capacity>
+class Spsc_queue final {
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "Capacity must be a power of two.");
+
+public:
+    Spsc_queue() = default;
+
+    Spsc_queue(const Spsc_queue&) = delete;
+
+    Spsc_queue& operator=(const Spsc_queue&) = delete;
+
+    bool push(const T& item) noexcept
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        items_[tail & (Capacity - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool pop(T& item) noexcept
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+
+        item = items_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    inline auto empty() const noexcept
+    { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+private:
+    // the indices are on separate cache lines so the threads don't share them.
+    alignas(64) std::atomic<size_t> head_ {0};
+    alignas(64) std::atomic<size_t> tail_ {0};
+    std::array<T, Capacity> items_ {};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_SPSC_QUEUE_GUARD
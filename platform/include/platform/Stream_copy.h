@@ -0,0 +1,49 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_STREAM_COPY_GUARD
+#define PLATFORM_STREAM_COPY_GUARD
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+enum class Copy_kernel : uint8_t {
+    memcpy, sse2, avx2, neon
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// copies from this size use non-temporal stores, smaller copies stay in the cache anyway.
+constexpr size_t stream_copy_threshold {256 * 1024};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the widest kernel with non-temporal stores which the CPU supports, memcpy when there is none.
+Copy_kernel stream_copy_kernel() noexcept;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// copies to memory which the CPU writes but doesn't read back, e.g. memory of the GPU which is mapped.
+// large copies to write-combined memory bypass the cache, so they neither evict the working set nor read the
+// destination before writing it. cached memory is copied with memcpy, the destination may be read again.
+// the stores are fenced, so they are visible before the memory is flushed or the queue is submitted.
+void stream_copy(void* dst, const void* src, size_t size, bool write_combined) noexcept;
+
+// copies with the given kernel regardless of the size, the kernel must be supported by the CPU.
+void stream_copy(void* dst, const void* src, size_t size, Copy_kernel kernel) noexcept;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const char* to_string(Copy_kernel kernel) noexcept;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_STREAM_COPY_GUARD
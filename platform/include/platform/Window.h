@@ -16,6 +16,8 @@
 #include "android/Android_window.h"
 #elif defined(_WIN32)
 #include "windows/Windows_window.h"
+#elif defined(__linux__)
+#include "linux/Headless_window.h"
 #endif
 
 namespace Platform {
@@ -34,6 +36,9 @@ using Window = Android_window;
 #elif  defined(_WIN32)
 using Window_desc = Windows_window_desc;
 using Window = Windows_window;
+#elif defined(__linux__)
+using Window_desc = Headless_window_desc;
+using Window = Headless_window;
 #endif
 
 //----------------------------------------------------------------------------------------------------------------------
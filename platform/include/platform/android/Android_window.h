@@ -7,19 +7,14 @@
 #define PLATFORM_ANDROID_WINDOW_GUARD
 
 #include <android_native_app_glue.h>
-#include <sigs.h>
 #include "platform/enums.h"
 #include "platform/Extent.h"
+#include "platform/Signal.h"
 
 namespace Platform {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-template<typename Signature>
-using Signal = sigs::Signal<Signature>;
-
-//----------------------------------------------------------------------------------------------------------------------
-
 struct Android_window_desc {
     std::wstring title;
     Extent extent { 0, 0, 1 };
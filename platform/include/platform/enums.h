@@ -17,6 +17,12 @@ enum class Key {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+enum class Access_pattern {
+    normal, sequential, random
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 } // of namespace Platform
 
 #endif // PLATFORM_ENUMS_GUARD
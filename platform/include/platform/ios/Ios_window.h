@@ -8,19 +8,14 @@
 
 #include <string>
 #include <UIKit/UIKit.h>
-#include <sigs.h>
 #include "platform/enums.h"
 #include "platform/Extent.h"
+#include "platform/Signal.h"
 
 namespace Platform {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-template<typename Signature>
-using Signal = sigs::Signal<Signature>;
-
-//----------------------------------------------------------------------------------------------------------------------
-
 struct Ios_window_desc {
     std::wstring title;
     Extent extent { 0, 0, 1 };
@@ -0,0 +1,103 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_HEADLESS_WINDOW_GUARD
+#define PLATFORM_HEADLESS_WINDOW_GUARD
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include "platform/enums.h"
+#include "platform/Extent.h"
+#include "platform/Render_thread.h"
+#include "platform/Signal.h"
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the loop stops at whichever of the frame count and the time budget is reached first, zero means no limit.
+// a frame rate of zero renders frames as fast as possible.
+// with a render thread, frames are rendered on it and resizes are dispatched at the start of the next frame.
+struct Headless_window_desc {
+    std::wstring title;
+    Extent extent { 0, 0, 1 };
+    uint64_t frame_count { 0 };
+    double time_budget { 0.0 };
+    double frame_rate { 0.0 };
+    bool render_thread { false };
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// overrides the description by HEADLESS_FRAME_COUNT, HEADLESS_TIME_BUDGET and HEADLESS_FRAME_RATE.
+// the window doesn't read them itself, so only the applications which call this can be limited by them.
+void override_by_env(Headless_window_desc& desc);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Headless_window final {
+public:
+    Signal<void()> startup_signal;
+    Signal<void()> shutdown_signal;
+    Signal<void()> render_signal;
+    Signal<void(const Extent&)> resize_signal;
+    Signal<void(Key)> key_down_signal;
+    Signal<void(Key)> key_up_signal;
+
+    explicit Headless_window(const Headless_window_desc& desc);
+
+    void run();
+
+    void close() noexcept;
+
+    void resize(const Extent& extent);
+
+    inline auto title() const noexcept
+    { return title_; }
+
+    inline auto extent() const noexcept
+    { return extent_; }
+
+    inline auto frame_count() const noexcept
+    { return frame_index_; }
+
+    inline auto elapsed_time() const noexcept
+    { return elapsed_time_; }
+
+    inline auto window() const noexcept
+    { return nullptr; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void init_limits_(const Headless_window_desc& desc);
+
+    void init_render_thread_(const Headless_window_desc& desc);
+
+    bool render_frame_();
+
+    void dispatch_(const Event& event);
+
+private:
+    std::wstring title_;
+    Extent extent_;
+    uint64_t max_frame_count_;
+    double time_budget_;
+    double frame_rate_;
+    uint64_t frame_index_;
+    double elapsed_time_;
+    Clock::time_point begin_;
+    Clock::time_point next_;
+    std::atomic<bool> running_;
+    std::unique_ptr<Render_thread> render_thread_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_HEADLESS_WINDOW_GUARD
@@ -6,25 +6,25 @@
 #ifndef PLATFORM_MAC_WINDOW_GUARD
 #define PLATFORM_MAC_WINDOW_GUARD
 
+#include <memory>
 #include <string>
 #include <Cocoa/Cocoa.h>
-#include <sigs.h>
 #include "platform/enums.h"
 #include "platform/Extent.h"
+#include "platform/Render_thread.h"
+#include "platform/Signal.h"
 
 namespace Platform {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-template<typename Signature>
-using Signal = sigs::Signal<Signature>;
-
-//----------------------------------------------------------------------------------------------------------------------
-
+// with a render thread, frames are rendered on it instead of the timer of the app,
+// and resizes and keys are dispatched at the start of the next frame.
 struct Osx_window_desc {
     std::wstring title;
     Extent extent { 0, 0, 1 };
     bool resizable { false };
+    bool render_thread { false };
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -71,11 +71,18 @@ private:
 
     void init_window_();
 
+    void init_render_thread_(const Osx_window_desc& desc);
+
+    void post_(const Event& event);
+
+    void dispatch_(const Event& event);
+
 private:
     std::wstring title_;
     Extent extent_;
     NSWindowStyleMask style_mask_;
     NSWindow* window_;
+    std::unique_ptr<Render_thread> render_thread_;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -26,9 +26,10 @@ public:
 
     ~Posix_library();
 
+    // dlsym searches every loaded library for a null handle, so a library which failed to open has no symbols.
     template<typename T>
     T symbol(const char* name) const
-    { return reinterpret_cast<T>(dlsym(library_, name)); }
+    { return library_ ? reinterpret_cast<T>(dlsym(library_, name)) : nullptr; }
 
 private:
     void init_library_(const fs::path& path);
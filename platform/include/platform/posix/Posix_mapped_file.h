@@ -0,0 +1,68 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#ifndef PLATFORM_POSIX_MAPPED_FILE_GUARD
+#define PLATFORM_POSIX_MAPPED_FILE_GUARD
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <ghc/filesystem.hpp>
+#include "platform/enums.h"
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace fs = ghc::filesystem;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a read-only view of a file, the pages are served by the page cache and read on the first access.
+// an empty file has no mapping and a null data.
+class Posix_mapped_file final {
+public:
+    Posix_mapped_file() noexcept;
+
+    explicit Posix_mapped_file(const fs::path& path);
+
+    Posix_mapped_file(Posix_mapped_file&& other) noexcept;
+
+    ~Posix_mapped_file();
+
+    Posix_mapped_file& operator=(Posix_mapped_file&& other) noexcept;
+
+    void advise(Access_pattern pattern) const noexcept;
+
+    // starts to read the pages of a range ahead of the access.
+    void prefetch(size_t offset = 0, size_t size = SIZE_MAX) const noexcept;
+
+    inline auto data() const noexcept
+    { return data_; }
+
+    inline auto size() const noexcept
+    { return size_; }
+
+    inline auto empty() const noexcept
+    { return !size_; }
+
+    inline auto view() const noexcept
+    { return std::string_view(reinterpret_cast<const char*>(data_), size_); }
+
+private:
+    void init_mapping_(const fs::path& path);
+
+    void term_mapping_() noexcept;
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
+
+#endif // PLATFORM_POSIX_MAPPED_FILE_GUARD
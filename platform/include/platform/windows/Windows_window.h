@@ -6,24 +6,24 @@
 #ifndef PLATFORM_WINDOWS_WINDOW_GUARD
 #define PLATFORM_WINDOWS_WINDOW_GUARD
 
+#include <memory>
 #include <string>
-#include <sigs.h>
 #include <Windows.h>
 #include "platform/enums.h"
 #include "platform/Extent.h"
+#include "platform/Render_thread.h"
+#include "platform/Signal.h"
 
 namespace Platform {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-template<typename Signature>
-using Signal = sigs::Signal<Signature>;
-
-//----------------------------------------------------------------------------------------------------------------------
-
+// with a render thread, frames are rendered on it instead of WM_PAINT,
+// and resizes and keys are dispatched at the start of the next frame.
 struct Windows_window_desc {
     std::wstring title;
     Extent extent { 0, 0, 1 };
+    bool render_thread { false };
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -43,6 +43,14 @@ public:
 
     void run();
 
+    void on_render();
+
+    void on_resize(const Extent& extent);
+
+    void on_key_down(Key key);
+
+    void on_key_up(Key key);
+
     inline auto title() const noexcept
     { return title_; }
 
@@ -56,14 +64,21 @@ private:
 
     void init_window_(const Windows_window_desc& desc);
 
+    void init_render_thread_(const Windows_window_desc& desc);
+
     void term_atom_();
 
     void term_window_();
 
+    void post_(const Event& event);
+
+    void dispatch_(const Event& event);
+
 private:
     std::wstring title_;
     ATOM atom_;
     HWND window_;
+    std::unique_ptr<Render_thread> render_thread_;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
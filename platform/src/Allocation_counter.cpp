@@ -0,0 +1,82 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdlib>
+#include <new>
+#include "Allocation_counter.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+thread_local uint64_t count {0};
+thread_local uint32_t suspend_depth {0};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+#if defined(PLATFORM_COUNT_ALLOCATIONS)
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the array, sized and nothrow forms call these, the aligned forms aren't counted.
+void* operator new(size_t size)
+{
+    if (!suspend_depth)
+        ++count;
+
+    if (auto pointer = malloc(size ? size : 1))
+        return pointer;
+
+    throw bad_alloc();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#endif
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint64_t allocation_count() noexcept
+{
+    return count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void suspend_allocation_count() noexcept
+{
+    ++suspend_depth;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void resume_allocation_count() noexcept
+{
+    --suspend_depth;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
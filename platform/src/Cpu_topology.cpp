@@ -0,0 +1,135 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "build_target.h"
+#include "Cpu_topology.h"
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <Windows.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if defined(__linux__) || defined(__ANDROID__)
+
+template<typename T>
+inline auto read_sysfs(const string& path, T& value)
+{
+    ifstream fin(path);
+
+    return static_cast<bool>(fin >> value);
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<Cpu> cpu_topology()
+{
+    vector<Cpu> cpus;
+
+    // ids have holes when CPUs are offline or the process is restricted to some of them, e.g. by taskset.
+#if defined(__linux__) || defined(__ANDROID__)
+    cpu_set_t set;
+
+    if (!sched_getaffinity(0, sizeof(set), &set)) {
+        for (auto i = 0; i != CPU_SETSIZE; ++i) {
+            if (CPU_ISSET(i, &set))
+                cpus.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(i), Core_type::performance});
+        }
+    }
+#elif defined(_WIN32)
+    DWORD_PTR process_mask;
+    DWORD_PTR system_mask;
+
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+        for (auto i = 0u; i != sizeof(DWORD_PTR) * 8; ++i) {
+            if (process_mask & (DWORD_PTR {1} << i))
+                cpus.push_back({i, i, Core_type::performance});
+        }
+    }
+#endif
+
+    if (cpus.empty()) {
+        auto count = max(thread::hardware_concurrency(), 1u);
+
+        for (auto i = 0u; i != count; ++i)
+            cpus.push_back({i, i, Core_type::performance});
+    }
+
+#if defined(__linux__) || defined(__ANDROID__)
+    vector<uint64_t> frequencies(cpus.size(), 0);
+
+    for (size_t i = 0; i != cpus.size(); ++i) {
+        auto& cpu = cpus[i];
+        auto path = "/sys/devices/system/cpu/cpu" + to_string(cpu.index);
+
+        read_sysfs(path + "/topology/core_id", cpu.core);
+        read_sysfs(path + "/cpufreq/cpuinfo_max_freq", frequencies[i]);
+
+        uint32_t package {0};
+
+        // core ids are only unique in a package.
+        if (read_sysfs(path + "/topology/physical_package_id", package))
+            cpu.core |= package << 16;
+    }
+
+    auto max_frequency = *max_element(frequencies.begin(), frequencies.end());
+
+    for (size_t i = 0; i != cpus.size(); ++i) {
+        if (frequencies[i] && frequencies[i] < max_frequency)
+            cpus[i].type = Core_type::efficiency;
+    }
+#endif
+
+    return cpus;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool set_thread_affinity(uint32_t cpu) noexcept
+{
+#if defined(__ANDROID__)
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return !sched_setaffinity(0, sizeof(set), &set);
+#elif defined(__linux__)
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return !pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR {1} << cpu);
+#else
+    // Apple platforms only take affinity tags as hints, so threads aren't pinned.
+    return false;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
@@ -0,0 +1,130 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdint>
+#include "Frame_arena.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr auto buffer_alignment = alignof(max_align_t);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Frame_arena::Frame_arena(size_t capacity, std::pmr::memory_resource* upstream) :
+    upstream_ {upstream},
+    buffer_ {nullptr},
+    capacity_ {0},
+    offset_ {0},
+    overflow_size_ {0},
+    overflows_ {}
+{
+    init_buffer_(capacity);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Frame_arena::~Frame_arena()
+{
+    term_overflows_();
+    term_buffer_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_arena::reset()
+{
+    // the last frame didn't fit, so the arena grows to fit it.
+    if (!overflows_.empty()) {
+        auto capacity = offset_ + overflow_size_;
+
+        term_overflows_();
+        term_buffer_();
+        init_buffer_(capacity);
+    }
+
+    offset_ = 0;
+    overflow_size_ = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* Frame_arena::do_allocate(size_t size, size_t alignment)
+{
+    auto address = reinterpret_cast<uintptr_t>(buffer_) + offset_;
+    auto padding = (alignment - address % alignment) % alignment;
+
+    if (offset_ + padding + size <= capacity_) {
+        auto pointer = buffer_ + offset_ + padding;
+
+        offset_ += padding + size;
+
+        return pointer;
+    }
+
+    auto pointer = upstream_->allocate(size, alignment);
+
+    overflows_.push_back({pointer, size, alignment});
+    overflow_size_ += size + alignment;
+
+    return pointer;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_arena::do_deallocate(void*, size_t, size_t)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Frame_arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_arena::init_buffer_(size_t capacity)
+{
+    if (capacity)
+        buffer_ = static_cast<byte*>(upstream_->allocate(capacity, buffer_alignment));
+
+    capacity_ = capacity;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_arena::term_buffer_() noexcept
+{
+    if (buffer_)
+        upstream_->deallocate(buffer_, capacity_, buffer_alignment);
+
+    buffer_ = nullptr;
+    capacity_ = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_arena::term_overflows_() noexcept
+{
+    for (auto& overflow : overflows_)
+        upstream_->deallocate(overflow.pointer, overflow.size, overflow.alignment);
+
+    overflows_.clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
@@ -0,0 +1,73 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include "Frame_clock.h"
+
+using namespace std;
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Frame_clock::Frame_clock(double time_step, double max_frame_time) :
+    time_step_ {time_step},
+    max_frame_time_ {max_frame_time},
+    last_time_ {},
+    frame_time_ {0.0},
+    accumulator_ {0.0},
+    time_ {0.0},
+    step_count_ {0}
+{
+    if (time_step_ <= 0.0)
+        throw runtime_error("fail to create a frame clock");
+
+    reset();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t Frame_clock::tick()
+{
+    auto now = Clock::now();
+    auto frame_time = chrono::duration<double>(now - last_time_).count();
+
+    last_time_ = now;
+
+    return advance(frame_time);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t Frame_clock::advance(double frame_time)
+{
+    frame_time_ = min(max(frame_time, 0.0), max_frame_time_);
+    accumulator_ += frame_time_;
+    step_count_ = 0;
+
+    while (accumulator_ >= time_step_) {
+        accumulator_ -= time_step_;
+        time_ += time_step_;
+        ++step_count_;
+    }
+
+    return step_count_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_clock::reset()
+{
+    last_time_ = Clock::now();
+    frame_time_ = 0.0;
+    accumulator_ = 0.0;
+    time_ = 0.0;
+    step_count_ = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
@@ -0,0 +1,530 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include "Io_service.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+using namespace std;
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Io_service::Request_ {
+    Io_read_desc desc;
+    Io_callback callback;
+    size_t done {0};
+#if defined(__linux__)
+    int file {-1};
+    iovec vector {};
+#endif
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if defined(__linux__)
+
+// a ring without liburing, it is only used by the thread of the service.
+// an eventfd is polled through the ring, so the thread is woken up by a new request while it waits for completions.
+class Io_service::Io_uring_ final {
+public:
+    explicit Io_uring_(uint32_t entries)
+    {
+        init_ring_(entries);
+        init_event_();
+    }
+
+    Io_uring_(const Io_uring_&) = delete;
+
+    ~Io_uring_()
+    {
+        term_event_();
+        term_ring_();
+    }
+
+    Io_uring_& operator=(const Io_uring_&) = delete;
+
+    inline auto capacity() const noexcept
+    { return entries_; }
+
+    void prepare_read(int file, iovec* vector, uint64_t offset, uint64_t user_data) noexcept
+    {
+        auto sqe = next_sqe_();
+
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = file;
+        sqe->addr = reinterpret_cast<uint64_t>(vector);
+        sqe->len = 1;
+        sqe->off = offset;
+        sqe->user_data = user_data;
+    }
+
+    void prepare_wake() noexcept
+    {
+        auto sqe = next_sqe_();
+
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = event_;
+        sqe->poll_events = POLLIN;
+        sqe->user_data = 0;
+    }
+
+    void submit_and_wait(uint32_t wait_count) noexcept
+    {
+        auto count = prepared_;
+
+        prepared_ = 0;
+
+        while (syscall(__NR_io_uring_enter, ring_, count, wait_count, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+            if (errno != EINTR)
+                break;
+
+            count = 0;
+        }
+    }
+
+    template<typename Function>
+    void reap(Function function)
+    {
+        auto head = *cq_head_;
+        auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+        for (; head != tail; ++head) {
+            auto& cqe = cqes_[head & *cq_mask_];
+
+            function(cqe.user_data, cqe.res);
+        }
+
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+    void wake() noexcept
+    {
+        eventfd_write(event_, 1);
+    }
+
+    void clear_wake() noexcept
+    {
+        eventfd_t value;
+
+        eventfd_read(event_, &value);
+    }
+
+private:
+    void init_ring_(uint32_t entries)
+    {
+        io_uring_params params {};
+
+        ring_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+
+        if (ring_ < 0)
+            throw runtime_error("fail to create an io_uring");
+
+        entries_ = params.sq_entries;
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        // the rings share a mapping since 5.4.
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            sq_size_ = cq_size_ = max(sq_size_, cq_size_);
+
+        sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_, IORING_OFF_SQ_RING);
+
+        if (sq_ptr_ == MAP_FAILED) {
+            close(ring_);
+            throw runtime_error("fail to map an io_uring");
+        }
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            cq_ptr_ = sq_ptr_;
+        } else {
+            cq_ptr_ = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ring_, IORING_OFF_CQ_RING);
+
+            if (cq_ptr_ == MAP_FAILED) {
+                munmap(sq_ptr_, sq_size_);
+                close(ring_);
+                throw runtime_error("fail to map an io_uring");
+            }
+        }
+
+        auto sqes = mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_SQES);
+
+        if (sqes == MAP_FAILED) {
+            if (cq_ptr_ != sq_ptr_)
+                munmap(cq_ptr_, cq_size_);
+
+            munmap(sq_ptr_, sq_size_);
+            close(ring_);
+            throw runtime_error("fail to map an io_uring");
+        }
+
+        auto sq_ptr = static_cast<uint8_t*>(sq_ptr_);
+        auto cq_ptr = static_cast<uint8_t*>(cq_ptr_);
+
+        sq_tail_ = reinterpret_cast<uint32_t*>(sq_ptr + params.sq_off.tail);
+        sq_mask_ = reinterpret_cast<uint32_t*>(sq_ptr + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<uint32_t*>(sq_ptr + params.sq_off.array);
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+        cq_head_ = reinterpret_cast<uint32_t*>(cq_ptr + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<uint32_t*>(cq_ptr + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<uint32_t*>(cq_ptr + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ptr + params.cq_off.cqes);
+        prepared_ = 0;
+    }
+
+    void init_event_()
+    {
+        event_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (event_ < 0) {
+            term_ring_();
+            throw runtime_error("fail to create an eventfd");
+        }
+    }
+
+    void term_ring_() noexcept
+    {
+        munmap(sqes_, entries_ * sizeof(io_uring_sqe));
+
+        if (cq_ptr_ != sq_ptr_)
+            munmap(cq_ptr_, cq_size_);
+
+        munmap(sq_ptr_, sq_size_);
+        close(ring_);
+    }
+
+    void term_event_() noexcept
+    {
+        close(event_);
+    }
+
+    io_uring_sqe* next_sqe_() noexcept
+    {
+        // the callers never prepare more entries than the capacity before they submit.
+        auto tail = *sq_tail_;
+        auto index = tail & *sq_mask_;
+        auto sqe = &sqes_[index];
+
+        *sqe = {};
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++prepared_;
+
+        return sqe;
+    }
+
+private:
+    int ring_;
+    int event_;
+    uint32_t entries_;
+    void* sq_ptr_;
+    size_t sq_size_;
+    void* cq_ptr_;
+    size_t cq_size_;
+    uint32_t* sq_tail_;
+    uint32_t* sq_mask_;
+    uint32_t* sq_array_;
+    io_uring_sqe* sqes_;
+    uint32_t* cq_head_;
+    uint32_t* cq_tail_;
+    uint32_t* cq_mask_;
+    io_uring_cqe* cqes_;
+    uint32_t prepared_;
+};
+
+#else
+
+class Io_service::Io_uring_ final {
+};
+
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Io_service::Io_service() :
+    Io_service(Io_service_desc())
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Io_service::Io_service(const Io_service_desc& desc) :
+    backend_ {Io_backend::thread_pool},
+    ring_ {},
+    threads_ {},
+    mutex_ {},
+    cv_ {},
+    idle_cv_ {},
+    pending_ {},
+    outstanding_ {0},
+    running_ {true}
+{
+    if (desc.use_io_uring)
+        init_io_uring_(desc);
+
+    if (backend_ == Io_backend::thread_pool)
+        init_thread_pool_(desc);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Io_service::~Io_service()
+{
+    wait();
+    term_threads_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Io_service::read(const Io_read_desc& desc, Io_callback callback)
+{
+    auto request = make_unique<Request_>();
+
+    request->desc = desc;
+    request->callback = move(callback);
+
+    {
+        lock_guard<mutex> lock {mutex_};
+
+        pending_.push_back(move(request));
+        ++outstanding_;
+    }
+
+#if defined(__linux__)
+    if (ring_) {
+        ring_->wake();
+        return;
+    }
+#endif
+
+    cv_.notify_one();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::future<size_t> Io_service::read(const Io_read_desc& desc)
+{
+    auto promise = make_shared<std::promise<size_t>>();
+    auto future = promise->get_future();
+
+    read(desc, [promise, path = desc.path](size_t size, error_code error) {
+        if (error)
+            promise->set_exception(make_exception_ptr(system_error(error, "fail to read " + path.string())));
+        else
+            promise->set_value(size);
+    });
+
+    return future;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Io_service::wait()
+{
+    unique_lock<mutex> lock {mutex_};
+
+    idle_cv_.wait(lock, [this] { return !outstanding_; });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Io_service::init_io_uring_(const Io_service_desc& desc)
+{
+#if defined(__linux__)
+    // the kernel may be too old or io_uring may be disabled, the thread pool is used then.
+    try {
+        ring_ = make_unique<Io_uring_>(desc.queue_depth);
+    } catch (const runtime_error&) {
+        return;
+    }
+
+    backend_ = Io_backend::io_uring;
+    threads_.emplace_back(&Io_service::run_io_uring_, this);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Io_service::init_thread_pool_(const Io_service_desc& desc)
+{
+    for (auto i = 0u; i != max(desc.thread_count, 1u); ++i)
+        threads_.emplace_back(&Io_service::run_worker_, this);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Io_service::term_threads_()
+{
+    {
+        lock_guard<mutex> lock {mutex_};
+
+        running_ = false;
+    }
+
+#if defined(__linux__)
+    if (ring_)
+        ring_->wake();
+#endif
+
+    cv_.notify_all();
+
+    for (auto& thread : threads_)
+        thread.join();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Io_service::run_io_uring_()
+{
+#if defined(__linux__)
+    // one entry is kept for the poll of the eventfd.
+    const auto capacity = ring_->capacity() - 1;
+    deque<unique_ptr<Request_>> requests;
+    uint32_t in_flight = 0;
+
+    ring_->prepare_wake();
+
+    while (true) {
+        {
+            lock_guard<mutex> lock {mutex_};
+
+            if (!running_ && pending_.empty() && requests.empty() && !in_flight)
+                break;
+
+            for (auto& request : pending_)
+                requests.push_back(move(request));
+
+            pending_.clear();
+        }
+
+        // requests which are over the capacity wait for completions.
+        while (!requests.empty() && in_flight != capacity) {
+            auto request = move(requests.front());
+
+            requests.pop_front();
+
+            if (request->file == -1) {
+                request->file = open(request->desc.path.c_str(), O_RDONLY | O_CLOEXEC);
+
+                if (request->file == -1) {
+                    complete_(move(request), error_code(errno, system_category()));
+                    continue;
+                }
+            }
+
+            // the request is owned by the ring until it completes.
+            auto raw_request = request.release();
+
+            raw_request->vector.iov_base = static_cast<uint8_t*>(raw_request->desc.buffer) + raw_request->done;
+            raw_request->vector.iov_len = raw_request->desc.size - raw_request->done;
+
+            ring_->prepare_read(raw_request->file, &raw_request->vector, raw_request->desc.offset + raw_request->done,
+                                reinterpret_cast<uint64_t>(raw_request));
+            ++in_flight;
+        }
+
+        ring_->submit_and_wait(1);
+
+        ring_->reap([&](uint64_t user_data, int32_t result) {
+            if (!user_data) {
+                ring_->clear_wake();
+                ring_->prepare_wake();
+                return;
+            }
+
+            unique_ptr<Request_> request {reinterpret_cast<Request_*>(user_data)};
+
+            --in_flight;
+
+            if (result == -EAGAIN || result == -EINTR) {
+                requests.push_front(move(request));
+            } else if (result < 0) {
+                complete_(move(request), error_code(-result, system_category()));
+            } else {
+                request->done += result;
+
+                // a short read continues from where it stops until the end of a file.
+                if (result && request->done != request->desc.size)
+                    requests.push_front(move(request));
+                else
+                    complete_(move(request), {});
+            }
+        });
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Io_service::run_worker_()
+{
+    while (true) {
+        unique_ptr<Request_> request;
+
+        {
+            unique_lock<mutex> lock {mutex_};
+
+            cv_.wait(lock, [this] { return !running_ || !pending_.empty(); });
+
+            if (pending_.empty())
+                return;
+
+            request = move(pending_.front());
+            pending_.pop_front();
+        }
+
+        ifstream fin(request->desc.path.string(), ios::binary);
+
+        if (!fin.is_open()) {
+            complete_(move(request), make_error_code(errc::no_such_file_or_directory));
+            continue;
+        }
+
+        fin.seekg(request->desc.offset);
+        fin.read(static_cast<char*>(request->desc.buffer), request->desc.size);
+        request->done = static_cast<size_t>(fin.gcount());
+
+        complete_(move(request), fin.bad() ? make_error_code(errc::io_error) : error_code());
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Io_service::complete_(std::unique_ptr<Request_> request, std::error_code error)
+{
+#if defined(__linux__)
+    if (request->file != -1)
+        close(request->file);
+#endif
+
+    request->callback(request->done, error);
+    request.reset();
+
+    lock_guard<mutex> lock {mutex_};
+
+    if (!--outstanding_)
+        idle_cv_.notify_all();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
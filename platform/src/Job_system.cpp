@@ -0,0 +1,518 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include "Job_system.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the job system and the worker of the calling thread.
+thread_local const void* current_system {nullptr};
+thread_local void* current_worker {nullptr};
+thread_local uint32_t victim {0};
+
+// a worker which finds no job yields this many times while jobs are pending before it sleeps.
+constexpr auto spin_count = 64;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Job_ {
+    Job_function function;
+    Job_counter* counter {nullptr};
+    Core_type core_type {Core_type::any};
+    bool pooled {true};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_system::Deque_::Deque_() :
+    top_ {0},
+    bottom_ {0},
+    jobs_ {new atomic<Job_*>[capacity_]}
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Job_system::Deque_::push(Job_* job) noexcept
+{
+    auto bottom = bottom_.load(memory_order_relaxed);
+    auto top = top_.load(memory_order_acquire);
+
+    if (bottom - top >= capacity_)
+        return false;
+
+    jobs_[bottom & (capacity_ - 1)].store(job, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    bottom_.store(bottom + 1, memory_order_relaxed);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_* Job_system::Deque_::pop() noexcept
+{
+    auto bottom = bottom_.load(memory_order_relaxed) - 1;
+
+    bottom_.store(bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    auto top = top_.load(memory_order_relaxed);
+
+    if (top > bottom) {
+        bottom_.store(bottom + 1, memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto job = jobs_[bottom & (capacity_ - 1)].load(memory_order_relaxed);
+
+    // the last job races with thieves.
+    if (top == bottom) {
+        if (!top_.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+            job = nullptr;
+
+        bottom_.store(bottom + 1, memory_order_relaxed);
+    }
+
+    return job;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_* Job_system::Deque_::steal() noexcept
+{
+    auto top = top_.load(memory_order_acquire);
+
+    atomic_thread_fence(memory_order_seq_cst);
+
+    auto bottom = bottom_.load(memory_order_acquire);
+
+    if (top >= bottom)
+        return nullptr;
+
+    auto job = jobs_[top & (capacity_ - 1)].load(memory_order_relaxed);
+
+    if (!top_.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+        return nullptr;
+
+    return job;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::Queue_::reserve(size_t capacity)
+{
+    lock_guard<mutex> lock {mutex_};
+
+    grow_(capacity);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::Queue_::push(Job_* job)
+{
+    lock_guard<mutex> lock {mutex_};
+
+    if (count_ == jobs_.size())
+        grow_(max<size_t>(jobs_.size() * 2, 64));
+
+    jobs_[(head_ + count_++) % jobs_.size()] = job;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_* Job_system::Queue_::pop()
+{
+    lock_guard<mutex> lock {mutex_};
+
+    if (!count_)
+        return nullptr;
+
+    auto job = jobs_[head_];
+
+    head_ = (head_ + 1) % jobs_.size();
+    --count_;
+
+    return job;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::Queue_::grow_(size_t capacity)
+{
+    if (capacity <= jobs_.size())
+        return;
+
+    vector<Job_*> jobs(capacity);
+
+    for (size_t i = 0; i != count_; ++i)
+        jobs[i] = jobs_[(head_ + i) % jobs_.size()];
+
+    jobs_ = move(jobs);
+    head_ = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_system::Job_system() :
+    Job_system(Job_system_desc {})
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_system::Job_system(const Job_system_desc& desc) :
+    jobs_ {},
+    free_jobs_ {},
+    jobs_mutex_ {},
+    workers_ {},
+    queues_ {},
+    core_types_ {true, false, false},
+    pending_ {0},
+    epoch_ {0},
+    sleeping_ {0},
+    running_ {false}
+{
+    init_jobs_(desc);
+    init_workers_(desc);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_system::~Job_system()
+{
+    term_workers_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::schedule(const Job_desc& desc)
+{
+    auto job = allocate_job_();
+
+    job->function = desc.function;
+    job->counter = desc.counter;
+    job->core_type = desc.core_type;
+
+    if (desc.counter)
+        desc.counter->count_.fetch_add(1, memory_order_acq_rel);
+
+    // the job is scheduled by the last job of the dependency.
+    if (desc.dependency) {
+        lock_guard<mutex> lock {desc.dependency->mutex_};
+
+        if (desc.dependency->count_.load(memory_order_acquire)) {
+            desc.dependency->dependents_.push_back(job);
+            return;
+        }
+    }
+
+    enqueue_(job);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::schedule(Job_function function, Job_counter* counter)
+{
+    schedule({move(function), counter});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::wait(const Job_counter& counter)
+{
+    auto worker = current_worker_();
+
+    // a thread which isn't a worker has no core type, so it runs the jobs of any core type.
+    while (!counter.done()) {
+        if (auto job = dequeue_(worker, !worker))
+            execute_(job);
+        else
+            this_thread::yield();
+    }
+
+    // the last job releases the lock after it touches the counter, so the counter can be destroyed after.
+    lock_guard<mutex> lock {counter.mutex_};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::init_jobs_(const Job_system_desc& desc)
+{
+    jobs_ = make_unique<Job_[]>(desc.job_capacity);
+    free_jobs_.reserve(desc.job_capacity);
+
+    for (uint32_t i = desc.job_capacity; i != 0; --i)
+        free_jobs_.push_back(&jobs_[i - 1]);
+
+    // the shared queues hold every pooled job, so they only grow for allocated jobs.
+    for (auto& queue : queues_)
+        queue.reserve(desc.job_capacity);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::init_workers_(const Job_system_desc& desc)
+{
+    auto cpus = cpu_topology();
+
+    // a worker per core, SMT siblings share execution units, so they are skipped by default.
+    if (!desc.use_smt) {
+        vector<Cpu> first_cpus;
+
+        for (auto& cpu : cpus) {
+            auto iter = find_if(first_cpus.begin(), first_cpus.end(),
+                                [&cpu](const Cpu& first_cpu) { return first_cpu.core == cpu.core; });
+
+            if (iter == first_cpus.end())
+                first_cpus.push_back(cpu);
+        }
+
+        cpus = move(first_cpus);
+    }
+
+    stable_partition(cpus.begin(), cpus.end(), [](const Cpu& cpu) { return cpu.type == Core_type::performance; });
+
+    // the thread which waits helps, so it takes the place of a worker.
+    auto thread_count = desc.thread_count ? desc.thread_count : max(static_cast<uint32_t>(cpus.size()), 2u) - 1;
+
+    running_ = true;
+
+    for (uint32_t i = 0; i != thread_count; ++i) {
+        auto& cpu = cpus[i % cpus.size()];
+        auto worker = make_unique<Worker_>();
+
+        worker->core_type = cpu.type;
+        worker->cpu = desc.pin_threads ? static_cast<int32_t>(cpu.index) : -1;
+        core_types_[static_cast<uint32_t>(cpu.type)] = true;
+
+        workers_.push_back(move(worker));
+    }
+
+    for (uint32_t i = 0; i != thread_count; ++i)
+        workers_[i]->thread = thread(&Job_system::run_worker_, this, i);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::term_workers_()
+{
+    {
+        lock_guard<mutex> lock {mutex_};
+
+        running_ = false;
+        cv_.notify_all();
+    }
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::run_worker_(uint32_t index)
+{
+    auto worker = workers_[index].get();
+
+    current_system = this;
+    current_worker = worker;
+    victim = index + 1;
+
+    if (worker->cpu >= 0)
+        set_thread_affinity(worker->cpu);
+
+    auto spins = 0;
+
+    while (true) {
+        // a job which is enqueued after this changes the epoch, so the worker doesn't sleep past it.
+        auto epoch = epoch_.load();
+
+        if (auto job = dequeue_(worker)) {
+            execute_(job);
+            spins = 0;
+            continue;
+        }
+
+        // pending jobs may be about to be pushed or left only for workers of another core type.
+        if (pending_.load() > 0 && spins++ != spin_count) {
+            this_thread::yield();
+            continue;
+        }
+
+        spins = 0;
+
+        // a job of the other core type is run rather than left behind when the worker would sleep.
+        if (auto job = dequeue_(worker, true)) {
+            execute_(job);
+            continue;
+        }
+
+        unique_lock<mutex> lock {mutex_};
+
+        if (!running_)
+            break;
+
+        sleeping_.fetch_add(1);
+        cv_.wait(lock, [this, epoch]() { return !running_ || epoch_.load() != epoch; });
+        sleeping_.fetch_sub(1);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::enqueue_(Job_* job)
+{
+    auto worker = current_worker_();
+    auto core_type = static_cast<uint32_t>(job->core_type);
+
+    // a core type is only a hint, it is ignored when there is no worker or no choice of the core type.
+    if (!core_types_[core_type] || !(core_types_[1] && core_types_[2]))
+        core_type = 0;
+
+    if (core_type)
+        queues_[core_type].push(job);
+    else if (!worker || !worker->deque.push(job))
+        queues_[0].push(job);
+
+    pending_.fetch_add(1);
+    epoch_.fetch_add(1);
+    // a single woken worker may be of the other core type, so every worker is woken for a typed job.
+    wake_(core_type != 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_* Job_system::dequeue_(Worker_* worker, bool any_core_type) noexcept
+{
+    Job_* job {nullptr};
+
+    if (worker) {
+        job = worker->deque.pop();
+
+        if (!job && worker->core_type != Core_type::any)
+            job = queues_[static_cast<uint32_t>(worker->core_type)].pop();
+    }
+
+    if (!job)
+        job = queues_[0].pop();
+
+    for (size_t i = 0; !job && i != workers_.size(); ++i) {
+        auto& other = workers_[victim++ % workers_.size()];
+
+        if (other.get() != worker)
+            job = other->deque.steal();
+    }
+
+    for (auto i = 1u; !job && any_core_type && i != 3; ++i)
+        job = queues_[i].pop();
+
+    if (job)
+        pending_.fetch_sub(1);
+
+    return job;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_* Job_system::allocate_job_()
+{
+    {
+        lock_guard<mutex> lock {jobs_mutex_};
+
+        if (!free_jobs_.empty()) {
+            auto job = free_jobs_.back();
+
+            free_jobs_.pop_back();
+
+            return job;
+        }
+    }
+
+    // the pool is exhausted, the job is allocated instead.
+    auto job = new Job_ {};
+
+    job->pooled = false;
+
+    return job;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::free_job_(Job_* job) noexcept
+{
+    if (!job->pooled) {
+        delete job;
+        return;
+    }
+
+    job->function.reset();
+
+    lock_guard<mutex> lock {jobs_mutex_};
+
+    free_jobs_.push_back(job);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::execute_(Job_* job)
+{
+    job->function();
+
+    auto counter = job->counter;
+
+    free_job_(job);
+
+    if (!counter)
+        return;
+
+    lock_guard<mutex> lock {counter->mutex_};
+
+    // the dependents are cleared in place, so the counter keeps its storage for the next frame.
+    if (counter->count_.fetch_sub(1, memory_order_acq_rel) == 1) {
+        for (auto dependent : counter->dependents_)
+            enqueue_(dependent);
+
+        counter->dependents_.clear();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Job_system::wake_(bool all)
+{
+    if (!sleeping_.load())
+        return;
+
+    lock_guard<mutex> lock {mutex_};
+
+    if (all)
+        cv_.notify_all();
+    else
+        cv_.notify_one();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Job_system::Worker_* Job_system::current_worker_() const noexcept
+{
+    return current_system == this ? static_cast<Worker_*>(current_worker) : nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
@@ -0,0 +1,142 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <stdexcept>
+#include "Render_thread.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the render thread which runs on the calling thread, if any.
+thread_local const Platform::Render_thread* current_render_thread {nullptr};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Render_thread::Render_thread(Dispatch dispatch, Frame frame) :
+    dispatch_ {move(dispatch)},
+    frame_ {move(frame)},
+    events_ {},
+    deferred_events_ {},
+    running_ {false},
+    thread_ {}
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Render_thread::~Render_thread()
+{
+    stop();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Render_thread::start()
+{
+    if (thread_.joinable())
+        throw runtime_error("fail to start a render thread");
+
+    running_.store(true, memory_order_release);
+    thread_ = thread(&Render_thread::run_, this);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Render_thread::stop()
+{
+    running_.store(false, memory_order_release);
+    wait();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Render_thread::wait()
+{
+    if (thread_.joinable())
+        thread_.join();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Render_thread::post(const Event& event)
+{
+    // the render thread can't wait for its own frame and mustn't become a second producer of the queue.
+    if (current_render_thread == this) {
+        deferred_events_.push_back(event);
+        return;
+    }
+
+    // the event loop waits for a frame rather than lose an event.
+    while (!events_.push(event))
+        this_thread::yield();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Render_thread::run_()
+{
+    current_render_thread = this;
+
+    while (running_.load(memory_order_acquire)) {
+        dispatch_events_();
+
+        if (!frame_())
+            break;
+    }
+
+    current_render_thread = nullptr;
+    running_.store(false, memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Render_thread::dispatch_events_()
+{
+    Event event;
+    Event resize;
+    auto resize_pending = false;
+
+    // a resize is held until an event of another type, so dragging a window dispatches the last resize of a run.
+    while (events_.pop(event)) {
+        if (event.type == Event_type::resize) {
+            resize = event;
+            resize_pending = true;
+            continue;
+        }
+
+        if (resize_pending) {
+            dispatch_(resize);
+            resize_pending = false;
+        }
+
+        dispatch_(event);
+    }
+
+    if (resize_pending)
+        dispatch_(resize);
+
+    // events which are posted while these are dispatched wait for the next frame.
+    auto count = deferred_events_.size();
+
+    for (size_t i = 0; i != count; ++i) {
+        event = deferred_events_[i];
+        dispatch_(event);
+    }
+
+    deferred_events_.erase(deferred_events_.begin(), deferred_events_.begin() + count);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
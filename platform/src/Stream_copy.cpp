@@ -0,0 +1,218 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <cstring>
+#include "Stream_copy.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the stores of a kernel fill whole cache lines, so the write-combining buffers are written out at once.
+constexpr size_t line_size {64};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// copies the bytes before the first aligned line and returns how many are left for the kernel.
+inline auto copy_head(uint8_t*& dst, const uint8_t*& src, size_t& size) noexcept
+{
+    auto head = (line_size - reinterpret_cast<uintptr_t>(dst) % line_size) % line_size;
+
+    if (head > size)
+        head = size;
+
+    memcpy(dst, src, head);
+
+    dst += head;
+    src += head;
+    size -= head;
+
+    return size / line_size * line_size;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+inline void copy_sse2(uint8_t* dst, const uint8_t* src, size_t size) noexcept
+{
+    for (auto end = dst + size; dst != end; dst += line_size, src += line_size) {
+        auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+        auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+    }
+
+    _mm_sfence();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+inline void copy_avx2(uint8_t* dst, const uint8_t* src, size_t size) noexcept
+{
+    for (auto end = dst + size; dst != end; dst += line_size, src += line_size) {
+        auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+    }
+
+    _mm_sfence();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto has_avx2() noexcept
+{
+#if defined(__GNUC__)
+    return __builtin_cpu_supports("avx2") != 0;
+#elif defined(_MSC_VER)
+    int registers[4];
+
+    // the OS must save the YMM registers as well as the CPU supporting AVX2.
+    __cpuid(registers, 1);
+
+    if (!(registers[2] & (1 << 27)) || !(registers[2] & (1 << 28)))
+        return false;
+
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(registers, 7, 0);
+
+    return (registers[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if defined(__aarch64__) && defined(__GNUC__)
+
+// NEON has no intrinsic for non-temporal stores, STNP is the store pair with the non-temporal hint.
+inline void copy_neon(uint8_t* dst, const uint8_t* src, size_t size) noexcept
+{
+    for (auto end = dst + size; dst != end; dst += line_size, src += line_size) {
+        __asm__ volatile(
+            "ldp q0, q1, [%1]\n"
+            "ldp q2, q3, [%1, #32]\n"
+            "stnp q0, q1, [%0]\n"
+            "stnp q2, q3, [%0, #32]\n"
+            :
+            : "r"(dst), "r"(src)
+            : "v0", "v1", "v2", "v3", "memory");
+    }
+
+    __asm__ volatile("dmb ishst" ::: "memory");
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Copy_kernel stream_copy_kernel() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    static const auto kernel = has_avx2() ? Copy_kernel::avx2 : Copy_kernel::sse2;
+#elif defined(__aarch64__) && defined(__GNUC__)
+    constexpr auto kernel = Copy_kernel::neon;
+#else
+    constexpr auto kernel = Copy_kernel::memcpy;
+#endif
+
+    return kernel;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void stream_copy(void* dst, const void* src, size_t size, bool write_combined) noexcept
+{
+    if (!write_combined || size < stream_copy_threshold)
+        memcpy(dst, src, size);
+    else
+        stream_copy(dst, src, size, stream_copy_kernel());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void stream_copy(void* dst, const void* src, size_t size, Copy_kernel kernel) noexcept
+{
+    if (kernel == Copy_kernel::memcpy) {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    auto dst_bytes = static_cast<uint8_t*>(dst);
+    auto src_bytes = static_cast<const uint8_t*>(src);
+    auto body = copy_head(dst_bytes, src_bytes, size);
+
+    switch (kernel) {
+#if defined(__x86_64__) || defined(_M_X64)
+        case Copy_kernel::sse2:
+            copy_sse2(dst_bytes, src_bytes, body);
+            break;
+        case Copy_kernel::avx2:
+            copy_avx2(dst_bytes, src_bytes, body);
+            break;
+#endif
+#if defined(__aarch64__) && defined(__GNUC__)
+        case Copy_kernel::neon:
+            copy_neon(dst_bytes, src_bytes, body);
+            break;
+#endif
+        default:
+            memcpy(dst_bytes, src_bytes, body);
+            break;
+    }
+
+    memcpy(dst_bytes + body, src_bytes + body, size - body);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const char* to_string(Copy_kernel kernel) noexcept
+{
+    switch (kernel) {
+        case Copy_kernel::sse2:
+            return "sse2";
+        case Copy_kernel::avx2:
+            return "avx2";
+        case Copy_kernel::neon:
+            return "neon";
+        default:
+            return "memcpy";
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
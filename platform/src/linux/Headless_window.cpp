@@ -0,0 +1,172 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "linux/Headless_window.h"
+
+using namespace std;
+using namespace Platform;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void read_env(const char* name, T& value)
+{
+    auto env = getenv(name);
+
+    if (env)
+        value = static_cast<T>(strtod(env, nullptr));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void override_by_env(Headless_window_desc& desc)
+{
+    read_env("HEADLESS_FRAME_COUNT", desc.frame_count);
+    read_env("HEADLESS_TIME_BUDGET", desc.time_budget);
+    read_env("HEADLESS_FRAME_RATE", desc.frame_rate);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Headless_window::Headless_window(const Headless_window_desc& desc) :
+    title_ {desc.title},
+    extent_ {desc.extent},
+    max_frame_count_ {0},
+    time_budget_ {0.0},
+    frame_rate_ {0.0},
+    frame_index_ {0},
+    elapsed_time_ {0.0},
+    begin_ {},
+    next_ {},
+    running_ {false},
+    render_thread_ {}
+{
+    init_limits_(desc);
+    init_render_thread_(desc);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Headless_window::run()
+{
+    running_ = true;
+    frame_index_ = 0;
+    startup_signal();
+
+    begin_ = Clock::now();
+    next_ = begin_;
+
+    if (render_thread_) {
+        render_thread_->start();
+        render_thread_->wait();
+    }
+    else {
+        while (render_frame_());
+    }
+
+    elapsed_time_ = chrono::duration<double>(Clock::now() - begin_).count();
+    running_ = false;
+    shutdown_signal();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Headless_window::close() noexcept
+{
+    running_ = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Headless_window::resize(const Extent& extent)
+{
+    Event event {Event_type::resize, extent};
+
+    if (render_thread_)
+        render_thread_->post(event);
+    else
+        dispatch_(event);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Headless_window::init_limits_(const Headless_window_desc& desc)
+{
+    max_frame_count_ = desc.frame_count;
+    time_budget_ = desc.time_budget;
+    frame_rate_ = desc.frame_rate;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Headless_window::init_render_thread_(const Headless_window_desc& desc)
+{
+    if (!desc.render_thread)
+        return;
+
+    render_thread_ = make_unique<Render_thread>([this](const Event& event) { dispatch_(event); },
+                                                [this]() { return render_frame_(); });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Headless_window::render_frame_()
+{
+    if (!running_)
+        return false;
+
+    if (max_frame_count_ && frame_index_ >= max_frame_count_)
+        return false;
+
+    if (time_budget_ && chrono::duration<double>(Clock::now() - begin_).count() >= time_budget_)
+        return false;
+
+    // frames are paced by absolute deadlines so the rate doesn't drift.
+    if (frame_rate_) {
+        this_thread::sleep_until(next_);
+        next_ += chrono::duration_cast<Clock::duration>(chrono::duration<double>(1.0 / frame_rate_));
+    }
+
+    render_signal();
+    ++frame_index_;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Headless_window::dispatch_(const Event& event)
+{
+    switch (event.type) {
+        case Event_type::resize:
+            if (extent_ == event.extent)
+                return;
+
+            extent_ = event.extent;
+            resize_signal(extent_);
+            break;
+        case Event_type::key_down:
+            key_down_signal(event.key);
+            break;
+        case Event_type::key_up:
+            key_up_signal(event.key);
+            break;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
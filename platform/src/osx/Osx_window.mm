@@ -560,10 +560,13 @@ Osx_window::Osx_window(const Osx_window_desc& desc) :
     title_ { desc.title },
     extent_ { desc.extent },
     style_mask_ { to_style_mask(desc) },
-    window_ { nil }
+    window_ { nil },
+    render_thread_ {}
 {
     if (!NSApp)
         init_app_();
+
+    init_render_thread_(desc);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -579,12 +582,18 @@ void Osx_window::on_startup()
 {
     init_window_();
     startup_signal();
+
+    if (render_thread_)
+        render_thread_->start();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 void Osx_window::on_shutdown()
 {
+    if (render_thread_)
+        render_thread_->stop();
+
     shutdown_signal();
 }
 
@@ -592,29 +601,30 @@ void Osx_window::on_shutdown()
 
 void Osx_window::on_render()
 {
-    render_signal();
+    // the render thread renders frames instead of the timer.
+    if (!render_thread_)
+        render_signal();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 void Osx_window::on_resize(const Extent& extent)
 {
-    extent_ = extent;
-    resize_signal(extent_);
+    post_({Event_type::resize, extent});
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 void Osx_window::on_key_down(Key key)
 {
-    key_down_signal(move(key));
+    post_({Event_type::key_down, {0, 0, 1}, key});
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 void Osx_window::on_key_up(Key key)
 {
-    key_up_signal(move(key));
+    post_({Event_type::key_up, {0, 0, 1}, key});
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -664,4 +674,43 @@ void Osx_window::init_window_()
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void Osx_window::init_render_thread_(const Osx_window_desc& desc)
+{
+    if (!desc.render_thread)
+        return;
+
+    render_thread_ = make_unique<Render_thread>([this](const Event& event) { dispatch_(event); },
+                                                [this]() { render_signal(); return true; });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Osx_window::post_(const Event& event)
+{
+    if (render_thread_)
+        render_thread_->post(event);
+    else
+        dispatch_(event);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Osx_window::dispatch_(const Event& event)
+{
+    switch (event.type) {
+        case Event_type::resize:
+            extent_ = event.extent;
+            resize_signal(extent_);
+            break;
+        case Event_type::key_down:
+            key_down_signal(event.key);
+            break;
+        case Event_type::key_up:
+            key_up_signal(event.key);
+            break;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 } // of namespace Platform
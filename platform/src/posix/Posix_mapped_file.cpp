@@ -0,0 +1,142 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "posix/Posix_mapped_file.h"
+
+using namespace std;
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Posix_mapped_file::Posix_mapped_file() noexcept :
+    data_ { nullptr },
+    size_ { 0 }
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Posix_mapped_file::Posix_mapped_file(const fs::path& path) :
+    data_ { nullptr },
+    size_ { 0 }
+{
+    init_mapping_(path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Posix_mapped_file::Posix_mapped_file(Posix_mapped_file&& other) noexcept :
+    data_ { other.data_ },
+    size_ { other.size_ }
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Posix_mapped_file::~Posix_mapped_file()
+{
+    term_mapping_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Posix_mapped_file& Posix_mapped_file::operator=(Posix_mapped_file&& other) noexcept
+{
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+
+    return *this;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Posix_mapped_file::advise(Access_pattern pattern) const noexcept
+{
+    if (!data_)
+        return;
+
+    switch (pattern) {
+        case Access_pattern::normal:
+            madvise(const_cast<uint8_t*>(data_), size_, MADV_NORMAL);
+            break;
+        case Access_pattern::sequential:
+            madvise(const_cast<uint8_t*>(data_), size_, MADV_SEQUENTIAL);
+            break;
+        case Access_pattern::random:
+            madvise(const_cast<uint8_t*>(data_), size_, MADV_RANDOM);
+            break;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Posix_mapped_file::prefetch(size_t offset, size_t size) const noexcept
+{
+    if (offset >= size_)
+        return;
+
+    // madvise takes an address which is aligned to a page.
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = offset / page_size * page_size;
+    const auto end = offset + min(size, size_ - offset);
+
+    madvise(const_cast<uint8_t*>(data_) + begin, end - begin, MADV_WILLNEED);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Posix_mapped_file::init_mapping_(const fs::path& path)
+{
+    auto file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file == -1)
+        throw runtime_error("fail to open " + path.string());
+
+    struct stat status;
+
+    if (fstat(file, &status) == -1) {
+        close(file);
+        throw runtime_error("fail to query " + path.string());
+    }
+
+    size_ = static_cast<size_t>(status.st_size);
+
+    // a file of zero length can't be mapped.
+    if (size_) {
+        auto data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (data == MAP_FAILED) {
+            close(file);
+            throw runtime_error("fail to map " + path.string());
+        }
+
+        data_ = static_cast<const uint8_t*>(data);
+    }
+
+    // the mapping keeps a reference to the file.
+    close(file);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Posix_mapped_file::term_mapping_() noexcept
+{
+    if (data_)
+        munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
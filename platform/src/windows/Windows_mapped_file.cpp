@@ -0,0 +1,133 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "windows/Windows_mapped_file.h"
+
+using namespace std;
+
+namespace Platform {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Windows_mapped_file::Windows_mapped_file() noexcept :
+    data_ { nullptr },
+    size_ { 0 }
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Windows_mapped_file::Windows_mapped_file(const fs::path& path) :
+    data_ { nullptr },
+    size_ { 0 }
+{
+    init_mapping_(path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Windows_mapped_file::Windows_mapped_file(Windows_mapped_file&& other) noexcept :
+    data_ { other.data_ },
+    size_ { other.size_ }
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Windows_mapped_file::~Windows_mapped_file()
+{
+    term_mapping_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Windows_mapped_file& Windows_mapped_file::operator=(Windows_mapped_file&& other) noexcept
+{
+    swap(data_, other.data_);
+    swap(size_, other.size_);
+
+    return *this;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_mapped_file::advise(Access_pattern pattern) const noexcept
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_mapped_file::prefetch(size_t offset, size_t size) const noexcept
+{
+    if (offset >= size_)
+        return;
+
+    WIN32_MEMORY_RANGE_ENTRY range;
+
+    range.VirtualAddress = const_cast<uint8_t*>(data_) + offset;
+    range.NumberOfBytes = min(size, size_ - offset);
+
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_mapped_file::init_mapping_(const fs::path& path)
+{
+    // assets are mostly read from the start to the end.
+    auto file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+        throw runtime_error("fail to open " + path.string());
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw runtime_error("fail to query " + path.string());
+    }
+
+    size_ = static_cast<size_t>(size.QuadPart);
+
+    // a file of zero length can't be mapped.
+    if (size_) {
+        auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (!mapping) {
+            CloseHandle(file);
+            throw runtime_error("fail to map " + path.string());
+        }
+
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+        // the view keeps a reference to the mapping and the file.
+        CloseHandle(mapping);
+
+        if (!data_) {
+            CloseHandle(file);
+            throw runtime_error("fail to map " + path.string());
+        }
+    }
+
+    CloseHandle(file);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_mapped_file::term_mapping_() noexcept
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Platform
@@ -3,6 +3,7 @@
 // See "LICENSE" for license information.
 //
 
+#include <optional>
 #include "windows/Windows_window.h"
 #include <combaseapi.h>
 
@@ -28,14 +29,54 @@ inline std::wstring unique_class_name()
 
 //----------------------------------------------------------------------------------------------------------------------
 
+inline optional<Key> to_key(WPARAM key_code)
+{
+    // the keys are declared in the order of the keyboard layout.
+    constexpr char letters[] {"QWERTYUIOPASDFGHJKLZXCVBNM"};
+
+    if (key_code >= '1' && key_code <= '9')
+        return static_cast<Key>(key_code - '1');
+
+    if (key_code == '0')
+        return Key::zero;
+
+    for (auto i = 0; letters[i]; ++i) {
+        if (key_code == static_cast<WPARAM>(letters[i]))
+            return static_cast<Key>(static_cast<int>(Key::q) + i);
+    }
+
+    return nullopt;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 LRESULT CALLBACK window_proc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
     auto window = reinterpret_cast<Windows_window*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
 
+    if (!window)
+        return DefWindowProc(hWnd, uMsg, wParam, lParam);
+
     switch (uMsg) {
         case WM_PAINT:
-            window->render_signal();
+            window->on_render();
             return 0;
+        case WM_SIZE:
+            if (wParam != SIZE_MINIMIZED)
+                window->on_resize({ LOWORD(lParam), HIWORD(lParam), 1 });
+            return 0;
+        case WM_KEYDOWN:
+            if (auto key = to_key(wParam)) {
+                window->on_key_down(*key);
+                return 0;
+            }
+            return DefWindowProc(hWnd, uMsg, wParam, lParam);
+        case WM_KEYUP:
+            if (auto key = to_key(wParam)) {
+                window->on_key_up(*key);
+                return 0;
+            }
+            return DefWindowProc(hWnd, uMsg, wParam, lParam);
         case WM_CLOSE:
             PostQuitMessage(0);
             return 0;
@@ -58,10 +99,12 @@ namespace Platform {
 Windows_window::Windows_window(const Windows_window_desc& desc) :
     title_ {desc.title},
     atom_ {NULL},
-    window_{NULL}
+    window_{NULL},
+    render_thread_ {}
 {
     init_atom_();
     init_window_(desc);
+    init_render_thread_(desc);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -79,12 +122,50 @@ void Windows_window::run()
     startup_signal();
     ShowWindow(window_, SW_SHOW);
 
+    if (render_thread_)
+        render_thread_->start();
+
     MSG msg;
 
     while (GetMessage(&msg, nullptr, 0, 0)) {
         TranslateMessage(&msg);
         DispatchMessage(&msg);
     }
+
+    if (render_thread_)
+        render_thread_->stop();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_window::on_render()
+{
+    // a valid client area stops WM_PAINT while the render thread renders frames.
+    if (render_thread_)
+        ValidateRect(window_, nullptr);
+    else
+        render_signal();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_window::on_resize(const Extent& extent)
+{
+    post_({Event_type::resize, extent});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_window::on_key_down(Key key)
+{
+    post_({Event_type::key_down, {0, 0, 1}, key});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_window::on_key_up(Key key)
+{
+    post_({Event_type::key_up, {0, 0, 1}, key});
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -156,6 +237,17 @@ void Windows_window::init_window_(const Windows_window_desc& desc)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void Windows_window::init_render_thread_(const Windows_window_desc& desc)
+{
+    if (!desc.render_thread)
+        return;
+
+    render_thread_ = make_unique<Render_thread>([this](const Event& event) { dispatch_(event); },
+                                                [this]() { render_signal(); return true; });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void Windows_window::term_atom_()
 {
     UnregisterClass(MAKEINTATOM(atom_), GetModuleHandle(NULL));
@@ -170,4 +262,31 @@ void Windows_window::term_window_()
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void Windows_window::post_(const Event& event)
+{
+    if (render_thread_)
+        render_thread_->post(event);
+    else
+        dispatch_(event);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Windows_window::dispatch_(const Event& event)
+{
+    switch (event.type) {
+        case Event_type::resize:
+            resize_signal(event.extent);
+            break;
+        case Event_type::key_down:
+            key_down_signal(event.key);
+            break;
+        case Event_type::key_up:
+            key_up_signal(event.key);
+            break;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 } // of namespace Platform
@@ -0,0 +1,107 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdint>
+#include <vector>
+#include <doctest.h>
+#include <platform/Frame_arena.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+TEST_SUITE_BEGIN("frame arena test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+// counts the allocations which reach the heap.
+class Counting_resource final : public pmr::memory_resource {
+public:
+    uint32_t count {0};
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override
+    {
+        ++count;
+        return pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* pointer, size_t size, size_t alignment) override
+    {
+        pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("allocate aligned memory")
+{
+    Frame_arena arena {1024};
+
+    auto a = arena.allocate(3, 1);
+    auto b = arena.allocate(16, 16);
+    auto c = arena.allocate(8, 8);
+
+    REQUIRE(reinterpret_cast<uintptr_t>(b) % 16 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(c) % 8 == 0);
+    REQUIRE(a != b);
+    REQUIRE(arena.used() >= 27);
+    REQUIRE(arena.overflow_count() == 0);
+
+    arena.reset();
+
+    REQUIRE(arena.used() == 0);
+    REQUIRE(arena.allocate(3, 1) == a);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("grow after a frame overflows")
+{
+    Counting_resource upstream;
+    Frame_arena arena {64, &upstream};
+
+    REQUIRE(upstream.count == 1);
+
+    auto frame = [&arena]() {
+        arena.reset();
+
+        pmr::vector<uint32_t> values {&arena};
+
+        for (auto i = 0; i != 100; ++i)
+            values.push_back(i);
+    };
+
+    // the first frame overflows and the next reset grows the arena.
+    frame();
+
+    REQUIRE(arena.overflow_count() > 0);
+
+    frame();
+
+    REQUIRE(arena.capacity() > 64);
+    REQUIRE(arena.overflow_count() == 0);
+
+    // steady frames don't allocate from the upstream.
+    auto count = upstream.count;
+
+    for (auto i = 0; i != 10; ++i)
+        frame();
+
+    REQUIRE(upstream.count == count);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
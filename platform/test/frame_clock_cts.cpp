@@ -0,0 +1,56 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <doctest.h>
+#include <platform/Frame_clock.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+TEST_SUITE_BEGIN("frame clock test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("advance in fixed steps")
+{
+    Frame_clock clock {0.25, 1.0};
+
+    REQUIRE(clock.advance(0.625) == 2);
+    REQUIRE(clock.time() == Approx(0.5));
+    REQUIRE(clock.alpha() == Approx(0.5));
+
+    REQUIRE(clock.advance(0.125) == 1);
+    REQUIRE(clock.time() == Approx(0.75));
+    REQUIRE(clock.alpha() == Approx(0.0));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("clamp a long frame")
+{
+    Frame_clock clock {0.01, 0.1};
+
+    REQUIRE(clock.advance(5.0) == 10);
+    REQUIRE(clock.frame_time() == Approx(0.1));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("reset a clock")
+{
+    Frame_clock clock {0.1};
+
+    clock.advance(0.35);
+    clock.reset();
+
+    REQUIRE(clock.time() == 0.0);
+    REQUIRE(clock.alpha() == 0.0);
+    REQUIRE(clock.step_count() == 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
@@ -0,0 +1,61 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <thread>
+#include <doctest.h>
+#include <platform/Frame_loop.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Frame_data {
+    uint32_t index {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+TEST_SUITE_BEGIN("frame loop test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("render frames in order")
+{
+    Job_system job_system {Job_system_desc {1}};
+    vector<uint32_t> indices;
+    auto render_id = this_thread::get_id();
+    auto update_count = 0;
+
+    {
+        Frame_loop<Frame_data> frame_loop {
+            job_system,
+            [&](const Frame_data& frame, Frame_data& next_frame, const Frame_clock&) {
+                next_frame.index = frame.index + 1;
+                ++update_count;
+            },
+            [&](const Frame_data& frame) {
+                REQUIRE(this_thread::get_id() == render_id);
+                indices.push_back(frame.index);
+            }
+        };
+
+        for (auto i = 0; i != 5; ++i)
+            frame_loop.run_frame();
+    }
+
+    // the update of the frame after the last one is in flight when the loop is destroyed.
+    REQUIRE(indices == vector<uint32_t> {1, 2, 3, 4, 5});
+    REQUIRE(update_count == 6);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
@@ -0,0 +1,218 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdlib>
+#include <thread>
+#include <doctest.h>
+#include <platform/Window.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const wstring default_title = L"headless window test suite";
+const Extent default_extent = {256, 256, 1};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // namespace of
+
+TEST_SUITE_BEGIN("headless window test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("run a fixed number of frames")
+{
+    Headless_window_desc desc;
+
+    desc.title = default_title;
+    desc.extent = default_extent;
+    desc.frame_count = 10;
+
+    Headless_window window {desc};
+    auto startup_count = 0;
+    auto render_count = 0;
+    auto shutdown_count = 0;
+
+    window.startup_signal.connect([&]() { ++startup_count; });
+    window.render_signal.connect([&]() { ++render_count; });
+    window.shutdown_signal.connect([&]() { ++shutdown_count; });
+    window.run();
+
+    REQUIRE(startup_count == 1);
+    REQUIRE(render_count == 10);
+    REQUIRE(shutdown_count == 1);
+    REQUIRE(window.frame_count() == 10);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("run frames at a fixed rate")
+{
+    Headless_window_desc desc;
+
+    desc.extent = default_extent;
+    desc.frame_count = 5;
+    desc.frame_rate = 100.0;
+
+    Headless_window window {desc};
+
+    window.run();
+
+    REQUIRE(window.frame_count() == 5);
+    REQUIRE(window.elapsed_time() >= 0.04);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("override a description by the environment")
+{
+    Headless_window_desc desc;
+
+    desc.extent = default_extent;
+    desc.frame_count = 5;
+
+    setenv("HEADLESS_FRAME_COUNT", "3", 1);
+
+    // the window doesn't read the environment, only the description.
+    Headless_window window {desc};
+
+    window.run();
+
+    REQUIRE(window.frame_count() == 5);
+
+    override_by_env(desc);
+    unsetenv("HEADLESS_FRAME_COUNT");
+
+    REQUIRE(desc.frame_count == 3);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("stop at the time budget")
+{
+    Headless_window_desc desc;
+
+    desc.extent = default_extent;
+    desc.time_budget = 0.05;
+    desc.frame_rate = 1000.0;
+
+    Headless_window window {desc};
+
+    window.run();
+
+    REQUIRE(window.frame_count() > 0);
+    REQUIRE(window.elapsed_time() >= 0.05);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("close a window while rendering")
+{
+    Headless_window_desc desc;
+
+    desc.extent = default_extent;
+
+    Headless_window window {desc};
+
+    window.render_signal.connect([&]() {
+        if (window.frame_count() == 2)
+            window.close();
+    });
+    window.run();
+
+    REQUIRE(window.frame_count() == 3);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("resize a window")
+{
+    Headless_window_desc desc;
+
+    desc.extent = default_extent;
+
+    Headless_window window {desc};
+    const Extent extent = {128, 64, 1};
+    Extent resized_extent;
+
+    window.resize_signal.connect([&](const Extent& new_extent) { resized_extent = new_extent; });
+    window.resize(extent);
+
+    REQUIRE(window.extent() == extent);
+    REQUIRE(resized_extent == extent);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("render on a render thread")
+{
+    Headless_window_desc desc;
+
+    desc.extent = default_extent;
+    desc.frame_count = 100;
+    desc.render_thread = true;
+
+    Headless_window window {desc};
+    const Extent extent = {128, 64, 1};
+    auto caller_id = this_thread::get_id();
+    thread::id render_id;
+    thread::id resize_id;
+    uint64_t resized_frame {0};
+
+    window.render_signal.connect([&]() {
+        render_id = this_thread::get_id();
+
+        // resizes from the render thread are dispatched at the start of the next frame too.
+        if (window.frame_count() == 10)
+            window.resize(extent);
+    });
+    window.resize_signal.connect([&](const Extent&) {
+        resize_id = this_thread::get_id();
+        resized_frame = window.frame_count();
+    });
+    window.run();
+
+    REQUIRE(window.frame_count() == 100);
+    REQUIRE(window.extent() == extent);
+    REQUIRE(render_id != caller_id);
+    REQUIRE(resize_id == render_id);
+    REQUIRE(resized_frame == 11);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("post more events than the queue holds from a render thread")
+{
+    Headless_window_desc desc;
+
+    desc.extent = default_extent;
+    desc.frame_count = 20;
+    desc.render_thread = true;
+
+    Headless_window window {desc};
+    uint64_t resize_count {0};
+
+    window.render_signal.connect([&]() {
+        if (window.frame_count() == 10) {
+            for (auto i = 0; i != 1000; ++i)
+                window.resize({static_cast<uint32_t>(i + 1), 64, 1});
+        }
+    });
+    window.resize_signal.connect([&](const Extent&) { ++resize_count; });
+    window.run();
+
+    REQUIRE(window.frame_count() == 20);
+    REQUIRE(window.extent() == Extent {1000, 64, 1});
+    REQUIRE(resize_count == 1000);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
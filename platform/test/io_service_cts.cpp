@@ -0,0 +1,134 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <doctest.h>
+#include <platform/Io_service.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+TEST_SUITE_BEGIN("io service test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+const string contents {"0123456789abcdef"};
+
+fs::path write_file()
+{
+    auto path = fs::temp_directory_path() / "platform_io_service.txt";
+
+    ofstream(path.string(), ios::binary) << contents;
+
+    return path;
+}
+
+// every test runs with io_uring, when it is available, and with the thread pool.
+Io_service_desc descs[] = {
+    {256, 4, true},
+    {256, 4, false}
+};
+
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("fall back to a thread pool")
+{
+    Io_service service {descs[1]};
+
+    REQUIRE(service.backend() == Io_backend::thread_pool);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("read a file with a future")
+{
+    auto path = write_file();
+
+    for (auto& desc : descs) {
+        Io_service service {desc};
+        string buffer(16, ' ');
+
+        REQUIRE(service.read({path, &buffer[0], buffer.size()}).get() == 16);
+        REQUIRE(buffer == contents);
+    }
+
+    fs::remove(path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("read a range of a file")
+{
+    auto path = write_file();
+
+    for (auto& desc : descs) {
+        Io_service service {desc};
+        string buffer(8, ' ');
+
+        REQUIRE(service.read({path, &buffer[0], 4, 10}).get() == 4);
+        REQUIRE(buffer.substr(0, 4) == "abcd");
+
+        // a read over the end of a file stops at the end.
+        REQUIRE(service.read({path, &buffer[0], 8, 12}).get() == 4);
+        REQUIRE(buffer.substr(0, 4) == "cdef");
+    }
+
+    fs::remove(path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("read many ranges with callbacks")
+{
+    auto path = write_file();
+
+    for (auto& desc : descs) {
+        Io_service service {desc};
+        vector<char> buffer(1024);
+        atomic<uint32_t> count {0};
+
+        for (auto i = 0; i != 1024; ++i) {
+            service.read({path, &buffer[i], 1, static_cast<uint64_t>(i % 16)},
+                         [&count](size_t size, error_code error) {
+                             if (size == 1 && !error)
+                                 ++count;
+                         });
+        }
+
+        service.wait();
+
+        REQUIRE(count == 1024);
+
+        for (auto i = 0; i != 1024; ++i)
+            REQUIRE(buffer[i] == contents[i % 16]);
+    }
+
+    fs::remove(path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("fail to read a missing file")
+{
+    for (auto& desc : descs) {
+        Io_service service {desc};
+        char buffer[4];
+
+        REQUIRE_THROWS(service.read({fs::temp_directory_path() / "platform_missing_io_service.txt",
+                                     buffer, sizeof(buffer)}).get());
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
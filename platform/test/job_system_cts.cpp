@@ -0,0 +1,178 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <memory>
+#include <thread>
+#include <doctest.h>
+#include <platform/Job_system.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+TEST_SUITE_BEGIN("job system test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("wait for jobs")
+{
+    Job_system job_system;
+    Job_counter counter;
+    atomic<uint32_t> sum {0};
+
+    REQUIRE(job_system.thread_count() > 0);
+
+    for (auto i = 0; i != 10000; ++i)
+        job_system.schedule([&sum]() { sum.fetch_add(1); }, &counter);
+
+    job_system.wait(counter);
+
+    REQUIRE(counter.done());
+    REQUIRE(sum == 10000);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("run a job after its dependency")
+{
+    Job_system job_system {Job_system_desc {4}};
+    Job_counter first_counter;
+    Job_counter second_counter;
+    atomic<uint32_t> first_sum {0};
+    atomic<uint32_t> seen_sum {0};
+
+    for (auto i = 0; i != 100; ++i)
+        job_system.schedule([&first_sum]() { first_sum.fetch_add(1); }, &first_counter);
+
+    Job_desc desc;
+
+    desc.function = [&]() { seen_sum = first_sum.load(); };
+    desc.counter = &second_counter;
+    desc.dependency = &first_counter;
+
+    job_system.schedule(desc);
+    job_system.wait(second_counter);
+
+    REQUIRE(seen_sum == 100);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("schedule and wait in jobs")
+{
+    Job_system job_system {Job_system_desc {2}};
+    Job_counter counter;
+    atomic<uint32_t> sum {0};
+
+    for (auto i = 0; i != 16; ++i) {
+        job_system.schedule([&]() {
+            Job_counter child_counter;
+
+            for (auto j = 0; j != 64; ++j)
+                job_system.schedule([&sum]() { sum.fetch_add(1); }, &child_counter);
+
+            job_system.wait(child_counter);
+        }, &counter);
+    }
+
+    job_system.wait(counter);
+
+    REQUIRE(sum == 16 * 64);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("run jobs with core type hints")
+{
+    Job_system job_system {Job_system_desc {2, true, true}};
+    Job_counter counter;
+    atomic<uint32_t> sum {0};
+
+    for (auto core_type : {Core_type::any, Core_type::performance, Core_type::efficiency}) {
+        Job_desc desc;
+
+        desc.function = [&sum]() { sum.fetch_add(1); };
+        desc.counter = &counter;
+        desc.core_type = core_type;
+
+        job_system.schedule(desc);
+    }
+
+    job_system.wait(counter);
+
+    REQUIRE(sum == 3);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("wait for jobs with core types from a thread which isn't a worker")
+{
+    Job_system job_system {Job_system_desc {2, true, true}};
+    Job_counter counter;
+    atomic<uint32_t> sum {0};
+
+    thread waiter {[&]() {
+        for (auto i = 0; i != 1000; ++i) {
+            Job_desc desc;
+
+            desc.function = [&sum]() { sum.fetch_add(1); };
+            desc.counter = &counter;
+            desc.core_type = i % 2 ? Core_type::performance : Core_type::efficiency;
+
+            job_system.schedule(desc);
+        }
+
+        job_system.wait(counter);
+    }};
+
+    waiter.join();
+
+    REQUIRE(sum == 1000);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("schedule more jobs than the pool holds")
+{
+    Job_system_desc desc;
+
+    desc.thread_count = 2;
+    desc.job_capacity = 16;
+
+    Job_system job_system {desc};
+    Job_counter counter;
+    atomic<uint32_t> sum {0};
+
+    for (auto i = 0; i != 1000; ++i)
+        job_system.schedule([&sum]() { sum.fetch_add(1); }, &counter);
+
+    job_system.wait(counter);
+
+    REQUIRE(sum == 1000);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("copy a job function")
+{
+    auto count = make_shared<uint32_t>(0);
+    Job_function function {[count]() { ++*count; }};
+    auto copy = function;
+
+    function();
+    copy();
+
+    REQUIRE(*count == 2);
+    REQUIRE(count.use_count() == 3);
+
+    function.reset();
+
+    REQUIRE(!function);
+    REQUIRE(count.use_count() == 2);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
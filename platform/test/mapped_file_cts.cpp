@@ -0,0 +1,101 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <fstream>
+#include <string>
+#include <doctest.h>
+#include <platform/Mapped_file.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+TEST_SUITE_BEGIN("mapped file test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+fs::path write_file(const string& name, const string& contents)
+{
+    auto path = fs::temp_directory_path() / name;
+
+    ofstream(path.string(), ios::binary) << contents;
+
+    return path;
+}
+
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("map a file")
+{
+    auto contents = string(64 * 1024, 'a') + "end";
+    auto path = write_file("platform_mapped_file.txt", contents);
+
+    {
+        Mapped_file file {path};
+
+        file.advise(Access_pattern::sequential);
+        file.prefetch();
+        file.prefetch(60 * 1024, 4 * 1024);
+
+        REQUIRE(file.size() == contents.size());
+        REQUIRE(file.view() == contents);
+    }
+
+    fs::remove(path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("map an empty file")
+{
+    auto path = write_file("platform_empty_mapped_file.txt", "");
+
+    {
+        Mapped_file file {path};
+
+        file.prefetch();
+
+        REQUIRE(file.empty());
+        REQUIRE(file.view().empty());
+    }
+
+    fs::remove(path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("move a mapped file")
+{
+    auto path = write_file("platform_moved_mapped_file.txt", "contents");
+
+    {
+        Mapped_file file {path};
+        Mapped_file other {move(file)};
+
+        REQUIRE(file.data() == nullptr);
+        REQUIRE(other.view() == "contents");
+
+        file = move(other);
+
+        REQUIRE(file.view() == "contents");
+    }
+
+    fs::remove(path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("fail to map a missing file")
+{
+    REQUIRE_THROWS(Mapped_file {fs::temp_directory_path() / "platform_missing_mapped_file.txt"});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
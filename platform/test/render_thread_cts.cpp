@@ -0,0 +1,43 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <vector>
+#include <doctest.h>
+#include <platform/Render_thread.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+TEST_SUITE_BEGIN("render thread test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("dispatch events in the order they are posted")
+{
+    vector<Event> events;
+    Render_thread render_thread {[&events](const Event& event) { events.push_back(event); }, []() { return false; }};
+
+    // events which are posted before the thread starts are dispatched before the first frame.
+    render_thread.post({Event_type::key_down, {0, 0, 1}, Key::one});
+    render_thread.post({Event_type::resize, {1, 1, 1}});
+    render_thread.post({Event_type::resize, {2, 2, 1}});
+    render_thread.post({Event_type::key_up, {0, 0, 1}, Key::one});
+    render_thread.post({Event_type::resize, {3, 3, 1}});
+    render_thread.start();
+    render_thread.wait();
+
+    REQUIRE(events.size() == 4);
+    CHECK(events[0].type == Event_type::key_down);
+    CHECK(events[1].type == Event_type::resize);
+    CHECK(events[1].extent == Extent {2, 2, 1});
+    CHECK(events[2].type == Event_type::key_up);
+    CHECK(events[3].type == Event_type::resize);
+    CHECK(events[3].extent == Extent {3, 3, 1});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
@@ -0,0 +1,95 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <doctest.h>
+#include <platform/Signal.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Listener {
+    void on_value(int value)
+    { sum += value; }
+
+    int sum {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+TEST_SUITE_BEGIN("signal test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("emit to slots in order")
+{
+    Signal<void(int)> signal;
+    Listener listener;
+    vector<int> values;
+
+    signal.connect([&values](int value) { values.push_back(value); });
+    signal.connect(&listener, &Listener::on_value);
+    signal.connect([&values](int value) { values.push_back(value * 2); });
+
+    signal(3);
+
+    REQUIRE(values == vector<int> {3, 6});
+    REQUIRE(listener.sum == 3);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("disconnect slots")
+{
+    Signal<void()> signal;
+    auto count = 0;
+    auto connection = signal.connect([&count]() { ++count; });
+
+    signal.connect([&count]() { count += 10; });
+    signal.disconnect(connection);
+    signal();
+
+    REQUIRE(count == 10);
+    REQUIRE(signal.size() == 1);
+
+    signal.clear();
+    signal();
+
+    REQUIRE(count == 10);
+    REQUIRE(signal.empty());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("modify slots while emitting")
+{
+    Signal<void()> signal;
+    auto count = 0;
+    Signal<void()>::Connection connection;
+
+    connection = signal.connect([&]() {
+        ++count;
+        signal.disconnect(connection);
+        signal.connect([&count]() { count += 10; });
+    });
+
+    signal();
+
+    REQUIRE(count == 1);
+
+    signal();
+
+    REQUIRE(count == 11);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
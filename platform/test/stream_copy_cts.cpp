@@ -0,0 +1,89 @@
+//
+// This file is part of the "platform" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <doctest.h>
+#include <platform/Stream_copy.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Platform;
+
+TEST_SUITE_BEGIN("stream copy test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+vector<uint8_t> make_bytes(size_t size)
+{
+    vector<uint8_t> bytes(size);
+
+    for (auto i = 0u; i != size; ++i)
+        bytes[i] = static_cast<uint8_t>(i * 7 + 3);
+
+    return bytes;
+}
+
+// copies at every alignment of the destination and the source, the bytes around the destination are untouched.
+void check_kernel(Copy_kernel kernel)
+{
+    for (auto size : {0u, 1u, 63u, 64u, 65u, 4096u, 100000u}) {
+        auto src = make_bytes(size + 64);
+
+        for (auto dst_offset : {0u, 1u, 17u, 63u}) {
+            for (auto src_offset : {0u, 5u, 32u}) {
+                vector<uint8_t> dst(size + 128, 0xcd);
+
+                stream_copy(&dst[dst_offset], &src[src_offset], size, kernel);
+
+                REQUIRE(memcmp(&dst[dst_offset], &src[src_offset], size) == 0);
+
+                for (auto i = 0u; i != dst_offset; ++i)
+                    REQUIRE(dst[i] == 0xcd);
+
+                for (auto i = dst_offset + size; i != dst.size(); ++i)
+                    REQUIRE(dst[i] == 0xcd);
+            }
+        }
+    }
+}
+
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("copy with the kernel of the cpu")
+{
+    check_kernel(stream_copy_kernel());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("copy with memcpy")
+{
+    check_kernel(Copy_kernel::memcpy);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("copy over the threshold")
+{
+    auto src = make_bytes(stream_copy_threshold * 2 + 3);
+
+    for (auto write_combined : {true, false}) {
+        vector<uint8_t> dst(src.size());
+
+        stream_copy(&dst[0], &src[0], src.size(), write_combined);
+
+        REQUIRE(dst == src);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
@@ -0,0 +1,53 @@
+//
+// This file is part of the "sc" project
+// See "LICENSE" for license information.
+//
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <sc/Cpu_kernel.h>
+
+using namespace std;
+using namespace Sc;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    constexpr auto group_size = 64u;
+    constexpr auto group_count = 4096u;
+
+    try {
+        Cpu_kernel kernel {SC_CPU_DEMO_KERNEL};
+
+        vector<float> values(group_size * group_count, 1.0f);
+        auto data = &values[0];
+        auto scale = 2.0f;
+
+        kernel.resource(0, 0, data, values.size() * sizeof(float));
+        kernel.push_constant(&scale, sizeof(scale));
+
+        auto begin = chrono::steady_clock::now();
+
+        kernel.dispatch(group_count, 1, 1);
+
+        auto end = chrono::steady_clock::now();
+
+        for (auto& value : values)
+            assert(value == 2.0f);
+
+        cout << "threads : " << kernel.thread_count() << '\n'
+             << "workgroups : " << group_count << '\n'
+             << "time : " << chrono::duration<double, milli>(end - begin).count() << " ms" << endl;
+    }
+    catch(exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
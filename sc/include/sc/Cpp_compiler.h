@@ -0,0 +1,26 @@
+//
+// This file is part of the "sc" project
+// See "LICENSE" for license information.
+//
+
+#ifndef SC_CPP_COMPILER_GUARD
+#define SC_CPP_COMPILER_GUARD
+
+#include <string>
+#include <vector>
+#include "enums.h"
+
+namespace Sc {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Cpp_compiler final {
+public:
+    std::string compile(const std::vector<uint32_t>& src);
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // of namespace Sc
+
+#endif // SC_CPP_COMPILER_GUARD
@@ -0,0 +1,86 @@
+//
+// This file is part of the "sc" project
+// See "LICENSE" for license information.
+//
+
+#ifndef SC_CPU_KERNEL_GUARD
+#define SC_CPU_KERNEL_GUARD
+
+#include <array>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <spirv_cross/external_interface.h>
+#include <platform/Library.h>
+#include <ghc/filesystem.hpp>
+
+namespace Sc {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace fs = ghc::filesystem;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Cpu_kernel final {
+public:
+    explicit Cpu_kernel(const fs::path& path);
+
+    Cpu_kernel(const fs::path& path, uint32_t thread_count);
+
+    ~Cpu_kernel();
+
+    void resource(uint32_t set, uint32_t binding, void* data, size_t size);
+
+    void push_constant(void* data, size_t size);
+
+    void dispatch(uint32_t x, uint32_t y, uint32_t z);
+
+    inline auto thread_count() const noexcept
+    { return static_cast<uint32_t>(workers_.size()); }
+
+private:
+    struct Invocation_ {
+        spirv_cross_shader_t* shader {nullptr};
+        std::array<uint32_t, 3> group_id {0, 0, 0};
+    };
+
+    void init_symbols_();
+
+    void init_invocations_(uint32_t thread_count);
+
+    void init_workers_();
+
+    void term_workers_();
+
+    void term_invocations_();
+
+    void run_worker_(uint32_t index);
+
+private:
+    ::Platform::Library library_;
+    const spirv_cross_interface* interface_;
+    void (*set_resource_)(spirv_cross_shader_t*, unsigned, unsigned, void**, size_t);
+    void (*set_push_constant_)(spirv_cross_shader_t*, void*, size_t);
+    void (*set_builtin_)(spirv_cross_shader_t*, spirv_cross_builtin, void*, size_t);
+    std::map<std::pair<uint32_t, uint32_t>, void*> resources_;
+    std::vector<Invocation_> invocations_;
+    std::array<uint32_t, 3> group_count_;
+    std::atomic<uint32_t> next_group_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable dispatch_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_;
+    uint32_t pending_;
+    bool running_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Sc
+
+#endif // SC_CPU_KERNEL_GUARD
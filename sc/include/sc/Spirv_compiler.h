@@ -6,8 +6,10 @@
 #ifndef SC_SPIRV_COMPILER_GUARD
 #define SC_SPIRV_COMPILER_GUARD
 
+#include <string_view>
 #include <vector>
 #include <ghc/filesystem.hpp>
+#include <platform/Mapped_file.h>
 #include "enums.h"
 #include "Preamble.h"
 
@@ -49,12 +51,12 @@ public:
 
 private:
     [[nodiscard]]
-    std::string read_(const fs::path& path) const;
+    ::Platform::Mapped_file read_(const fs::path& path) const;
 
     [[nodiscard]]
-    std::vector<uint32_t> compile_(Shader_type type, const std::string& src) const;
+    std::vector<uint32_t> compile_(Shader_type type, std::string_view src) const;
 
-    void optimize_(std::vector<uint32_t>& source);
+    void optimize_(std::vector<uint32_t>& source) const;
 
 private:
     Spirv_compiler_configs configs_;
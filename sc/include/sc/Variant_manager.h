@@ -0,0 +1,109 @@
+//
+// This file is part of the "sc" project
+// See "LICENSE" for license information.
+//
+
+#ifndef SC_VARIANT_MANAGER_GUARD
+#define SC_VARIANT_MANAGER_GUARD
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include "enums.h"
+#include "Preamble.h"
+#include "Spirv_compiler.h"
+
+namespace Sc {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Shader_desc final {
+    Shader_type type;
+    std::string src;
+    Preamble fallback;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// identifies a variant without building its key, it stays valid for the lifetime of the manager.
+using Variant_id = uint32_t;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Variant final {
+    std::shared_ptr<const std::vector<uint32_t>> spirv;
+    bool exact {false};
+    // the error of the background compile, it is reported by the first call after the compile failed.
+    std::string error;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Variant_manager final {
+public:
+    Variant_manager();
+
+    explicit Variant_manager(const Spirv_compiler_configs& configs);
+
+    ~Variant_manager();
+
+    void add_shader(const std::string& name, const Shader_desc& desc);
+
+    // registers the variant and queues it to be compiled in the background, a registered variant isn't queued again.
+    Variant_id variant_id(const std::string& name, const Preamble& preamble);
+
+    // returns the exact variant when it is compiled, otherwise the fallback of the shader.
+    // when the compile fails, the fallback is returned from then on.
+    Variant variant(Variant_id id);
+
+    Variant variant(const std::string& name, const Preamble& preamble);
+
+    void wait_idle();
+
+private:
+    struct Entry_ {
+        std::shared_ptr<const std::vector<uint32_t>> spirv;
+        std::shared_ptr<const std::vector<uint32_t>> fallback;
+        std::string error;
+        bool reported {false};
+    };
+
+    struct Job_ {
+        Variant_id id;
+        Shader_type type;
+        std::string src;
+        Preamble preamble;
+    };
+
+    void init_worker_();
+
+    void term_worker_();
+
+    void run_worker_();
+
+private:
+    Spirv_compiler_configs configs_;
+    Spirv_compiler compiler_;
+    std::unordered_map<std::string, Shader_desc> shaders_;
+    std::unordered_map<std::string, std::shared_ptr<const std::vector<uint32_t>>> fallbacks_;
+    std::unordered_map<std::string, Variant_id> ids_;
+    std::vector<Entry_> variants_;
+    std::deque<Job_> jobs_;
+    std::mutex mutex_;
+    std::condition_variable job_cv_;
+    std::condition_variable idle_cv_;
+    bool busy_;
+    bool running_;
+    std::thread worker_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Sc
+
+#endif // SC_VARIANT_MANAGER_GUARD
@@ -0,0 +1,36 @@
+//
+// This file is part of the "sc" project
+// See "LICENSE" for license information.
+//
+
+#include <stdexcept>
+#include <spirv_cross/spirv_cpp.hpp>
+#include "std_lib.h"
+#include "Cpp_compiler.h"
+
+using namespace std;
+using namespace spv;
+using namespace spirv_cross;
+
+namespace Sc {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string Cpp_compiler::compile(const std::vector<uint32_t>& src)
+{
+    CompilerCPP compiler(src);
+
+    // only compute shaders can be executed by the runtime.
+    if (ExecutionModelGLCompute != compiler.get_execution_model())
+        throw runtime_error("fail to compile a non compute shader to C++");
+
+    // compile to C++ from SPIRV.
+    auto output = compiler.compile();
+
+    assert(!output.empty());
+    return output;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Sc
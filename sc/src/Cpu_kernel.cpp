@@ -0,0 +1,193 @@
+//
+// This file is part of the "sc" project
+// See "LICENSE" for license information.
+//
+
+#include <stdexcept>
+#include "std_lib.h"
+#include "Cpu_kernel.h"
+
+using namespace std;
+
+namespace Sc {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Cpu_kernel::Cpu_kernel(const fs::path& path) :
+    Cpu_kernel(path, max(thread::hardware_concurrency(), 1u))
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Cpu_kernel::Cpu_kernel(const fs::path& path, uint32_t thread_count) :
+    library_ {path},
+    interface_ {nullptr},
+    set_resource_ {nullptr},
+    set_push_constant_ {nullptr},
+    set_builtin_ {nullptr},
+    resources_ {},
+    invocations_ {},
+    group_count_ {0, 0, 0},
+    next_group_ {0},
+    workers_ {},
+    generation_ {0},
+    pending_ {0},
+    running_ {false}
+{
+    init_symbols_();
+    init_invocations_(thread_count);
+    init_workers_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Cpu_kernel::~Cpu_kernel()
+{
+    term_workers_();
+    term_invocations_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::resource(uint32_t set, uint32_t binding, void* data, size_t size)
+{
+    // the runtime keeps a pointer to the pointer so it has to live as long as the kernel.
+    auto& ptr = resources_[{set, binding}];
+
+    ptr = data;
+
+    for (auto& invocation : invocations_)
+        set_resource_(invocation.shader, set, binding, &ptr, size);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::push_constant(void* data, size_t size)
+{
+    for (auto& invocation : invocations_)
+        set_push_constant_(invocation.shader, data, size);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::dispatch(uint32_t x, uint32_t y, uint32_t z)
+{
+    if (!x || !y || !z)
+        return;
+
+    unique_lock<mutex> lock {mutex_};
+
+    group_count_ = {x, y, z};
+    next_group_ = 0;
+    pending_ = static_cast<uint32_t>(workers_.size());
+    ++generation_;
+    dispatch_cv_.notify_all();
+
+    done_cv_.wait(lock, [this]() { return !pending_; });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::init_symbols_()
+{
+    auto get_interface = library_.symbol<const spirv_cross_interface* (*)()>("spirv_cross_get_interface");
+
+    set_resource_ = library_.symbol<decltype(set_resource_)>("spirv_cross_set_resource");
+    set_push_constant_ = library_.symbol<decltype(set_push_constant_)>("spirv_cross_set_push_constant");
+    set_builtin_ = library_.symbol<decltype(set_builtin_)>("spirv_cross_set_builtin");
+
+    if (!get_interface || !set_resource_ || !set_push_constant_ || !set_builtin_)
+        throw runtime_error("fail to load a cpu kernel");
+
+    interface_ = get_interface();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::init_invocations_(uint32_t thread_count)
+{
+    // each worker owns a shader because builtins are a state of the shader.
+    invocations_.resize(max(thread_count, 1u));
+
+    for (auto& invocation : invocations_) {
+        invocation.shader = interface_->construct();
+        set_builtin_(invocation.shader, SPIRV_CROSS_BUILTIN_NUM_WORK_GROUPS,
+                     &group_count_[0], sizeof(group_count_));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::init_workers_()
+{
+    running_ = true;
+
+    for (auto i = 0u; i != invocations_.size(); ++i)
+        workers_.emplace_back(&Cpu_kernel::run_worker_, this, i);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::term_workers_()
+{
+    {
+        lock_guard<mutex> lock {mutex_};
+
+        running_ = false;
+        dispatch_cv_.notify_all();
+    }
+
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::term_invocations_()
+{
+    for (auto& invocation : invocations_)
+        interface_->destruct(invocation.shader);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Cpu_kernel::run_worker_(uint32_t index)
+{
+    auto& invocation = invocations_[index];
+    uint64_t generation {0};
+
+    while (true) {
+        {
+            unique_lock<mutex> lock {mutex_};
+
+            dispatch_cv_.wait(lock, [&]() { return !running_ || generation != generation_; });
+
+            if (!running_)
+                break;
+
+            generation = generation_;
+        }
+
+        auto [x, y, z] = group_count_;
+        auto count = x * y * z;
+
+        // workgroups are handed out one at a time so fast workers steal from slow ones.
+        for (auto i = next_group_++; i < count; i = next_group_++) {
+            invocation.group_id = {i % x, (i / x) % y, i / (x * y)};
+
+            set_builtin_(invocation.shader, SPIRV_CROSS_BUILTIN_WORK_GROUP_ID,
+                         &invocation.group_id[0], sizeof(invocation.group_id));
+            interface_->invoke(invocation.shader);
+        }
+
+        lock_guard<mutex> lock {mutex_};
+
+        if (!--pending_)
+            done_cv_.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Sc
@@ -26,15 +26,17 @@ Includer::IncludeResult* Includer::includeLocal(const char* headerName,
     pathes_.emplace_back(includerName);
 
     for (auto& path : pathes_) {
-        ifstream fin(path.string() + headerName, ios::binary);
+        fs::path header_path {path.string() + headerName};
 
-        if (!fin.is_open())
+        if (!fs::is_regular_file(header_path))
             continue;
 
-        auto& src = sources_[path] = { istreambuf_iterator<char>(fin),
-                                       istreambuf_iterator<char>() };
+        // glslang reads a header with its length, so the mapping is given without a copy.
+        auto& src = sources_[path] = ::Platform::Mapped_file(header_path);
 
-        return new IncludeResult { path, &src[0], src.size(), nullptr };
+        src.advise(::Platform::Access_pattern::sequential);
+
+        return new IncludeResult { path, src.empty() ? "" : src.view().data(), src.size(), nullptr };
     }
 
     return nullptr;
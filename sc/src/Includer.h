@@ -10,6 +10,7 @@
 #include <map>
 #include <glslang/Public/ShaderLang.h>
 #include <ghc/filesystem.hpp>
+#include <platform/Mapped_file.h>
 
 namespace Sc {
 
@@ -35,7 +36,7 @@ public:
 
 private:
     std::vector<fs::path> pathes_;
-    std::map<std::string, std::string> sources_;
+    std::map<std::string, ::Platform::Mapped_file> sources_;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
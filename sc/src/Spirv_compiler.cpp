@@ -22,6 +22,7 @@ namespace {
 //----------------------------------------------------------------------------------------------------------------------
 
 constexpr auto client_semantic_version = 100;
+constexpr std::string_view include_directive {"#extension GL_GOOGLE_include_directive : enable\n"};
 constexpr TLimits default_limits {
     /* .nonInductiveForLoops = */ true,
     /* .whileLoops = */ true,
@@ -190,27 +191,17 @@ std::vector<uint32_t> Spirv_compiler::compile(Shader_type type, const std::strin
 {
     assert(!src.empty());
 
-    // add version and extensions.
-    stringstream sin;
-
-    sin << "#extension GL_GOOGLE_include_directive : enable" << '\n'
-        << src;
-
-    // compile to spirv from vksl.
-    auto output = compile_(type, sin.str());
-
-    // optimize spirv.
-    if (configs_.optimize)
-        optimize_(output);
-
-    return output;
+    return compile_(type, src);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 std::vector<uint32_t> Spirv_compiler::compile(const fs::path& path)
 {
-    return compile(to_shader_type(path.extension()), read_(path));
+    // the source is parsed from the mapping, so it isn't copied.
+    auto file = read_(path);
+
+    return compile_(to_shader_type(path.extension()), file.view());
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -222,26 +213,24 @@ void Spirv_compiler::add_include_path(const fs::path& path) noexcept
 
 //----------------------------------------------------------------------------------------------------------------------
 
-std::string Spirv_compiler::read_(const fs::path& path) const
+::Platform::Mapped_file Spirv_compiler::read_(const fs::path& path) const
 {
-    // open a file.
-    ifstream fin(path, ios::binary);
+    // map a file.
+    ::Platform::Mapped_file file {path};
 
-    if (!fin.is_open())
-        throw runtime_error("fail to open " + path.string());
-
-    // read source from a file.
-    std::string src {istreambuf_iterator<char>(fin), istreambuf_iterator<char>()};
-
-    if (src.empty())
+    if (file.empty())
         throw runtime_error(path.string() + " is empty");
 
-    return src;
+    // glslang scans the source once from the start to the end.
+    file.advise(::Platform::Access_pattern::sequential);
+    file.prefetch();
+
+    return file;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-std::vector<uint32_t> Spirv_compiler::compile_(Shader_type type, const std::string& src) const
+std::vector<uint32_t> Spirv_compiler::compile_(Shader_type type, std::string_view src) const
 {
     auto language = languages[etoi(type)];
 
@@ -259,11 +248,12 @@ std::vector<uint32_t> Spirv_compiler::compile_(Shader_type type, const std::stri
     if (!tokens.empty())
         shader.setPreamble(&tokens[0]);
 
-    // set up source.
-    const auto src_ptr = &src[0];
+    // set up source, the extension is given as a string ahead of it, so the source isn't null terminated.
+    const char* strings[] = {include_directive.data(), src.data()};
+    const int lengths[] = {static_cast<int>(include_directive.size()), static_cast<int>(src.size())};
 
-    assert(src_ptr);
-    shader.setStrings(&src_ptr, 1);
+    assert(strings[1]);
+    shader.setStringsWithLengths(strings, lengths, 2);
 
     // configure include paths.
     Includer includer {include_paths_};
@@ -309,12 +299,17 @@ std::vector<uint32_t> Spirv_compiler::compile_(Shader_type type, const std::stri
     GlslangToSpv(*program.getIntermediate(language), output, nullptr, &options);
 
     assert(!output.empty());
+
+    // optimize spirv.
+    if (configs_.optimize)
+        optimize_(output);
+
     return output;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void Spirv_compiler::optimize_(std::vector<uint32_t>& source)
+void Spirv_compiler::optimize_(std::vector<uint32_t>& source) const
 {
     Optimizer optimizer {SPV_ENV_VULKAN_1_1};
 
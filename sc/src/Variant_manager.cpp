@@ -0,0 +1,219 @@
+//
+// This file is part of the "sc" project
+// See "LICENSE" for license information.
+//
+
+#include <stdexcept>
+#include <platform/build_target.h>
+#include "std_lib.h"
+#include "Variant_manager.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto to_key(const std::string& name, const Sc::Preamble& preamble)
+{
+    return name + '\n' + preamble.str();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Sc {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Variant_manager::Variant_manager() :
+#if TARGET_OS_IOS || defined(__ANDROID__)
+    Variant_manager(Spirv_compiler_configs {Platform::embeded})
+#else
+    Variant_manager(Spirv_compiler_configs {Platform::desktop})
+#endif
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Variant_manager::Variant_manager(const Spirv_compiler_configs& configs) :
+    configs_ {configs},
+    compiler_ {configs},
+    shaders_ {},
+    fallbacks_ {},
+    ids_ {},
+    variants_ {},
+    jobs_ {},
+    busy_ {false},
+    running_ {false}
+{
+    init_worker_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Variant_manager::~Variant_manager()
+{
+    term_worker_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Variant_manager::add_shader(const std::string& name, const Shader_desc& desc)
+{
+    lock_guard<mutex> lock {mutex_};
+
+    // the fallback must be available before any variant is requested.
+    compiler_.preamble(desc.fallback);
+
+    auto spirv = make_shared<const vector<uint32_t>>(compiler_.compile(desc.type, desc.src));
+
+    shaders_[name] = desc;
+    fallbacks_[name] = spirv;
+
+    auto key = to_key(name, desc.fallback);
+
+    if (auto iter = ids_.find(key); iter != ids_.end()) {
+        variants_[iter->second] = {spirv, spirv, {}, false};
+    }
+    else {
+        ids_[key] = static_cast<Variant_id>(variants_.size());
+        variants_.push_back({spirv, spirv, {}, false});
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Variant_id Variant_manager::variant_id(const std::string& name, const Preamble& preamble)
+{
+    auto key = to_key(name, preamble);
+
+    lock_guard<mutex> lock {mutex_};
+
+    if (auto iter = ids_.find(key); iter != ids_.end())
+        return iter->second;
+
+    auto shader = shaders_.find(name);
+
+    if (shader == shaders_.end())
+        throw runtime_error("fail to find a shader " + name);
+
+    auto id = static_cast<Variant_id>(variants_.size());
+
+    // the variant is pending until the worker compiles it.
+    ids_[key] = id;
+    variants_.push_back({nullptr, fallbacks_[name], {}, false});
+    jobs_.push_back({id, shader->second.type, shader->second.src, preamble});
+    job_cv_.notify_one();
+
+    return id;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Variant Variant_manager::variant(Variant_id id)
+{
+    lock_guard<mutex> lock {mutex_};
+
+    if (id >= variants_.size())
+        throw runtime_error("fail to find a variant " + to_string(id));
+
+    auto& entry = variants_[id];
+
+    if (entry.spirv)
+        return {entry.spirv, true, {}};
+
+    if (!entry.error.empty() && !entry.reported) {
+        // the error is reported once, so it is moved out instead of copied on the frame which reads it.
+        entry.reported = true;
+        return {entry.fallback, false, move(entry.error)};
+    }
+
+    return {entry.fallback, false, {}};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Variant Variant_manager::variant(const std::string& name, const Preamble& preamble)
+{
+    return variant(variant_id(name, preamble));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Variant_manager::wait_idle()
+{
+    unique_lock<mutex> lock {mutex_};
+
+    idle_cv_.wait(lock, [this]() { return jobs_.empty() && !busy_; });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Variant_manager::init_worker_()
+{
+    running_ = true;
+    worker_ = thread(&Variant_manager::run_worker_, this);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Variant_manager::term_worker_()
+{
+    {
+        lock_guard<mutex> lock {mutex_};
+
+        running_ = false;
+        job_cv_.notify_all();
+    }
+
+    if (worker_.joinable())
+        worker_.join();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Variant_manager::run_worker_()
+{
+    // the worker owns a compiler because a preamble is a state of the compiler.
+    Spirv_compiler compiler {configs_};
+
+    unique_lock<mutex> lock {mutex_};
+
+    while (true) {
+        job_cv_.wait(lock, [this]() { return !running_ || !jobs_.empty(); });
+
+        if (!running_)
+            break;
+
+        auto job = move(jobs_.front());
+
+        jobs_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        Entry_ entry;
+
+        try {
+            compiler.preamble(job.preamble);
+            entry.spirv = make_shared<const vector<uint32_t>>(compiler.compile(job.type, job.src));
+        }
+        catch (exception& e) {
+            entry.error = e.what();
+        }
+
+        lock.lock();
+        variants_[job.id].spirv = move(entry.spirv);
+        variants_[job.id].error = move(entry.error);
+        busy_ = false;
+
+        if (jobs_.empty())
+            idle_cv_.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Sc
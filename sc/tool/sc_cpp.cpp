@@ -0,0 +1,42 @@
+//
+// This file is part of the "sc" project
+// See "LICENSE" for license information.
+//
+
+#include <fstream>
+#include <iostream>
+#include <sc/Spirv_compiler.h>
+#include <sc/Cpp_compiler.h>
+
+using namespace std;
+using namespace Sc;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        cerr << "usage : sc_cpp <compute shader> <output>" << endl;
+        return 1;
+    }
+
+    try {
+        auto spirv_src = Spirv_compiler(Spirv_compiler_configs {Platform::desktop}).compile(fs::path(argv[1]));
+        auto cpp_src = Cpp_compiler().compile(spirv_src);
+
+        ofstream fout(argv[2], ios::binary);
+
+        if (!fout.is_open())
+            throw runtime_error("fail to open " + string(argv[2]));
+
+        fout << cpp_src;
+    }
+    catch(exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_DEFRAGMENTER_GUARD
+#define VLK_DEFRAGMENTER_GUARD
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include "vlk/Memory_allocator.h"
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Defragmenter_desc {
+    // a pass which is recorded in a frame is finished when the same frame is recorded again.
+    uint32_t frames_in_flight {2};
+    // the bytes and the count of buffers which a frame moves at most.
+    VkDeviceSize frame_budget {4 * 1024 * 1024};
+    uint32_t frame_move_count {64};
+    // the fragmentation is checked every this count of frames, a defragmentation starts when this fraction of
+    // the blocks is unused.
+    uint32_t check_interval {60};
+    float unused_ratio {0.25f};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Defragmentation_stats {
+    uint64_t bytes_moved {0};
+    uint64_t bytes_freed {0};
+    uint64_t buffers_moved {0};
+    uint64_t blocks_freed {0};
+    uint64_t pass_count {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// called with the new buffer while the frame is recorded, so descriptors of the frame can refer to it.
+using Buffer_move_callback = std::function<void(VkBuffer)>;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// moves buffers out of sparse blocks a few at a time, so the blocks are freed without a hitch.
+// a move creates a new buffer at the new place and records a copy, the frame which records it uses the new buffer
+// and the old one is destroyed when the frame completes. buffers must be created with TRANSFER_SRC and TRANSFER_DST
+// and must not be mapped or written by the host after they are added. images aren't moved, their layouts and
+// tiling are unknown to the defragmenter.
+class Defragmenter final {
+public:
+    Defragmenter(Memory_allocator& allocator, const Defragmenter_desc& desc);
+
+    Defragmenter(const Defragmenter&) = delete;
+
+    // the device must be idle, the added buffers are kept.
+    ~Defragmenter();
+
+    Defragmenter& operator=(const Defragmenter&) = delete;
+
+    // the handle is replaced when the buffer is moved.
+    void add_buffer(const VkBufferCreateInfo& create_info, VkBuffer* buffer, VmaAllocation allocation,
+                    Buffer_move_callback callback = {});
+
+    // destroys a buffer which is added, the destruction is deferred while a defragmentation is in progress.
+    void destroy_buffer(VmaAllocation allocation);
+
+    // the command buffer must be recording outside of a render pass, the copies are recorded before the frame.
+    void record(VkCommandBuffer command_buffer);
+
+    inline auto stats() const noexcept
+    { return stats_; }
+
+private:
+    struct Buffer_ {
+        VkBufferCreateInfo create_info;
+        std::vector<uint32_t> queue_family_indices;
+        VkBuffer handle;
+        VkBuffer* target;
+        Buffer_move_callback callback;
+        bool destroyed;
+    };
+
+    bool is_fragmented_() const noexcept;
+
+    void begin_defragmentation_();
+
+    void end_defragmentation_();
+
+    void begin_pass_(VkCommandBuffer command_buffer);
+
+    void end_pass_();
+
+    void move_buffer_(VkCommandBuffer command_buffer, const VmaDefragmentationPassMoveInfo& move);
+
+    void update_allocations_();
+
+private:
+    Memory_allocator& allocator_;
+    const Device_table& device_table_;
+    Defragmenter_desc desc_;
+    std::unordered_map<VmaAllocation, Buffer_> buffers_;
+    std::vector<VmaAllocation> allocations_;
+    std::vector<VmaDefragmentationPassMoveInfo> moves_;
+    std::vector<VkBuffer> retired_buffers_;
+    VmaDefragmentationContext context_;
+    VmaDefragmentationStats context_stats_;
+    Defragmentation_stats stats_;
+    uint64_t frame_;
+    uint64_t pass_frame_;
+    uint64_t check_frame_;
+    bool pass_pending_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_DEFRAGMENTER_GUARD
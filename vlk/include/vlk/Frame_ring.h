@@ -0,0 +1,100 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_FRAME_RING_GUARD
+#define VLK_FRAME_RING_GUARD
+
+#include <cstdint>
+#include <memory>
+#include <vulkan/vulkan.h>
+#include "vlk/Memory_allocator.h"
+#include "vlk/Mapped_buffer.h"
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Frame_ring_desc {
+    // the bytes which a frame can sub-allocate, it is rounded up to the alignments of the device.
+    VkDeviceSize frame_size {256 * 1024};
+    uint32_t frame_count {2};
+    VkBufferUsageFlags usage {VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                              VK_BUFFER_USAGE_INDEX_BUFFER_BIT};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Ring_allocation {
+    uint8_t* data {nullptr};
+    VkBuffer buffer {VK_NULL_HANDLE};
+    // the offset in the buffer, it is the dynamic offset of a descriptor which begins at zero.
+    uint32_t offset {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// one buffer which is mapped for its lifetime and split into a region per frame in flight.
+// data which lives for a single frame is sub-allocated from the region of the frame by bumping an offset,
+// so uniforms, dynamic vertices and indices need neither their own buffers nor a map per frame.
+// uniforms are bound with VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, so one descriptor set serves every draw.
+class Frame_ring final {
+public:
+    Frame_ring(Memory_allocator& allocator, const Frame_ring_desc& desc, const char* name = nullptr);
+
+    Frame_ring(const Frame_ring&) = delete;
+
+    Frame_ring& operator=(const Frame_ring&) = delete;
+
+    // the device must be done with the previous frame which used the same index.
+    void begin_frame(uint32_t frame_index) noexcept;
+
+    // marks the sub-allocations of the frame as written, so the flush of the batch makes them visible.
+    void end_frame() noexcept;
+
+    // fails when the region of the frame is full or the alignment is zero.
+    [[nodiscard]] bool allocate(VkDeviceSize size, VkDeviceSize alignment, Ring_allocation* allocation) noexcept;
+
+    // sub-allocates at the alignment of uniform buffers and copies the data.
+    [[nodiscard]] bool write_uniform(const void* data, VkDeviceSize size, Ring_allocation* allocation) noexcept;
+
+    // sub-allocates at the given alignment and copies the data, e.g. the size of a vertex or an index.
+    [[nodiscard]] bool write(const void* data, VkDeviceSize size, VkDeviceSize alignment,
+                             Ring_allocation* allocation) noexcept;
+
+    inline auto buffer() const noexcept
+    { return mapped_buffer_->buffer(); }
+
+    inline auto& mapped_buffer() noexcept
+    { return *mapped_buffer_; }
+
+    inline auto frame_size() const noexcept
+    { return frame_size_; }
+
+    inline auto uniform_alignment() const noexcept
+    { return uniform_alignment_; }
+
+    // the bytes which the current frame has sub-allocated.
+    inline auto used() const noexcept
+    { return head_ - frame_begin_; }
+
+private:
+    void init_buffer_(const Frame_ring_desc& desc, const char* name);
+
+private:
+    Memory_allocator& allocator_;
+    VkDeviceSize uniform_alignment_;
+    VkDeviceSize frame_size_;
+    uint32_t frame_count_;
+    std::unique_ptr<Mapped_buffer> mapped_buffer_;
+    VkDeviceSize frame_begin_;
+    VkDeviceSize head_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_FRAME_RING_GUARD
@@ -0,0 +1,114 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_HOST_ALLOCATOR_GUARD
+#define VLK_HOST_ALLOCATOR_GUARD
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the host memory which the driver allocates in a scope, internal allocations are only reported by the driver.
+struct Host_allocation_stats {
+    uint64_t live_bytes {0};
+    uint64_t peak_bytes {0};
+    uint64_t live_count {0};
+    uint64_t allocation_count {0};
+    uint64_t internal_bytes {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// allocation callbacks which serve small allocations from pools of size classes and track them per scope.
+// each size class has its own lock, so threads which create objects of different sizes don't contend.
+// the allocator must outlive every object which is created with its callbacks.
+class Host_allocator final {
+public:
+    Host_allocator();
+
+    Host_allocator(const Host_allocator&) = delete;
+
+    ~Host_allocator();
+
+    Host_allocator& operator=(const Host_allocator&) = delete;
+
+    [[nodiscard]]
+    Host_allocation_stats stats(VkSystemAllocationScope scope) const noexcept;
+
+    [[nodiscard]]
+    Host_allocation_stats total_stats() const noexcept;
+
+    inline auto callbacks() const noexcept
+    { return &callbacks_; }
+
+private:
+    static constexpr uint32_t class_count_ {9};
+    static constexpr uint32_t scope_count_ {VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1};
+    static constexpr uint32_t large_class_ {class_count_};
+    static constexpr size_t chunk_size_ {64 * 1024};
+
+    struct Block_ {
+        Block_* next;
+    };
+
+    struct Pool_ {
+        std::mutex mutex;
+        Block_* blocks {nullptr};
+        std::vector<void*> chunks;
+    };
+
+    struct Stats_ {
+        std::atomic<uint64_t> live_bytes {0};
+        std::atomic<uint64_t> peak_bytes {0};
+        std::atomic<uint64_t> live_count {0};
+        std::atomic<uint64_t> allocation_count {0};
+        std::atomic<uint64_t> internal_bytes {0};
+    };
+
+    static void* VKAPI_PTR allocate_(void* user_data, size_t size, size_t alignment,
+                                     VkSystemAllocationScope scope);
+
+    static void* VKAPI_PTR reallocate_(void* user_data, void* original, size_t size, size_t alignment,
+                                       VkSystemAllocationScope scope);
+
+    static void VKAPI_PTR free_(void* user_data, void* memory);
+
+    static void VKAPI_PTR notify_internal_allocation_(void* user_data, size_t size,
+                                                      VkInternalAllocationType type,
+                                                      VkSystemAllocationScope scope);
+
+    static void VKAPI_PTR notify_internal_free_(void* user_data, size_t size,
+                                                VkInternalAllocationType type,
+                                                VkSystemAllocationScope scope);
+
+    void* allocate_(size_t size, size_t alignment, VkSystemAllocationScope scope) noexcept;
+
+    void free_(void* memory) noexcept;
+
+    void* allocate_block_(uint32_t size_class) noexcept;
+
+    void free_block_(uint32_t size_class, void* block) noexcept;
+
+    void term_pools_() noexcept;
+
+private:
+    VkAllocationCallbacks callbacks_;
+    std::array<Pool_, class_count_> pools_;
+    std::array<Stats_, scope_count_> stats_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_HOST_ALLOCATOR_GUARD
@@ -0,0 +1,59 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_HOST_IMPORTER_GUARD
+#define VLK_HOST_IMPORTER_GUARD
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+#include "vlk/Memory_allocator.h"
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Imported_buffer {
+    VkBuffer buffer {VK_NULL_HANDLE};
+    VkDeviceMemory device_memory {VK_NULL_HANDLE};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// wraps host memory with VK_EXT_external_memory_host, so the device reads it without a staging copy.
+// the device must be created with VK_EXT_external_memory_host and VK_KHR_external_memory, and the instance with
+// VK_KHR_get_physical_device_properties2 and VK_KHR_external_memory_capabilities.
+// the imported memory must stay allocated until the device is done with the buffer.
+class Host_importer final {
+public:
+    explicit Host_importer(Memory_allocator& allocator);
+
+    Host_importer(const Host_importer&) = delete;
+
+    Host_importer& operator=(const Host_importer&) = delete;
+
+    // the data and the size must be multiples of alignment(), the whole range is visible to the device.
+    // fails when the driver can't import the memory, then the data should be uploaded through a staging buffer.
+    [[nodiscard]] bool import_buffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+                                     Imported_buffer* buffer) noexcept;
+
+    void destroy_buffer(const Imported_buffer& buffer) noexcept;
+
+    inline auto alignment() const noexcept
+    { return alignment_; }
+
+private:
+    void init_alignment_();
+
+private:
+    Memory_allocator& allocator_;
+    const Device_table& device_table_;
+    VkDeviceSize alignment_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_HOST_IMPORTER_GUARD
@@ -0,0 +1,194 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_LOADER_GUARD
+#define VLK_LOADER_GUARD
+
+#if defined(__APPLE__) && !defined(VK_USE_PLATFORM_MACOS_MVK)
+#define VK_USE_PLATFORM_MACOS_MVK 1
+#elif defined(_WIN64) && !defined(VK_USE_PLATFORM_WIN32_KHR)
+#define VK_USE_PLATFORM_WIN32_KHR 1
+#endif
+
+#include <string>
+#include <vulkan/vulkan.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the functions which are resolved without an instance.
+#define VLK_GLOBAL_FUNCTIONS(X) \
+    X(vkCreateInstance) \
+    X(vkEnumerateInstanceExtensionProperties) \
+    X(vkEnumerateInstanceLayerProperties)
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+#define VLK_PLATFORM_INSTANCE_FUNCTIONS(X) \
+    X(vkCreateWin32SurfaceKHR)
+#elif defined(VK_USE_PLATFORM_MACOS_MVK)
+#define VLK_PLATFORM_INSTANCE_FUNCTIONS(X) \
+    X(vkCreateMacOSSurfaceMVK)
+#else
+#define VLK_PLATFORM_INSTANCE_FUNCTIONS(X)
+#endif
+
+// the functions of an instance and its physical devices.
+#define VLK_INSTANCE_FUNCTIONS(X) \
+    X(vkDestroyInstance) \
+    X(vkEnumeratePhysicalDevices) \
+    X(vkGetPhysicalDeviceProperties) \
+    X(vkGetPhysicalDeviceProperties2) \
+    X(vkGetPhysicalDeviceProperties2KHR) \
+    X(vkGetPhysicalDeviceFeatures) \
+    X(vkGetPhysicalDeviceFormatProperties) \
+    X(vkGetPhysicalDeviceMemoryProperties) \
+    X(vkGetPhysicalDeviceMemoryProperties2KHR) \
+    X(vkGetPhysicalDeviceQueueFamilyProperties) \
+    X(vkEnumerateDeviceExtensionProperties) \
+    X(vkCreateDevice) \
+    X(vkGetDeviceProcAddr) \
+    X(vkDestroySurfaceKHR) \
+    X(vkGetPhysicalDeviceSurfaceSupportKHR) \
+    X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR) \
+    X(vkGetPhysicalDeviceSurfaceFormatsKHR) \
+    X(vkGetPhysicalDeviceSurfacePresentModesKHR) \
+    X(vkCreateHeadlessSurfaceEXT) \
+    VLK_PLATFORM_INSTANCE_FUNCTIONS(X)
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the functions of a device and its children, vkCmd* are called the most.
+#define VLK_DEVICE_FUNCTIONS(X) \
+    X(vkDestroyDevice) \
+    X(vkGetDeviceQueue) \
+    X(vkDeviceWaitIdle) \
+    X(vkQueueSubmit) \
+    X(vkQueueWaitIdle) \
+    X(vkAllocateMemory) \
+    X(vkFreeMemory) \
+    X(vkMapMemory) \
+    X(vkUnmapMemory) \
+    X(vkFlushMappedMemoryRanges) \
+    X(vkInvalidateMappedMemoryRanges) \
+    X(vkBindBufferMemory) \
+    X(vkBindImageMemory) \
+    X(vkGetBufferMemoryRequirements) \
+    X(vkGetImageMemoryRequirements) \
+    X(vkCreateBuffer) \
+    X(vkDestroyBuffer) \
+    X(vkCreateImage) \
+    X(vkDestroyImage) \
+    X(vkCreateImageView) \
+    X(vkDestroyImageView) \
+    X(vkCreateSampler) \
+    X(vkDestroySampler) \
+    X(vkCreateShaderModule) \
+    X(vkDestroyShaderModule) \
+    X(vkCreateGraphicsPipelines) \
+    X(vkCreateComputePipelines) \
+    X(vkDestroyPipeline) \
+    X(vkCreatePipelineLayout) \
+    X(vkDestroyPipelineLayout) \
+    X(vkCreateDescriptorSetLayout) \
+    X(vkDestroyDescriptorSetLayout) \
+    X(vkCreateDescriptorPool) \
+    X(vkDestroyDescriptorPool) \
+    X(vkAllocateDescriptorSets) \
+    X(vkUpdateDescriptorSets) \
+    X(vkCreateRenderPass) \
+    X(vkDestroyRenderPass) \
+    X(vkCreateFramebuffer) \
+    X(vkDestroyFramebuffer) \
+    X(vkCreateCommandPool) \
+    X(vkDestroyCommandPool) \
+    X(vkAllocateCommandBuffers) \
+    X(vkFreeCommandBuffers) \
+    X(vkBeginCommandBuffer) \
+    X(vkEndCommandBuffer) \
+    X(vkResetCommandBuffer) \
+    X(vkCreateFence) \
+    X(vkDestroyFence) \
+    X(vkResetFences) \
+    X(vkGetFenceStatus) \
+    X(vkWaitForFences) \
+    X(vkCreateSemaphore) \
+    X(vkDestroySemaphore) \
+    X(vkCreateQueryPool) \
+    X(vkDestroyQueryPool) \
+    X(vkGetQueryPoolResults) \
+    X(vkCmdBindPipeline) \
+    X(vkCmdBindDescriptorSets) \
+    X(vkCmdBindVertexBuffers) \
+    X(vkCmdBindIndexBuffer) \
+    X(vkCmdPushConstants) \
+    X(vkCmdDraw) \
+    X(vkCmdDrawIndexed) \
+    X(vkCmdDispatch) \
+    X(vkCmdCopyBuffer) \
+    X(vkCmdCopyBufferToImage) \
+    X(vkCmdClearColorImage) \
+    X(vkCmdPipelineBarrier) \
+    X(vkCmdBeginRenderPass) \
+    X(vkCmdEndRenderPass) \
+    X(vkCmdResetQueryPool) \
+    X(vkCmdWriteTimestamp) \
+    X(vkCreateSwapchainKHR) \
+    X(vkDestroySwapchainKHR) \
+    X(vkGetSwapchainImagesKHR) \
+    X(vkAcquireNextImageKHR) \
+    X(vkQueuePresentKHR) \
+    X(vkGetMemoryHostPointerPropertiesEXT)
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the functions which are global by nature, the rest are called through the table of their instance or device.
+#define VLK_DECLARE_FUNCTION(name) extern PFN_##name name;
+
+VLK_GLOBAL_FUNCTIONS(VLK_DECLARE_FUNCTION)
+
+#undef VLK_DECLARE_FUNCTION
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define VLK_DECLARE_FUNCTION(name) PFN_##name name {nullptr};
+
+// a table per instance and device, it is owned next to its handle, so each device calls its own functions.
+// functions of a device are resolved by vkGetDeviceProcAddr, so they skip the dispatch of the loader.
+struct Instance_table {
+    VLK_INSTANCE_FUNCTIONS(VLK_DECLARE_FUNCTION)
+};
+
+struct Device_table {
+    VLK_DEVICE_FUNCTIONS(VLK_DECLARE_FUNCTION)
+};
+
+#undef VLK_DECLARE_FUNCTION
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the Vulkan loader of the system, VLK_LIBRARY overrides it.
+// the path may be an ICD such as lavapipe, which is then used without the loader.
+std::string default_library_path();
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void load_global_functions(const std::string& path = default_library_path());
+
+[[nodiscard]]
+Instance_table load_instance_table(VkInstance instance);
+
+[[nodiscard]]
+Device_table load_device_table(const Instance_table& instance_table, VkDevice device);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_LOADER_GUARD
@@ -0,0 +1,135 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_MAPPED_BUFFER_GUARD
+#define VLK_MAPPED_BUFFER_GUARD
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include "vlk/Memory_allocator.h"
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a buffer which is mapped for its lifetime and may live in non-coherent memory.
+// the host marks the ranges which it writes and reads, the ranges are merged to nonCoherentAtomSize and
+// a Flush_batch flushes or invalidates them together with the ranges of other buffers.
+class Mapped_buffer final {
+public:
+    Mapped_buffer(Memory_allocator& allocator, const VkBufferCreateInfo& create_info, Memory_access access,
+                  const char* name = nullptr,
+                  const char* file = __builtin_FILE(), uint32_t line = __builtin_LINE());
+
+    Mapped_buffer(const Mapped_buffer&) = delete;
+
+    ~Mapped_buffer();
+
+    Mapped_buffer& operator=(const Mapped_buffer&) = delete;
+
+    // copies to the buffer and marks the range as written, large copies to write-combined memory bypass the cache.
+    void write(VkDeviceSize offset, const void* data, VkDeviceSize size) noexcept;
+
+    // the range is written through data() and flushed by the next flush of the batch.
+    void mark_written(VkDeviceSize offset, VkDeviceSize size) noexcept;
+
+    // the range is written by the device and invalidated by the next invalidation of the batch.
+    void mark_read(VkDeviceSize offset, VkDeviceSize size) noexcept;
+
+    inline auto data() const noexcept
+    { return data_; }
+
+    inline auto buffer() const noexcept
+    { return buffer_; }
+
+    inline auto allocation() const noexcept
+    { return allocation_; }
+
+    inline auto size() const noexcept
+    { return size_; }
+
+    inline auto coherent() const noexcept
+    { return coherent_; }
+
+    inline auto write_combined() const noexcept
+    { return write_combined_; }
+
+private:
+    static constexpr uint32_t max_range_count_ {8};
+
+    struct Range_ {
+        VkDeviceSize begin;
+        VkDeviceSize end;
+    };
+
+    // ranges don't overlap, when they run out they are merged into one.
+    struct Ranges_ {
+        std::array<Range_, max_range_count_> ranges;
+        uint32_t count {0};
+    };
+
+    void init_buffer_(const VkBufferCreateInfo& create_info, Memory_access access, const char* name,
+                      const char* file, uint32_t line);
+
+    void term_buffer_() noexcept;
+
+    void add_range_(Ranges_& ranges, VkDeviceSize offset, VkDeviceSize size) noexcept;
+
+private:
+    Memory_allocator& allocator_;
+    VkBuffer buffer_;
+    VmaAllocation allocation_;
+    uint8_t* data_;
+    VkDeviceSize size_;
+    VkDeviceSize atom_size_;
+    bool coherent_;
+    bool write_combined_;
+    Ranges_ written_ranges_;
+    Ranges_ read_ranges_;
+
+    friend class Flush_batch;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// flushes or invalidates the marked ranges of many buffers with a single call, once per frame or per submit.
+// the batch doesn't allocate after the buffers are added.
+class Flush_batch final {
+public:
+    explicit Flush_batch(Memory_allocator& allocator);
+
+    Flush_batch(const Flush_batch&) = delete;
+
+    Flush_batch& operator=(const Flush_batch&) = delete;
+
+    void add(Mapped_buffer& buffer);
+
+    void remove(Mapped_buffer& buffer) noexcept;
+
+    // called before the submit which reads the writes of the host.
+    VkResult flush() noexcept;
+
+    // called after the fence of the submit which writes what the host reads.
+    VkResult invalidate() noexcept;
+
+private:
+    VkResult submit_(bool flush) noexcept;
+
+private:
+    Memory_allocator& allocator_;
+    std::vector<Mapped_buffer*> buffers_;
+    std::vector<VmaAllocation> allocations_;
+    std::vector<VkDeviceSize> offsets_;
+    std::vector<VkDeviceSize> sizes_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_MAPPED_BUFFER_GUARD
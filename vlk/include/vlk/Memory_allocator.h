@@ -0,0 +1,256 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_MEMORY_ALLOCATOR_GUARD
+#define VLK_MEMORY_ALLOCATOR_GUARD
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include "vlk/Loader.h"
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Memory_allocator_desc {
+    VkInstance instance {VK_NULL_HANDLE};
+    VkPhysicalDevice physical_device {VK_NULL_HANDLE};
+    VkDevice device {VK_NULL_HANDLE};
+    // the tables of the instance and the device, they must outlive the allocator.
+    const Instance_table* instance_table {nullptr};
+    const Device_table* device_table {nullptr};
+    const VkAllocationCallbacks* allocation_callbacks {nullptr};
+    // the size of blocks which resources are sub-allocated from, zero uses the default of VMA.
+    VkDeviceSize block_size {0};
+    // images which are larger than this get their own memory, so they don't leave holes in the blocks.
+    VkDeviceSize dedicated_image_size {16 * 1024 * 1024};
+    // the device is created with VK_EXT_memory_budget and the instance with VK_KHR_get_physical_device_properties2,
+    // otherwise budgets are estimated from the heap sizes.
+    bool memory_budget {false};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+enum class Memory_access : uint8_t {
+    // written once by the host and read by the device for its lifetime.
+    immutable,
+    // rewritten by the host every frame, small enough to live in the BAR.
+    dynamic,
+    // written once by the host and read once by the device, large data which shouldn't take the BAR.
+    streaming,
+    // written by the device and read by the host.
+    readback
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Allocation_desc {
+    VmaMemoryUsage usage {VMA_MEMORY_USAGE_GPU_ONLY};
+    VmaPool pool {VK_NULL_HANDLE};
+    // the owner of the allocation, it is shown in reports and JSON dumps.
+    const char* name {nullptr};
+    // limits the memory types, a placement gives the single best one.
+    uint32_t memory_type_bits {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Placement {
+    uint32_t memory_type {0};
+    bool host_visible {false};
+    // non-coherent memory must be flushed after host writes and invalidated before host reads.
+    bool host_coherent {false};
+    // the memory isn't host visible, so the contents are uploaded through a staging buffer.
+    bool staging {false};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the memory type of a pool is chosen for buffers which are like the given one.
+struct Pool_desc {
+    VkBufferCreateInfo buffer_info {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    VmaMemoryUsage usage {VMA_MEMORY_USAGE_GPU_ONLY};
+    VkDeviceSize block_size {0};
+    size_t min_block_count {0};
+    size_t max_block_count {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a fragmentation of zero means the unused bytes are one range, one means they are scattered in tiny ranges.
+struct Memory_usage {
+    uint32_t block_count {0};
+    uint32_t allocation_count {0};
+    VkDeviceSize used_bytes {0};
+    VkDeviceSize unused_bytes {0};
+    VkDeviceSize largest_free_bytes {0};
+    float fragmentation {0.0f};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Memory_report {
+    std::vector<Memory_usage> heaps;
+    std::vector<Memory_usage> types;
+    // the heap of each memory type.
+    std::vector<uint32_t> type_heaps;
+    std::vector<VkDeviceSize> heap_sizes;
+    Memory_usage total;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a live allocation and where it was made.
+struct Allocation_record {
+    std::string name;
+    const char* file {nullptr};
+    uint32_t line {0};
+    VkDeviceSize size {0};
+    uint32_t memory_type {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// sub-allocates buffers and images from large blocks of device memory, so the count of allocations stays far below
+// maxMemoryAllocationCount. the helpers which take the allocator call the device through its tables.
+class Memory_allocator final {
+public:
+    explicit Memory_allocator(const Memory_allocator_desc& desc);
+
+    Memory_allocator(const Memory_allocator&) = delete;
+
+    ~Memory_allocator();
+
+    Memory_allocator& operator=(const Memory_allocator&) = delete;
+
+    // the call site is recorded for the leak report.
+    [[nodiscard]]
+    VkResult create_buffer(const VkBufferCreateInfo& create_info, const Allocation_desc& desc,
+                           VkBuffer* buffer, VmaAllocation* allocation,
+                           const char* file = __builtin_FILE(), uint32_t line = __builtin_LINE());
+
+    // render targets and large images are dedicated, drivers may place them in faster memory.
+    [[nodiscard]]
+    VkResult create_image(const VkImageCreateInfo& create_info, const Allocation_desc& desc,
+                          VkImage* image, VmaAllocation* allocation,
+                          const char* file = __builtin_FILE(), uint32_t line = __builtin_LINE());
+
+    void destroy_buffer(VkBuffer buffer, VmaAllocation allocation) noexcept;
+
+    void destroy_image(VkImage image, VmaAllocation allocation) noexcept;
+
+    // maps are reference counted, so an allocation can be mapped while others in the same block are mapped.
+    VkResult map(VmaAllocation allocation, void** data) noexcept;
+
+    void unmap(VmaAllocation allocation) noexcept;
+
+    // the ranges of coherent allocations are skipped, the others are flushed with a single call.
+    VkResult flush(uint32_t count, const VmaAllocation* allocations,
+                   const VkDeviceSize* offsets, const VkDeviceSize* sizes) noexcept;
+
+    VkResult invalidate(uint32_t count, const VmaAllocation* allocations,
+                        const VkDeviceSize* offsets, const VkDeviceSize* sizes) noexcept;
+
+    // picks the memory type for a buffer by how it is accessed. immutable buffers are written directly when
+    // the device memory is host visible, which is ReBAR on discrete devices and always on integrated ones.
+    // the memory which the host writes is coherent unless the caller flushes, which Mapped_buffer does.
+    [[nodiscard]]
+    Placement place_buffer(const VkBufferCreateInfo& create_info, Memory_access access,
+                           bool host_flushes = false) const;
+
+    [[nodiscard]]
+    VkResult create_pool(const Pool_desc& desc, VmaPool* pool);
+
+    void destroy_pool(VmaPool pool) noexcept;
+
+    [[nodiscard]]
+    VmaPoolStats pool_stats(VmaPool pool) const noexcept;
+
+    // the statistics of the default pools per memory type and heap.
+    [[nodiscard]]
+    VmaStats stats() const noexcept;
+
+    // the usage of every heap and memory type, including custom pools.
+    [[nodiscard]]
+    Memory_report report() const;
+
+    // the JSON of VMA, the detailed map lists every allocation with its name and call site.
+    [[nodiscard]]
+    std::string dump_json(bool detailed = true) const;
+
+    // the allocations which are not destroyed yet, everything left at shutdown is a leak.
+    [[nodiscard]]
+    std::vector<Allocation_record> live_allocations() const;
+
+    // the usage and the budget of every heap, the budget is refreshed when the frame index changes.
+    [[nodiscard]]
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets() const noexcept;
+
+    void set_frame_index(uint32_t frame_index) noexcept;
+
+    [[nodiscard]]
+    uint32_t heap_count() const noexcept;
+
+    [[nodiscard]]
+    uint32_t heap_index(VmaAllocation allocation) const noexcept;
+
+    // the memory is host visible but not cached, so the host writes through the write-combining buffers.
+    [[nodiscard]]
+    bool write_combined(VmaAllocation allocation) const noexcept;
+
+    inline auto device() const noexcept
+    { return device_; }
+
+    inline const auto& instance_table() const noexcept
+    { return *instance_table_; }
+
+    inline const auto& device_table() const noexcept
+    { return *device_table_; }
+
+    inline auto allocation_callbacks() const noexcept
+    { return allocation_callbacks_; }
+
+    inline auto allocator() const noexcept
+    { return allocator_; }
+
+    inline auto non_coherent_atom_size() const noexcept
+    { return non_coherent_atom_size_; }
+
+private:
+    void init_allocator_(const Memory_allocator_desc& desc);
+
+    void term_allocator_() noexcept;
+
+    void init_device_properties_();
+
+    void add_record_(VmaAllocation allocation, const Allocation_desc& desc, const char* file, uint32_t line);
+
+    void remove_record_(VmaAllocation allocation) noexcept;
+
+private:
+    VkDevice device_;
+    const Instance_table* instance_table_;
+    const Device_table* device_table_;
+    const VkAllocationCallbacks* allocation_callbacks_;
+    VkDeviceSize dedicated_image_size_;
+    VmaAllocator allocator_;
+    bool direct_upload_;
+    VkDeviceSize non_coherent_atom_size_;
+    mutable std::mutex records_mutex_;
+    std::unordered_map<VmaAllocation, Allocation_record> records_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_MEMORY_ALLOCATOR_GUARD
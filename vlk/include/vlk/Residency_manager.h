@@ -0,0 +1,164 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_RESIDENCY_MANAGER_GUARD
+#define VLK_RESIDENCY_MANAGER_GUARD
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+#include "vlk/Memory_allocator.h"
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Residency_desc {
+    // a resource which is moved in a frame is retired when the same frame is recorded again.
+    uint32_t frames_in_flight {2};
+    // eviction starts when the usage of a heap is above the high fraction of its budget and stops below the low one.
+    float high_watermark {0.9f};
+    float low_watermark {0.8f};
+    // resources which are used in this count of recent frames aren't evicted.
+    uint32_t min_idle_frames {8};
+    // the bytes which a frame restores at most, so restores don't stall a frame.
+    VkDeviceSize frame_restore_budget {16 * 1024 * 1024};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Residency_stats {
+    uint64_t evicted_bytes {0};
+    uint64_t restored_bytes {0};
+    uint64_t eviction_count {0};
+    uint64_t restore_count {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+using Resident_id = uint32_t;
+
+// the commands which move a resource are recorded into the frame, the previous place of the resource is used by
+// the frames in flight until it is retired. evict moves to a lower mip or to host memory, restore moves back.
+struct Resident_callbacks {
+    std::function<void(VkCommandBuffer)> evict;
+    std::function<void(VkCommandBuffer)> restore;
+    std::function<void()> retire;
+};
+
+// called with the new buffer while the frame is recorded, so descriptors of the frame can refer to it.
+using Resident_move_callback = std::function<void(VkBuffer)>;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// keeps the usage of every heap under its budget by evicting the least recently used resources.
+// the budget comes from VK_EXT_memory_budget when the allocator is created with it, otherwise from the heap sizes.
+// evicted resources stay usable and are restored over the next frames when they are used again.
+class Residency_manager final {
+public:
+    Residency_manager(Memory_allocator& allocator, const Residency_desc& desc);
+
+    Residency_manager(const Residency_manager&) = delete;
+
+    // the device must be idle, the evicted buffers are kept in host memory.
+    ~Residency_manager();
+
+    Residency_manager& operator=(const Residency_manager&) = delete;
+
+    // a resource of the given size in the heap, the callbacks move it.
+    Resident_id add(VkDeviceSize size, uint32_t heap, Resident_callbacks callbacks);
+
+    // a device local buffer which is evicted to host memory, the device reads it over the bus while it is evicted.
+    // the handle and the allocation are replaced when the buffer is moved. the buffer must be created with
+    // TRANSFER_SRC and TRANSFER_DST and must not be added to a Defragmenter.
+    Resident_id add_buffer(const VkBufferCreateInfo& create_info, VkBuffer* buffer, VmaAllocation* allocation,
+                           Resident_move_callback callback = {});
+
+    // the buffers are destroyed by the caller, the device must not use the resource anymore.
+    void remove(Resident_id id);
+
+    // the resource is used by the frame which the next record records, an evicted resource is restored.
+    void touch(Resident_id id) noexcept;
+
+    // the command buffer must be recording outside of a render pass, the moves are recorded before the frame.
+    void record(VkCommandBuffer command_buffer);
+
+    [[nodiscard]]
+    bool is_resident(Resident_id id) const noexcept;
+
+    inline auto stats() const noexcept
+    { return stats_; }
+
+private:
+    enum class State_ : uint8_t {
+        resident, evicted, restoring
+    };
+
+    struct Resident_ {
+        VkDeviceSize size;
+        uint32_t heap;
+        uint64_t last_use;
+        uint64_t move_frame;
+        State_ state;
+        // the previous place is used by the frames in flight.
+        bool moving;
+        // the memory of the heap is released when the move is retired.
+        bool releasing;
+        bool removed;
+        Resident_callbacks callbacks;
+    };
+
+    struct Buffer_ {
+        VkBufferCreateInfo create_info;
+        std::vector<uint32_t> queue_family_indices;
+        VkBuffer* buffer;
+        VmaAllocation* allocation;
+        uint32_t device_memory_type_bits;
+        uint32_t host_memory_type_bits;
+        VkBuffer retired_buffer;
+        VmaAllocation retired_allocation;
+        Resident_move_callback callback;
+    };
+
+    void retire_(bool all);
+
+    // returns the bytes which are evicted, they can be fewer than the requested ones.
+    VkDeviceSize evict_(VkCommandBuffer command_buffer, uint32_t heap, VkDeviceSize bytes);
+
+    void restore_(VkCommandBuffer command_buffer, std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS>& usages,
+                  const std::array<VmaBudget, VK_MAX_MEMORY_HEAPS>& budgets);
+
+    void move_(VkCommandBuffer command_buffer, Resident_& resident, bool evict);
+
+    void move_buffer_(VkCommandBuffer command_buffer, Resident_id id, bool evict);
+
+    void retire_buffer_(Resident_id id) noexcept;
+
+    void begin_moves_(VkCommandBuffer command_buffer);
+
+    void end_moves_(VkCommandBuffer command_buffer);
+
+private:
+    Memory_allocator& allocator_;
+    const Device_table& device_table_;
+    Residency_desc desc_;
+    std::vector<Resident_> residents_;
+    std::vector<Buffer_> buffers_;
+    std::vector<Resident_id> free_ids_;
+    std::vector<Resident_id> candidates_;
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> pending_bytes_;
+    Residency_stats stats_;
+    uint64_t frame_;
+    bool moves_begun_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_RESIDENCY_MANAGER_GUARD
@@ -0,0 +1,93 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_SUBMIT_THREAD_GUARD
+#define VLK_SUBMIT_THREAD_GUARD
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "vlk/Loader.h"
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// a recorded frame which is ready to be submitted and presented.
+struct Submit_frame {
+    VkCommandBuffer command_buffer {VK_NULL_HANDLE};
+    VkSemaphore wait_semaphore {VK_NULL_HANDLE};
+    VkPipelineStageFlags wait_stage_mask {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    VkSemaphore signal_semaphore {VK_NULL_HANDLE};
+    VkFence fence {VK_NULL_HANDLE};
+    VkSwapchainKHR swapchain {VK_NULL_HANDLE};
+    uint32_t swapchain_index {0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// submits and presents frames on its own thread, so the recording thread can start the next frame right away.
+// the thread owns the queue, so every other use of the queue and vkDeviceWaitIdle must come after wait_idle.
+// acquiring and presenting a swapchain must be synchronized, so the thread acquires images too.
+// the thread calls the device through its table, so the table must outlive the thread.
+class Submit_thread final {
+public:
+    Submit_thread(const Device_table& device_table, VkQueue queue, uint32_t capacity = 2);
+
+    ~Submit_thread();
+
+    // blocks while the queue of frames is full.
+    void push(const Submit_frame& frame);
+
+    // blocks until the thread submits the pushed frames and acquires an image.
+    // images must be acquired from one thread at a time.
+    [[nodiscard]]
+    VkResult acquire_next_image(VkDevice device, VkSwapchainKHR swapchain, VkSemaphore semaphore,
+                                uint32_t* swapchain_index);
+
+    // waits until all frames are submitted and presented.
+    void wait_idle();
+
+    // the result of the last submit or present which isn't VK_SUCCESS, and it's cleared when it's read.
+    inline auto result() noexcept
+    { return result_.exchange(VK_SUCCESS, std::memory_order_acq_rel); }
+
+private:
+    void run_();
+
+    void submit_(const Submit_frame& frame);
+
+    void acquire_();
+
+private:
+    const Device_table& device_table_;
+    VkQueue queue_;
+    std::vector<Submit_frame> frames_;
+    uint32_t head_;
+    uint32_t count_;
+    bool busy_;
+    bool running_;
+    std::atomic<VkResult> result_;
+    // the acquire which is requested, and the thread writes its result.
+    VkDevice acquire_device_;
+    VkSwapchainKHR acquire_swapchain_;
+    VkSemaphore acquire_semaphore_;
+    uint32_t* acquire_index_;
+    VkResult acquire_result_;
+    bool acquire_pending_;
+    std::mutex mutex_;
+    std::condition_variable push_cv_;
+    std::condition_variable pop_cv_;
+    std::thread thread_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_SUBMIT_THREAD_GUARD
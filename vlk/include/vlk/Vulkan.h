@@ -0,0 +1,16 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_VULKAN_GUARD
+#define VLK_VULKAN_GUARD
+
+// include this header instead of vulkan.h, so the calls go through the tables of Vlk.
+#if !defined(VK_NO_PROTOTYPES)
+#define VK_NO_PROTOTYPES 1
+#endif
+
+#include "vlk/Loader.h"
+
+#endif // VLK_VULKAN_GUARD
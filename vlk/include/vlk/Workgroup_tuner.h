@@ -0,0 +1,97 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#ifndef VLK_WORKGROUP_TUNER_GUARD
+#define VLK_WORKGROUP_TUNER_GUARD
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <vulkan/vulkan.h>
+#include <ghc/filesystem.hpp>
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace fs = ghc::filesystem;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// specialization constants 0, 1 and 2 are the local size and 3, 4 and 5 are the tile size.
+struct Workgroup_candidate {
+    std::array<uint32_t, 3> local_size {1, 1, 1};
+    std::array<uint32_t, 3> tile_size {1, 1, 1};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Tuning_desc {
+    std::string src;
+    std::array<uint32_t, 3> problem_size {1, 1, 1};
+    std::vector<VkDeviceSize> storage_buffer_sizes;
+    std::vector<Workgroup_candidate> candidates;
+    uint32_t iterations {16};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Tuning_result {
+    Workgroup_candidate candidate;
+    double time {0.0};
+    bool cached {false};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<Workgroup_candidate> default_candidates(const std::array<uint32_t, 3>& problem_size);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the instance must be created with Vulkan 1.1 to read the device UUID.
+class Workgroup_tuner final {
+public:
+    Workgroup_tuner(VkPhysicalDevice physical_device, VkDevice device, uint32_t queue_family_index,
+                    const fs::path& cache_path);
+
+    Tuning_result tune(const Tuning_desc& desc);
+
+private:
+    void init_properties_();
+
+    void init_queue_();
+
+    void load_cache_();
+
+    void save_cache_() const;
+
+    [[nodiscard]]
+    std::string key_(const std::vector<uint32_t>& spirv, const Tuning_desc& desc) const;
+
+    [[nodiscard]]
+    bool valid_(const Workgroup_candidate& candidate, const std::array<uint32_t, 3>& problem_size) const noexcept;
+
+    [[nodiscard]]
+    uint32_t find_memory_type_index_(uint32_t memory_type_bits, VkMemoryPropertyFlags properties) const;
+
+private:
+    VkPhysicalDevice physical_device_;
+    VkDevice device_;
+    uint32_t queue_family_index_;
+    VkQueue queue_;
+    fs::path cache_path_;
+    VkPhysicalDeviceProperties properties_;
+    VkPhysicalDeviceMemoryProperties memory_properties_;
+    std::array<uint8_t, VK_UUID_SIZE> device_uuid_;
+    uint32_t timestamp_valid_bits_;
+    std::unordered_map<std::string, Tuning_result> cache_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
+
+#endif // VLK_WORKGROUP_TUNER_GUARD
@@ -0,0 +1,315 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <cassert>
+#include <stdexcept>
+#include <platform/Allocation_counter.h>
+#include "Loader.h"
+#include "Defragmenter.h"
+
+using namespace std;
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Defragmenter::Defragmenter(Memory_allocator& allocator, const Defragmenter_desc& desc) :
+    allocator_ {allocator},
+    device_table_ {allocator.device_table()},
+    desc_ {desc},
+    buffers_ {},
+    allocations_ {},
+    moves_ (desc.frame_move_count),
+    retired_buffers_ {},
+    context_ {VK_NULL_HANDLE},
+    context_stats_ {},
+    stats_ {},
+    frame_ {0},
+    pass_frame_ {0},
+    check_frame_ {desc.check_interval},
+    pass_pending_ {false}
+{
+    // the frames don't allocate host memory for moves.
+    retired_buffers_.reserve(desc.frame_move_count);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Defragmenter::~Defragmenter()
+{
+    if (pass_pending_)
+        end_pass_();
+
+    if (context_)
+        end_defragmentation_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::add_buffer(const VkBufferCreateInfo& create_info, VkBuffer* buffer, VmaAllocation allocation,
+                              Buffer_move_callback callback)
+{
+    // the old buffer is the source of the copy and the new one is the destination.
+    assert(create_info.usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    assert(create_info.usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    Buffer_ entry {create_info,
+                   {create_info.pQueueFamilyIndices,
+                    create_info.pQueueFamilyIndices + create_info.queueFamilyIndexCount},
+                   *buffer,
+                   buffer,
+                   move(callback),
+                   false};
+
+    entry.create_info.pNext = nullptr;
+
+    buffers_.emplace(allocation, move(entry));
+    update_allocations_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::destroy_buffer(VmaAllocation allocation)
+{
+    auto& buffer = buffers_.at(allocation);
+
+    // the allocation may be moved by the plan of the defragmentation, so it is destroyed after the defragmentation.
+    if (context_) {
+        buffer.target = nullptr;
+        buffer.callback = nullptr;
+        buffer.destroyed = true;
+        return;
+    }
+
+    allocator_.destroy_buffer(buffer.handle, allocation);
+    buffers_.erase(allocation);
+    update_allocations_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::record(VkCommandBuffer command_buffer)
+{
+    ++frame_;
+
+    // the frame which recorded the pass is completed when the same frame is recorded again.
+    if (pass_pending_) {
+        if (frame_ - pass_frame_ < desc_.frames_in_flight)
+            return;
+
+        end_pass_();
+    }
+
+    if (!context_) {
+        if (frame_ < check_frame_)
+            return;
+
+        check_frame_ = frame_ + desc_.check_interval;
+
+        if (!is_fragmented_())
+            return;
+
+        begin_defragmentation_();
+
+        if (!context_)
+            return;
+    }
+
+    begin_pass_(command_buffer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Defragmenter::is_fragmented_() const noexcept
+{
+    if (allocations_.empty())
+        return false;
+
+    auto stats = allocator_.stats();
+    auto total_bytes = stats.total.usedBytes + stats.total.unusedBytes;
+
+    return total_bytes && stats.total.unusedBytes >= desc_.unused_ratio * total_bytes;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::begin_defragmentation_()
+{
+    // the plan is made by the allocator, it is the rare frame which may allocate.
+    Platform::Allocation_exemption allocation_exemption;
+    VmaDefragmentationInfo2 info {};
+
+    info.flags = VMA_DEFRAGMENTATION_FLAG_INCREMENTAL;
+    info.allocationCount = static_cast<uint32_t>(allocations_.size());
+    info.pAllocations = allocations_.data();
+    // host copies would race with the frames in flight, so every move is copied on the queue.
+    info.maxCpuBytesToMove = 0;
+    info.maxCpuAllocationsToMove = 0;
+    // the plan doesn't have more moves than a pass can take, so a pass commits the whole plan.
+    info.maxGpuBytesToMove = desc_.frame_budget;
+    info.maxGpuAllocationsToMove = desc_.frame_move_count;
+
+    auto result = vmaDefragmentationBegin(allocator_.allocator(), &info, &context_stats_, &context_);
+
+    if (result < VK_SUCCESS)
+        throw runtime_error("fail to begin a defragmentation");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::end_defragmentation_()
+{
+    vmaDefragmentationEnd(allocator_.allocator(), context_);
+    context_ = VK_NULL_HANDLE;
+
+    stats_.bytes_moved += context_stats_.bytesMoved;
+    stats_.bytes_freed += context_stats_.bytesFreed;
+    stats_.buffers_moved += context_stats_.allocationsMoved;
+    stats_.blocks_freed += context_stats_.deviceMemoryBlocksFreed;
+
+    // keep going while buffers are moved, the next check finds whether the blocks are still sparse.
+    if (context_stats_.allocationsMoved)
+        check_frame_ = frame_ + 1;
+
+    for (auto iter = begin(buffers_); iter != end(buffers_);) {
+        if (iter->second.destroyed) {
+            allocator_.destroy_buffer(iter->second.handle, iter->first);
+            iter = buffers_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    update_allocations_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::begin_pass_(VkCommandBuffer command_buffer)
+{
+    // the new buffers and the retired buffers of the moves may allocate.
+    Platform::Allocation_exemption allocation_exemption;
+    VmaDefragmentationPassInfo pass {static_cast<uint32_t>(moves_.size()), moves_.data()};
+
+    vmaBeginDefragmentationPass(allocator_.allocator(), context_, &pass);
+
+    if (!pass.moveCount) {
+        end_pass_();
+        return;
+    }
+
+    VkMemoryBarrier barrier {};
+
+    // the copies read what the previous frames wrote to the buffers.
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    device_table_.vkCmdPipelineBarrier(command_buffer,
+                                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                       0,
+                                       1, &barrier,
+                                       0, nullptr,
+                                       0, nullptr);
+
+    for (auto i = 0u; i != pass.moveCount; ++i)
+        move_buffer_(command_buffer, moves_[i]);
+
+    // the frame reads the new buffers after the copies.
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+    device_table_.vkCmdPipelineBarrier(command_buffer,
+                                       VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                       0,
+                                       1, &barrier,
+                                       0, nullptr,
+                                       0, nullptr);
+
+    pass_frame_ = frame_;
+    pass_pending_ = true;
+    ++stats_.pass_count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::end_pass_()
+{
+    Platform::Allocation_exemption allocation_exemption;
+    auto device = allocator_.device();
+    auto allocation_callbacks = allocator_.allocation_callbacks();
+
+    // the old places are freed and empty blocks are released.
+    auto result = vmaEndDefragmentationPass(allocator_.allocator(), context_);
+
+    for (auto buffer : retired_buffers_)
+        device_table_.vkDestroyBuffer(device, buffer, allocation_callbacks);
+
+    retired_buffers_.clear();
+
+    auto moved = pass_pending_;
+
+    pass_pending_ = false;
+
+    // a block which couldn't be planned is tried by the next pass, unless nothing moves anymore.
+    if (result != VK_NOT_READY || !moved)
+        end_defragmentation_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::move_buffer_(VkCommandBuffer command_buffer, const VmaDefragmentationPassMoveInfo& move)
+{
+    auto device = allocator_.device();
+    auto allocation_callbacks = allocator_.allocation_callbacks();
+    auto& buffer = buffers_.at(move.allocation);
+
+    buffer.create_info.pQueueFamilyIndices = buffer.queue_family_indices.data();
+
+    VkBuffer new_buffer;
+
+    if (device_table_.vkCreateBuffer(device, &buffer.create_info, allocation_callbacks, &new_buffer) != VK_SUCCESS)
+        throw runtime_error("fail to create a buffer to move");
+
+    // the requirements are the same as the old buffer, they are queried to keep the validation layer quiet.
+    VkMemoryRequirements requirements;
+
+    device_table_.vkGetBufferMemoryRequirements(device, new_buffer, &requirements);
+
+    if (device_table_.vkBindBufferMemory(device, new_buffer, move.memory, move.offset) != VK_SUCCESS)
+        throw runtime_error("fail to bind a buffer to move");
+
+    VkBufferCopy region {};
+
+    region.size = buffer.create_info.size;
+
+    device_table_.vkCmdCopyBuffer(command_buffer, buffer.handle, new_buffer, 1, &region);
+
+    // the old buffer is used by the frames in flight until the pass ends.
+    retired_buffers_.push_back(buffer.handle);
+    buffer.handle = new_buffer;
+
+    if (buffer.target)
+        *buffer.target = new_buffer;
+
+    if (buffer.callback)
+        buffer.callback(new_buffer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Defragmenter::update_allocations_()
+{
+    allocations_.clear();
+
+    for (auto& [allocation, buffer] : buffers_) {
+        if (!buffer.destroyed)
+            allocations_.push_back(allocation);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
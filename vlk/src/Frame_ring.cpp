@@ -0,0 +1,134 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <platform/Stream_copy.h>
+#include "Loader.h"
+#include "Frame_ring.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto align_up(VkDeviceSize value, VkDeviceSize alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Frame_ring::Frame_ring(Memory_allocator& allocator, const Frame_ring_desc& desc, const char* name) :
+    allocator_ {allocator},
+    uniform_alignment_ {1},
+    frame_size_ {0},
+    frame_count_ {desc.frame_count},
+    mapped_buffer_ {},
+    frame_begin_ {0},
+    head_ {0}
+{
+    init_buffer_(desc, name);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_ring::begin_frame(uint32_t frame_index) noexcept
+{
+    assert(frame_index < frame_count_);
+
+    frame_begin_ = frame_index * frame_size_;
+    head_ = frame_begin_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_ring::end_frame() noexcept
+{
+    // the sub-allocations are contiguous, so the frame is flushed as a single range.
+    if (head_ != frame_begin_)
+        mapped_buffer_->mark_written(frame_begin_, head_ - frame_begin_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Frame_ring::allocate(VkDeviceSize size, VkDeviceSize alignment, Ring_allocation* allocation) noexcept
+{
+    if (!alignment)
+        return false;
+
+    auto offset = align_up(head_, alignment);
+
+    if (offset + size > frame_begin_ + frame_size_)
+        return false;
+
+    head_ = offset + size;
+
+    allocation->data = mapped_buffer_->data() + offset;
+    allocation->buffer = mapped_buffer_->buffer();
+    allocation->offset = static_cast<uint32_t>(offset);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Frame_ring::write_uniform(const void* data, VkDeviceSize size, Ring_allocation* allocation) noexcept
+{
+    return write(data, size, uniform_alignment_, allocation);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Frame_ring::write(const void* data, VkDeviceSize size, VkDeviceSize alignment,
+                       Ring_allocation* allocation) noexcept
+{
+    if (!allocate(size, alignment, allocation))
+        return false;
+
+    Platform::stream_copy(allocation->data, data, size, mapped_buffer_->write_combined());
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Frame_ring::init_buffer_(const Frame_ring_desc& desc, const char* name)
+{
+    const VkPhysicalDeviceProperties* device_properties;
+
+    vmaGetPhysicalDeviceProperties(allocator_.allocator(), &device_properties);
+
+    uniform_alignment_ = max<VkDeviceSize>(device_properties->limits.minUniformBufferOffsetAlignment, 1);
+
+    // the regions don't share an atom, so flushing a frame doesn't touch the region which the device reads.
+    frame_size_ = align_up(desc.frame_size, max(uniform_alignment_, allocator_.non_coherent_atom_size()));
+
+    // dynamic offsets are 32 bits.
+    if (frame_size_ * frame_count_ > UINT32_MAX)
+        throw runtime_error("fail to fit a frame ring in the range of dynamic offsets");
+
+    VkBufferCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    create_info.size = frame_size_ * frame_count_;
+    create_info.usage = desc.usage;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // the host rewrites the ring every frame and the device reads it once, so it lives in the BAR when it fits.
+    mapped_buffer_ = make_unique<Mapped_buffer>(allocator_, create_info, Memory_access::dynamic, name);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
@@ -0,0 +1,289 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "Host_allocator.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the sizes of the classes include the header and the padding for the alignment.
+constexpr size_t class_sizes[] = {32, 64, 128, 256, 512, 1024, 2048, 4096, 8192};
+constexpr size_t header_size = 16;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// sits just before the memory which is returned to the driver.
+struct Header {
+    uint8_t size_class;
+    uint8_t scope;
+    uint16_t reserved;
+    uint32_t offset;
+    uint64_t size;
+};
+
+static_assert(sizeof(Header) == header_size);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto header(void* memory) noexcept
+{
+    return reinterpret_cast<Header*>(static_cast<uint8_t*>(memory) - header_size);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void update_peak(atomic<uint64_t>& peak, uint64_t value) noexcept
+{
+    auto current = peak.load(memory_order_relaxed);
+
+    while (current < value && !peak.compare_exchange_weak(current, value, memory_order_relaxed));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Host_allocator::Host_allocator() :
+    callbacks_ {},
+    pools_ {},
+    stats_ {}
+{
+    static_assert(size(class_sizes) == class_count_);
+
+    callbacks_.pUserData = this;
+    callbacks_.pfnAllocation = &Host_allocator::allocate_;
+    callbacks_.pfnReallocation = &Host_allocator::reallocate_;
+    callbacks_.pfnFree = &Host_allocator::free_;
+    callbacks_.pfnInternalAllocation = &Host_allocator::notify_internal_allocation_;
+    callbacks_.pfnInternalFree = &Host_allocator::notify_internal_free_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Host_allocator::~Host_allocator()
+{
+    term_pools_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Host_allocation_stats Host_allocator::stats(VkSystemAllocationScope scope) const noexcept
+{
+    auto& stats = stats_[scope];
+
+    return {stats.live_bytes.load(memory_order_relaxed),
+            stats.peak_bytes.load(memory_order_relaxed),
+            stats.live_count.load(memory_order_relaxed),
+            stats.allocation_count.load(memory_order_relaxed),
+            stats.internal_bytes.load(memory_order_relaxed)};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Host_allocation_stats Host_allocator::total_stats() const noexcept
+{
+    Host_allocation_stats total;
+
+    // the peaks of the scopes may happen at different times, so the sum is an upper bound.
+    for (auto i = 0u; i != scope_count_; ++i) {
+        auto stats = this->stats(static_cast<VkSystemAllocationScope>(i));
+
+        total.live_bytes += stats.live_bytes;
+        total.peak_bytes += stats.peak_bytes;
+        total.live_count += stats.live_count;
+        total.allocation_count += stats.allocation_count;
+        total.internal_bytes += stats.internal_bytes;
+    }
+
+    return total;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* VKAPI_PTR Host_allocator::allocate_(void* user_data, size_t size, size_t alignment,
+                                          VkSystemAllocationScope scope)
+{
+    return static_cast<Host_allocator*>(user_data)->allocate_(size, alignment, scope);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* VKAPI_PTR Host_allocator::reallocate_(void* user_data, void* original, size_t size, size_t alignment,
+                                            VkSystemAllocationScope scope)
+{
+    auto allocator = static_cast<Host_allocator*>(user_data);
+
+    if (!original)
+        return allocator->allocate_(size, alignment, scope);
+
+    if (!size) {
+        allocator->free_(original);
+        return nullptr;
+    }
+
+    // the original memory is kept when the allocation fails.
+    auto memory = allocator->allocate_(size, alignment, scope);
+
+    if (!memory)
+        return nullptr;
+
+    memcpy(memory, original, min<size_t>(size, header(original)->size));
+    allocator->free_(original);
+
+    return memory;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void VKAPI_PTR Host_allocator::free_(void* user_data, void* memory)
+{
+    if (memory)
+        static_cast<Host_allocator*>(user_data)->free_(memory);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void VKAPI_PTR Host_allocator::notify_internal_allocation_(void* user_data, size_t size,
+                                                           VkInternalAllocationType,
+                                                           VkSystemAllocationScope scope)
+{
+    static_cast<Host_allocator*>(user_data)->stats_[scope].internal_bytes.fetch_add(size, memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void VKAPI_PTR Host_allocator::notify_internal_free_(void* user_data, size_t size,
+                                                     VkInternalAllocationType,
+                                                     VkSystemAllocationScope scope)
+{
+    static_cast<Host_allocator*>(user_data)->stats_[scope].internal_bytes.fetch_sub(size, memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* Host_allocator::allocate_(size_t size, size_t alignment, VkSystemAllocationScope scope) noexcept
+{
+    // the header is placed before the aligned memory, so the padding must have a room for it.
+    alignment = max(alignment, header_size);
+
+    auto total_size = size + alignment;
+    auto size_class = static_cast<uint32_t>(lower_bound(begin(class_sizes), end(class_sizes), total_size) -
+                                            begin(class_sizes));
+    auto block = size_class != large_class_ ? allocate_block_(size_class) : malloc(total_size);
+
+    if (!block)
+        return nullptr;
+
+    // blocks are aligned to the header, so the memory is at the next multiple of the alignment after the header.
+    auto address = reinterpret_cast<uintptr_t>(block) + header_size;
+    auto memory = reinterpret_cast<void*>((address + alignment - 1) / alignment * alignment);
+    auto memory_header = header(memory);
+
+    memory_header->size_class = static_cast<uint8_t>(size_class);
+    memory_header->scope = static_cast<uint8_t>(scope);
+    memory_header->offset = static_cast<uint32_t>(static_cast<uint8_t*>(memory) - static_cast<uint8_t*>(block));
+    memory_header->size = size;
+
+    auto& stats = stats_[scope];
+
+    update_peak(stats.peak_bytes, stats.live_bytes.fetch_add(size, memory_order_relaxed) + size);
+    stats.live_count.fetch_add(1, memory_order_relaxed);
+    stats.allocation_count.fetch_add(1, memory_order_relaxed);
+
+    return memory;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Host_allocator::free_(void* memory) noexcept
+{
+    auto memory_header = header(memory);
+    auto& stats = stats_[memory_header->scope];
+
+    stats.live_bytes.fetch_sub(memory_header->size, memory_order_relaxed);
+    stats.live_count.fetch_sub(1, memory_order_relaxed);
+
+    auto block = static_cast<uint8_t*>(memory) - memory_header->offset;
+
+    if (memory_header->size_class != large_class_)
+        free_block_(memory_header->size_class, block);
+    else
+        free(block);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* Host_allocator::allocate_block_(uint32_t size_class) noexcept
+{
+    auto& pool = pools_[size_class];
+
+    lock_guard<mutex> lock {pool.mutex};
+
+    // a chunk is carved into blocks when the pool runs out.
+    if (!pool.blocks) {
+        auto chunk = static_cast<uint8_t*>(malloc(chunk_size_));
+
+        if (!chunk)
+            return nullptr;
+
+        try {
+            pool.chunks.push_back(chunk);
+        } catch (...) {
+            free(chunk);
+            return nullptr;
+        }
+
+        auto block_size = class_sizes[size_class];
+
+        for (auto offset = chunk_size_; offset >= block_size; offset -= block_size) {
+            auto block = reinterpret_cast<Block_*>(chunk + offset - block_size);
+
+            block->next = pool.blocks;
+            pool.blocks = block;
+        }
+    }
+
+    auto block = pool.blocks;
+
+    pool.blocks = block->next;
+
+    return block;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Host_allocator::free_block_(uint32_t size_class, void* block) noexcept
+{
+    auto& pool = pools_[size_class];
+
+    lock_guard<mutex> lock {pool.mutex};
+
+    static_cast<Block_*>(block)->next = pool.blocks;
+    pool.blocks = static_cast<Block_*>(block);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Host_allocator::term_pools_() noexcept
+{
+    for (auto& pool : pools_) {
+        for (auto chunk : pool.chunks)
+            free(chunk);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
@@ -0,0 +1,157 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdint>
+#include <stdexcept>
+#include "Loader.h"
+#include "Host_importer.h"
+
+using namespace std;
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Host_importer::Host_importer(Memory_allocator& allocator) :
+    allocator_ {allocator},
+    device_table_ {allocator.device_table()},
+    alignment_ {0}
+{
+    init_alignment_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Host_importer::import_buffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+                                  Imported_buffer* buffer) noexcept
+{
+    // the pointer and the size of an import must be aligned, the pages around the data aren't imported
+    // because the device would see whatever else the heap put in them.
+    if (reinterpret_cast<uintptr_t>(data) % alignment_ || !size || size % alignment_)
+        return false;
+
+    auto pointer = const_cast<void*>(data);
+    auto device = allocator_.device();
+    auto callbacks = allocator_.allocation_callbacks();
+
+    VkMemoryHostPointerPropertiesEXT properties {};
+
+    properties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+
+    if (device_table_.vkGetMemoryHostPointerPropertiesEXT(device,
+                                                          VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+                                                          pointer, &properties) != VK_SUCCESS)
+        return false;
+
+    VkExternalMemoryBufferCreateInfo external_info {};
+
+    external_info.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+    external_info.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+    VkBufferCreateInfo create_info {};
+
+    create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    create_info.pNext = &external_info;
+    create_info.size = size;
+    create_info.usage = usage;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer new_buffer;
+
+    if (device_table_.vkCreateBuffer(device, &create_info, callbacks, &new_buffer) != VK_SUCCESS)
+        return false;
+
+    VkMemoryRequirements requirements;
+
+    device_table_.vkGetBufferMemoryRequirements(device, new_buffer, &requirements);
+
+    // the buffer must fit in the imported memory, the driver can't make the import any larger.
+    auto memory_type_bits = requirements.memoryTypeBits & properties.memoryTypeBits;
+
+    if (!memory_type_bits || requirements.size > create_info.size) {
+        device_table_.vkDestroyBuffer(device, new_buffer, callbacks);
+        return false;
+    }
+
+    VkImportMemoryHostPointerInfoEXT import_info {};
+
+    import_info.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+    import_info.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+    import_info.pHostPointer = pointer;
+
+    VkMemoryAllocateInfo allocate_info {};
+
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.pNext = &import_info;
+    allocate_info.allocationSize = create_info.size;
+    allocate_info.memoryTypeIndex = 0;
+
+    while (!(memory_type_bits & (1u << allocate_info.memoryTypeIndex)))
+        ++allocate_info.memoryTypeIndex;
+
+    VkDeviceMemory device_memory;
+
+    if (device_table_.vkAllocateMemory(device, &allocate_info, callbacks, &device_memory) != VK_SUCCESS) {
+        device_table_.vkDestroyBuffer(device, new_buffer, callbacks);
+        return false;
+    }
+
+    if (device_table_.vkBindBufferMemory(device, new_buffer, device_memory, 0) != VK_SUCCESS) {
+        device_table_.vkFreeMemory(device, device_memory, callbacks);
+        device_table_.vkDestroyBuffer(device, new_buffer, callbacks);
+        return false;
+    }
+
+    buffer->buffer = new_buffer;
+    buffer->device_memory = device_memory;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Host_importer::destroy_buffer(const Imported_buffer& buffer) noexcept
+{
+    auto device = allocator_.device();
+    auto callbacks = allocator_.allocation_callbacks();
+
+    device_table_.vkDestroyBuffer(device, buffer.buffer, callbacks);
+    device_table_.vkFreeMemory(device, buffer.device_memory, callbacks);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Host_importer::init_alignment_()
+{
+    if (!device_table_.vkGetMemoryHostPointerPropertiesEXT)
+        throw runtime_error("fail to find VK_EXT_external_memory_host");
+
+    if (!allocator_.instance_table().vkGetPhysicalDeviceProperties2KHR)
+        throw runtime_error("fail to find vkGetPhysicalDeviceProperties2KHR");
+
+    VmaAllocatorInfo info;
+
+    vmaGetAllocatorInfo(allocator_.allocator(), &info);
+
+    VkPhysicalDeviceExternalMemoryHostPropertiesEXT host_properties {};
+
+    host_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+
+    VkPhysicalDeviceProperties2 properties {};
+
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &host_properties;
+
+    allocator_.instance_table().vkGetPhysicalDeviceProperties2KHR(info.physicalDevice, &properties);
+
+    alignment_ = host_properties.minImportedHostPointerAlignment;
+
+    if (!alignment_)
+        throw runtime_error("fail to query the alignment of imported host pointers");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
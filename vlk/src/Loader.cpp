@@ -0,0 +1,117 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <platform/Library.h>
+#include "Loader.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+unique_ptr<Platform::Library> library;
+PFN_vkGetInstanceProcAddr get_instance_proc_addr {nullptr};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template<typename T>
+inline void load(T& function, VkInstance instance, const char* name)
+{
+    function = reinterpret_cast<T>(get_instance_proc_addr(instance, name));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define VLK_DEFINE_FUNCTION(name) PFN_##name name {nullptr};
+
+VLK_GLOBAL_FUNCTIONS(VLK_DEFINE_FUNCTION)
+
+#undef VLK_DEFINE_FUNCTION
+
+//----------------------------------------------------------------------------------------------------------------------
+
+string default_library_path()
+{
+    if (auto path = getenv("VLK_LIBRARY"))
+        return path;
+
+#if defined(_WIN32)
+    return "vulkan-1.dll";
+#elif defined(__APPLE__)
+    return "libvulkan.1.dylib";
+#else
+    return "libvulkan.so.1";
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void load_global_functions(const string& path)
+{
+    library = make_unique<Platform::Library>(path);
+
+    // an ICD exports its own entry point instead of vkGetInstanceProcAddr.
+    get_instance_proc_addr = library->symbol<PFN_vkGetInstanceProcAddr>("vkGetInstanceProcAddr");
+
+    if (!get_instance_proc_addr)
+        get_instance_proc_addr = library->symbol<PFN_vkGetInstanceProcAddr>("vk_icdGetInstanceProcAddr");
+
+    if (!get_instance_proc_addr)
+        throw runtime_error("fail to load " + path);
+
+#define VLK_LOAD_FUNCTION(name) load(name, VK_NULL_HANDLE, #name);
+    VLK_GLOBAL_FUNCTIONS(VLK_LOAD_FUNCTION)
+#undef VLK_LOAD_FUNCTION
+
+    if (!vkCreateInstance)
+        throw runtime_error("fail to load " + path);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Instance_table load_instance_table(VkInstance instance)
+{
+    if (!get_instance_proc_addr)
+        throw runtime_error("fail to load instance functions");
+
+    Instance_table table;
+
+#define VLK_LOAD_FUNCTION(name) load(table.name, instance, #name);
+    VLK_INSTANCE_FUNCTIONS(VLK_LOAD_FUNCTION)
+#undef VLK_LOAD_FUNCTION
+
+    return table;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Device_table load_device_table(const Instance_table& instance_table, VkDevice device)
+{
+    if (!instance_table.vkGetDeviceProcAddr)
+        throw runtime_error("fail to load device functions");
+
+    Device_table table;
+
+#define VLK_LOAD_FUNCTION(name) \
+    table.name = reinterpret_cast<PFN_##name>(instance_table.vkGetDeviceProcAddr(device, #name));
+    VLK_DEVICE_FUNCTIONS(VLK_LOAD_FUNCTION)
+#undef VLK_LOAD_FUNCTION
+
+    return table;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
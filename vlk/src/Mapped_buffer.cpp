@@ -0,0 +1,245 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <platform/Stream_copy.h>
+#include "Loader.h"
+#include "Mapped_buffer.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto align_down(VkDeviceSize value, VkDeviceSize alignment) noexcept
+{
+    return value / alignment * alignment;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto align_up(VkDeviceSize value, VkDeviceSize alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Mapped_buffer::Mapped_buffer(Memory_allocator& allocator, const VkBufferCreateInfo& create_info, Memory_access access,
+                             const char* name, const char* file, uint32_t line) :
+    allocator_ {allocator},
+    buffer_ {VK_NULL_HANDLE},
+    allocation_ {VK_NULL_HANDLE},
+    data_ {nullptr},
+    size_ {create_info.size},
+    atom_size_ {allocator.non_coherent_atom_size()},
+    coherent_ {true},
+    write_combined_ {false},
+    written_ranges_ {},
+    read_ranges_ {}
+{
+    init_buffer_(create_info, access, name, file, line);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Mapped_buffer::~Mapped_buffer()
+{
+    term_buffer_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Mapped_buffer::write(VkDeviceSize offset, const void* data, VkDeviceSize size) noexcept
+{
+    assert(offset + size <= size_);
+
+    Platform::stream_copy(data_ + offset, data, size, write_combined_);
+    mark_written(offset, size);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Mapped_buffer::mark_written(VkDeviceSize offset, VkDeviceSize size) noexcept
+{
+    if (!coherent_)
+        add_range_(written_ranges_, offset, size);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Mapped_buffer::mark_read(VkDeviceSize offset, VkDeviceSize size) noexcept
+{
+    if (!coherent_)
+        add_range_(read_ranges_, offset, size);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Mapped_buffer::init_buffer_(const VkBufferCreateInfo& create_info, Memory_access access, const char* name,
+                                 const char* file, uint32_t line)
+{
+    auto placement = allocator_.place_buffer(create_info, access, true);
+
+    if (!placement.host_visible)
+        throw runtime_error("fail to place a mapped buffer in host visible memory");
+
+    coherent_ = placement.host_coherent;
+
+    Allocation_desc desc;
+
+    desc.usage = VMA_MEMORY_USAGE_UNKNOWN;
+    desc.name = name;
+    desc.memory_type_bits = 1u << placement.memory_type;
+
+    if (allocator_.create_buffer(create_info, desc, &buffer_, &allocation_, file, line) != VK_SUCCESS)
+        throw runtime_error("fail to create a mapped buffer");
+
+    void* data;
+
+    if (allocator_.map(allocation_, &data) != VK_SUCCESS) {
+        allocator_.destroy_buffer(buffer_, allocation_);
+        throw runtime_error("fail to map a mapped buffer");
+    }
+
+    data_ = static_cast<uint8_t*>(data);
+    write_combined_ = allocator_.write_combined(allocation_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Mapped_buffer::term_buffer_() noexcept
+{
+    allocator_.unmap(allocation_);
+    allocator_.destroy_buffer(buffer_, allocation_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Mapped_buffer::add_range_(Ranges_& ranges, VkDeviceSize offset, VkDeviceSize size) noexcept
+{
+    assert(offset + size <= size_);
+
+    // ranges which share an atom are flushed together anyway.
+    Range_ range {align_down(offset, atom_size_), min(align_up(offset + size, atom_size_), size_)};
+
+    // the new range absorbs every range which it touches.
+    auto count = 0u;
+
+    for (auto i = 0u; i != ranges.count; ++i) {
+        auto& other = ranges.ranges[i];
+
+        if (range.begin <= other.end && other.begin <= range.end) {
+            range.begin = min(range.begin, other.begin);
+            range.end = max(range.end, other.end);
+        } else {
+            ranges.ranges[count++] = other;
+        }
+    }
+
+    if (count == max_range_count_) {
+        for (auto i = 0u; i != count; ++i) {
+            range.begin = min(range.begin, ranges.ranges[i].begin);
+            range.end = max(range.end, ranges.ranges[i].end);
+        }
+
+        count = 0;
+    }
+
+    ranges.ranges[count++] = range;
+    ranges.count = count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Flush_batch::Flush_batch(Memory_allocator& allocator) :
+    allocator_ {allocator},
+    buffers_ {},
+    allocations_ {},
+    offsets_ {},
+    sizes_ {}
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Flush_batch::add(Mapped_buffer& buffer)
+{
+    // coherent buffers have nothing to flush.
+    if (buffer.coherent())
+        return;
+
+    buffers_.push_back(&buffer);
+
+    // every range of every buffer fits, so flushes don't allocate.
+    auto capacity = buffers_.size() * Mapped_buffer::max_range_count_;
+
+    allocations_.reserve(capacity);
+    offsets_.reserve(capacity);
+    sizes_.reserve(capacity);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Flush_batch::remove(Mapped_buffer& buffer) noexcept
+{
+    buffers_.erase(std::remove(begin(buffers_), end(buffers_), &buffer), end(buffers_));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Flush_batch::flush() noexcept
+{
+    return submit_(true);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Flush_batch::invalidate() noexcept
+{
+    return submit_(false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Flush_batch::submit_(bool flush) noexcept
+{
+    allocations_.clear();
+    offsets_.clear();
+    sizes_.clear();
+
+    for (auto buffer : buffers_) {
+        auto& ranges = flush ? buffer->written_ranges_ : buffer->read_ranges_;
+
+        for (auto i = 0u; i != ranges.count; ++i) {
+            allocations_.push_back(buffer->allocation_);
+            offsets_.push_back(ranges.ranges[i].begin);
+            sizes_.push_back(ranges.ranges[i].end - ranges.ranges[i].begin);
+        }
+
+        ranges.count = 0;
+    }
+
+    if (allocations_.empty())
+        return VK_SUCCESS;
+
+    auto count = static_cast<uint32_t>(allocations_.size());
+
+    return flush ? allocator_.flush(count, allocations_.data(), offsets_.data(), sizes_.data()) :
+                   allocator_.invalidate(count, allocations_.data(), offsets_.data(), sizes_.data());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
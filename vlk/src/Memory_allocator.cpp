@@ -0,0 +1,642 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <bitset>
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+#include "Loader.h"
+
+// VMA calls the functions of the tables of the allocator, which are loaded at runtime.
+#define VMA_STATIC_VULKAN_FUNCTIONS 0
+#define VMA_DYNAMIC_VULKAN_FUNCTIONS 0
+#define VMA_IMPLEMENTATION
+#include "Memory_allocator.h"
+
+using namespace std;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto to_create_info(const Vlk::Allocation_desc& desc) noexcept
+{
+    VmaAllocationCreateInfo create_info {};
+
+    create_info.usage = desc.usage;
+    create_info.pool = desc.pool;
+    create_info.memoryTypeBits = desc.memory_type_bits;
+
+    return create_info;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the BAR of discrete devices without ReBAR is 256 MiB, which is too small for every immutable buffer.
+constexpr VkDeviceSize bar_size {256 * 1024 * 1024};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Placement_rule {
+    VkMemoryPropertyFlags required;
+    VkMemoryPropertyFlags preferred;
+    VkMemoryPropertyFlags avoided;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// the rules are tried in order, the first which has a memory type wins.
+inline auto to_placement_rules(Vlk::Memory_access access, bool direct_upload, bool host_flushes)
+{
+    constexpr VkMemoryPropertyFlags device_local {VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT};
+    constexpr VkMemoryPropertyFlags host_visible {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT};
+    constexpr VkMemoryPropertyFlags host_coherent {VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+    constexpr VkMemoryPropertyFlags host_cached {VK_MEMORY_PROPERTY_HOST_CACHED_BIT};
+
+    vector<Placement_rule> rules;
+
+    // the host writes without flushes unless the caller flushes, then the cached types aren't excluded.
+    auto host_writable = host_flushes ? host_visible : host_visible | host_coherent;
+
+    switch (access) {
+        case Vlk::Memory_access::immutable:
+            if (direct_upload)
+                rules.push_back({device_local | host_writable, 0, 0});
+
+            // the host visible types are left for the buffers which are written by the host.
+            rules.push_back({device_local, 0, host_visible});
+            break;
+        case Vlk::Memory_access::dynamic:
+            rules.push_back({host_writable, device_local, 0});
+            break;
+        case Vlk::Memory_access::streaming:
+            // cached writes don't stall on the bus when they aren't sequential.
+            rules.push_back({host_writable, host_flushes ? host_cached : 0, device_local});
+            break;
+        case Vlk::Memory_access::readback:
+            // uncached reads from the host are very slow, they are worth the invalidations.
+            rules.push_back({host_visible | host_cached, host_coherent, device_local});
+            rules.push_back({host_visible, host_coherent, device_local});
+            break;
+    }
+
+    return rules;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto to_score(const Placement_rule& rule, VkMemoryPropertyFlags flags) noexcept
+{
+    return static_cast<int>(bitset<32>(flags & rule.preferred).count()) -
+           static_cast<int>(bitset<32>(flags & rule.avoided).count());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// VMA copies the string, so the JSON dump shows the owner and the call site of every allocation.
+inline auto to_user_data(const Vlk::Allocation_desc& desc, const char* file, uint32_t line)
+{
+    return string(desc.name ? desc.name : "unnamed") + " (" + file + ':' + to_string(line) + ')';
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto to_memory_usage(const VmaStatInfo& info) noexcept
+{
+    Vlk::Memory_usage usage;
+
+    usage.block_count = info.blockCount;
+    usage.allocation_count = info.allocationCount;
+    usage.used_bytes = info.usedBytes;
+    usage.unused_bytes = info.unusedBytes;
+    // VMA leaves the range sizes undefined when there is no unused range.
+    usage.largest_free_bytes = info.unusedRangeCount ? info.unusedRangeSizeMax : 0;
+
+    if (usage.unused_bytes)
+        usage.fragmentation = 1.0f - static_cast<float>(usage.largest_free_bytes) / usage.unused_bytes;
+
+    return usage;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto is_render_target(const VkImageCreateInfo& create_info) noexcept
+{
+    return create_info.usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Memory_allocator::Memory_allocator(const Memory_allocator_desc& desc) :
+    device_ {desc.device},
+    instance_table_ {desc.instance_table},
+    device_table_ {desc.device_table},
+    allocation_callbacks_ {desc.allocation_callbacks},
+    dedicated_image_size_ {desc.dedicated_image_size},
+    allocator_ {VK_NULL_HANDLE},
+    direct_upload_ {false},
+    non_coherent_atom_size_ {1},
+    records_mutex_ {},
+    records_ {}
+{
+    assert(instance_table_ && device_table_);
+
+    init_allocator_(desc);
+    init_device_properties_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Memory_allocator::~Memory_allocator()
+{
+    // live_allocations() tells which resources leaked.
+    assert(records_.empty());
+
+    term_allocator_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Memory_allocator::create_buffer(const VkBufferCreateInfo& create_info, const Allocation_desc& desc,
+                                         VkBuffer* buffer, VmaAllocation* allocation,
+                                         const char* file, uint32_t line)
+{
+    auto allocation_info = to_create_info(desc);
+    auto user_data = to_user_data(desc, file, line);
+
+    allocation_info.flags |= VMA_ALLOCATION_CREATE_USER_DATA_COPY_STRING_BIT;
+    allocation_info.pUserData = user_data.data();
+
+    auto result = vmaCreateBuffer(allocator_, &create_info, &allocation_info, buffer, allocation, nullptr);
+
+    if (result != VK_SUCCESS)
+        return result;
+
+    // the buffer isn't returned when it can't be recorded, so it is destroyed here.
+    try {
+        add_record_(*allocation, desc, file, line);
+    } catch (...) {
+        vmaDestroyBuffer(allocator_, *buffer, *allocation);
+        *buffer = VK_NULL_HANDLE;
+        *allocation = VK_NULL_HANDLE;
+        throw;
+    }
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Memory_allocator::create_image(const VkImageCreateInfo& create_info, const Allocation_desc& desc,
+                                        VkImage* image, VmaAllocation* allocation,
+                                        const char* file, uint32_t line)
+{
+    // the size is only known after the image is created, so the image is created before the memory is allocated.
+    auto result = device_table_->vkCreateImage(device_, &create_info, allocation_callbacks_, image);
+
+    if (result != VK_SUCCESS)
+        return result;
+
+    VkMemoryRequirements requirements;
+
+    device_table_->vkGetImageMemoryRequirements(device_, *image, &requirements);
+
+    auto allocation_info = to_create_info(desc);
+    auto user_data = to_user_data(desc, file, line);
+
+    allocation_info.flags |= VMA_ALLOCATION_CREATE_USER_DATA_COPY_STRING_BIT;
+    allocation_info.pUserData = user_data.data();
+
+    // pools only serve sub-allocations.
+    if (!desc.pool && (requirements.size >= dedicated_image_size_ || is_render_target(create_info)))
+        allocation_info.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+    result = vmaAllocateMemoryForImage(allocator_, *image, &allocation_info, allocation, nullptr);
+
+    if (result == VK_SUCCESS) {
+        result = vmaBindImageMemory(allocator_, *allocation, *image);
+
+        // the image isn't returned when it can't be recorded, so it is destroyed here.
+        if (result == VK_SUCCESS) {
+            try {
+                add_record_(*allocation, desc, file, line);
+                return result;
+            } catch (...) {
+                vmaFreeMemory(allocator_, *allocation);
+                device_table_->vkDestroyImage(device_, *image, allocation_callbacks_);
+                *image = VK_NULL_HANDLE;
+                *allocation = VK_NULL_HANDLE;
+                throw;
+            }
+        }
+
+        vmaFreeMemory(allocator_, *allocation);
+    }
+
+    device_table_->vkDestroyImage(device_, *image, allocation_callbacks_);
+    *image = VK_NULL_HANDLE;
+    *allocation = VK_NULL_HANDLE;
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::destroy_buffer(VkBuffer buffer, VmaAllocation allocation) noexcept
+{
+    remove_record_(allocation);
+    vmaDestroyBuffer(allocator_, buffer, allocation);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::destroy_image(VkImage image, VmaAllocation allocation) noexcept
+{
+    remove_record_(allocation);
+    vmaDestroyImage(allocator_, image, allocation);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Memory_allocator::map(VmaAllocation allocation, void** data) noexcept
+{
+    return vmaMapMemory(allocator_, allocation, data);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::unmap(VmaAllocation allocation) noexcept
+{
+    vmaUnmapMemory(allocator_, allocation);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Memory_allocator::flush(uint32_t count, const VmaAllocation* allocations,
+                                 const VkDeviceSize* offsets, const VkDeviceSize* sizes) noexcept
+{
+    return vmaFlushAllocations(allocator_, count, allocations, offsets, sizes);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Memory_allocator::invalidate(uint32_t count, const VmaAllocation* allocations,
+                                      const VkDeviceSize* offsets, const VkDeviceSize* sizes) noexcept
+{
+    return vmaInvalidateAllocations(allocator_, count, allocations, offsets, sizes);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Placement Memory_allocator::place_buffer(const VkBufferCreateInfo& create_info, Memory_access access,
+                                         bool host_flushes) const
+{
+    // the memory types which can back a buffer are only known from a buffer.
+    VkBuffer buffer;
+
+    if (device_table_->vkCreateBuffer(device_, &create_info, allocation_callbacks_, &buffer) != VK_SUCCESS)
+        throw runtime_error("fail to create a buffer to place");
+
+    VkMemoryRequirements requirements;
+
+    device_table_->vkGetBufferMemoryRequirements(device_, buffer, &requirements);
+    device_table_->vkDestroyBuffer(device_, buffer, allocation_callbacks_);
+
+    const VkPhysicalDeviceMemoryProperties* properties;
+
+    vmaGetMemoryProperties(allocator_, &properties);
+
+    for (auto& rule : to_placement_rules(access, direct_upload_, host_flushes)) {
+        auto memory_type = UINT32_MAX;
+        auto best_score = INT32_MIN;
+
+        for (auto i = 0u; i != properties->memoryTypeCount; ++i) {
+            auto flags = properties->memoryTypes[i].propertyFlags;
+
+            if (!(requirements.memoryTypeBits & (1u << i)) || (flags & rule.required) != rule.required)
+                continue;
+
+            // the types are ordered by performance, so the first of equal types is taken.
+            if (auto score = to_score(rule, flags); score > best_score) {
+                memory_type = i;
+                best_score = score;
+            }
+        }
+
+        if (memory_type == UINT32_MAX)
+            continue;
+
+        auto flags = properties->memoryTypes[memory_type].propertyFlags;
+        Placement placement;
+
+        placement.memory_type = memory_type;
+        placement.host_visible = flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        placement.host_coherent = flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        placement.staging = !placement.host_visible;
+
+        return placement;
+    }
+
+    throw runtime_error("fail to find a memory type to place a buffer");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Memory_allocator::create_pool(const Pool_desc& desc, VmaPool* pool)
+{
+    VmaAllocationCreateInfo allocation_info {};
+
+    allocation_info.usage = desc.usage;
+
+    VmaPoolCreateInfo create_info {};
+
+    auto result = vmaFindMemoryTypeIndexForBufferInfo(allocator_, &desc.buffer_info, &allocation_info,
+                                                      &create_info.memoryTypeIndex);
+
+    if (result != VK_SUCCESS)
+        return result;
+
+    create_info.blockSize = desc.block_size;
+    create_info.minBlockCount = desc.min_block_count;
+    create_info.maxBlockCount = desc.max_block_count;
+
+    return vmaCreatePool(allocator_, &create_info, pool);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::destroy_pool(VmaPool pool) noexcept
+{
+    vmaDestroyPool(allocator_, pool);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VmaPoolStats Memory_allocator::pool_stats(VmaPool pool) const noexcept
+{
+    VmaPoolStats stats;
+
+    vmaGetPoolStats(allocator_, pool, &stats);
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VmaStats Memory_allocator::stats() const noexcept
+{
+    VmaStats stats;
+
+    vmaCalculateStats(allocator_, &stats);
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Memory_report Memory_allocator::report() const
+{
+    const VkPhysicalDeviceMemoryProperties* properties;
+
+    vmaGetMemoryProperties(allocator_, &properties);
+
+    auto vma_stats = stats();
+    Memory_report report;
+
+    for (auto i = 0u; i != properties->memoryHeapCount; ++i) {
+        report.heaps.push_back(to_memory_usage(vma_stats.memoryHeap[i]));
+        report.heap_sizes.push_back(properties->memoryHeaps[i].size);
+    }
+
+    for (auto i = 0u; i != properties->memoryTypeCount; ++i) {
+        report.types.push_back(to_memory_usage(vma_stats.memoryType[i]));
+        report.type_heaps.push_back(properties->memoryTypes[i].heapIndex);
+    }
+
+    report.total = to_memory_usage(vma_stats.total);
+
+    return report;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+string Memory_allocator::dump_json(bool detailed) const
+{
+    char* json;
+
+    vmaBuildStatsString(allocator_, &json, detailed);
+
+    string dump {json};
+
+    vmaFreeStatsString(allocator_, json);
+
+    return dump;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+vector<Allocation_record> Memory_allocator::live_allocations() const
+{
+    lock_guard<mutex> lock {records_mutex_};
+
+    vector<Allocation_record> records;
+
+    records.reserve(records_.size());
+
+    for (auto& [allocation, record] : records_)
+        records.push_back(record);
+
+    return records;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+array<VmaBudget, VK_MAX_MEMORY_HEAPS> Memory_allocator::budgets() const noexcept
+{
+    array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets;
+
+    vmaGetBudget(allocator_, budgets.data());
+
+    return budgets;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::set_frame_index(uint32_t frame_index) noexcept
+{
+    vmaSetCurrentFrameIndex(allocator_, frame_index);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t Memory_allocator::heap_count() const noexcept
+{
+    const VkPhysicalDeviceMemoryProperties* properties;
+
+    vmaGetMemoryProperties(allocator_, &properties);
+
+    return properties->memoryHeapCount;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t Memory_allocator::heap_index(VmaAllocation allocation) const noexcept
+{
+    VmaAllocationInfo info;
+
+    vmaGetAllocationInfo(allocator_, allocation, &info);
+
+    const VkPhysicalDeviceMemoryProperties* properties;
+
+    vmaGetMemoryProperties(allocator_, &properties);
+
+    return properties->memoryTypes[info.memoryType].heapIndex;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Memory_allocator::write_combined(VmaAllocation allocation) const noexcept
+{
+    VmaAllocationInfo info;
+
+    vmaGetAllocationInfo(allocator_, allocation, &info);
+
+    const VkPhysicalDeviceMemoryProperties* properties;
+
+    vmaGetMemoryProperties(allocator_, &properties);
+
+    auto flags = properties->memoryTypes[info.memoryType].propertyFlags;
+
+    return (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(flags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::init_allocator_(const Memory_allocator_desc& desc)
+{
+    VmaVulkanFunctions functions {};
+
+    functions.vkGetPhysicalDeviceProperties = instance_table_->vkGetPhysicalDeviceProperties;
+    functions.vkGetPhysicalDeviceMemoryProperties = instance_table_->vkGetPhysicalDeviceMemoryProperties;
+    functions.vkAllocateMemory = device_table_->vkAllocateMemory;
+    functions.vkFreeMemory = device_table_->vkFreeMemory;
+    functions.vkMapMemory = device_table_->vkMapMemory;
+    functions.vkUnmapMemory = device_table_->vkUnmapMemory;
+    functions.vkFlushMappedMemoryRanges = device_table_->vkFlushMappedMemoryRanges;
+    functions.vkInvalidateMappedMemoryRanges = device_table_->vkInvalidateMappedMemoryRanges;
+    functions.vkBindBufferMemory = device_table_->vkBindBufferMemory;
+    functions.vkBindImageMemory = device_table_->vkBindImageMemory;
+    functions.vkGetBufferMemoryRequirements = device_table_->vkGetBufferMemoryRequirements;
+    functions.vkGetImageMemoryRequirements = device_table_->vkGetImageMemoryRequirements;
+    functions.vkCreateBuffer = device_table_->vkCreateBuffer;
+    functions.vkDestroyBuffer = device_table_->vkDestroyBuffer;
+    functions.vkCreateImage = device_table_->vkCreateImage;
+    functions.vkDestroyImage = device_table_->vkDestroyImage;
+    functions.vkCmdCopyBuffer = device_table_->vkCmdCopyBuffer;
+#if VMA_MEMORY_BUDGET
+    functions.vkGetPhysicalDeviceMemoryProperties2KHR = instance_table_->vkGetPhysicalDeviceMemoryProperties2KHR;
+#endif
+
+    VmaAllocatorCreateInfo create_info {};
+
+    create_info.physicalDevice = desc.physical_device;
+    create_info.device = desc.device;
+    create_info.preferredLargeHeapBlockSize = desc.block_size;
+    create_info.pAllocationCallbacks = desc.allocation_callbacks;
+    create_info.pVulkanFunctions = &functions;
+    create_info.instance = desc.instance;
+    create_info.vulkanApiVersion = VK_API_VERSION_1_0;
+
+#if VMA_MEMORY_BUDGET
+    // the budget of the extension accounts for the memory of other processes and of the driver.
+    // the instance is 1.0, so the budget is queried through VK_KHR_get_physical_device_properties2.
+    if (desc.memory_budget && instance_table_->vkGetPhysicalDeviceMemoryProperties2KHR)
+        create_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+#endif
+
+    if (vmaCreateAllocator(&create_info, &allocator_) != VK_SUCCESS)
+        throw runtime_error("fail to create a memory allocator");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::term_allocator_() noexcept
+{
+    vmaDestroyAllocator(allocator_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::init_device_properties_()
+{
+    const VkPhysicalDeviceProperties* device_properties;
+
+    vmaGetPhysicalDeviceProperties(allocator_, &device_properties);
+
+    non_coherent_atom_size_ = device_properties->limits.nonCoherentAtomSize;
+
+    // integrated devices share the memory with the host.
+    if (device_properties->deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) {
+        direct_upload_ = true;
+        return;
+    }
+
+    const VkPhysicalDeviceMemoryProperties* properties;
+
+    vmaGetMemoryProperties(allocator_, &properties);
+
+    VkMemoryPropertyFlags host_visible_device_local {VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT};
+
+    // ReBAR exposes the whole device memory to the host.
+    for (auto i = 0u; i != properties->memoryTypeCount; ++i) {
+        auto& type = properties->memoryTypes[i];
+
+        if ((type.propertyFlags & host_visible_device_local) == host_visible_device_local &&
+            properties->memoryHeaps[type.heapIndex].size > bar_size)
+            direct_upload_ = true;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::add_record_(VmaAllocation allocation, const Allocation_desc& desc,
+                                   const char* file, uint32_t line)
+{
+    VmaAllocationInfo info;
+
+    vmaGetAllocationInfo(allocator_, allocation, &info);
+
+    Allocation_record record;
+
+    record.name = desc.name ? desc.name : "unnamed";
+    record.file = file;
+    record.line = line;
+    record.size = info.size;
+    record.memory_type = info.memoryType;
+
+    lock_guard<mutex> lock {records_mutex_};
+
+    records_.emplace(allocation, move(record));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Memory_allocator::remove_record_(VmaAllocation allocation) noexcept
+{
+    lock_guard<mutex> lock {records_mutex_};
+
+    records_.erase(allocation);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
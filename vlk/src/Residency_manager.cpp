@@ -0,0 +1,393 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <platform/Allocation_counter.h>
+#include "Loader.h"
+#include "Residency_manager.h"
+
+using namespace std;
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Residency_manager::Residency_manager(Memory_allocator& allocator, const Residency_desc& desc) :
+    allocator_ {allocator},
+    device_table_ {allocator.device_table()},
+    desc_ {desc},
+    residents_ {},
+    buffers_ {},
+    free_ids_ {},
+    candidates_ {},
+    pending_bytes_ {},
+    stats_ {},
+    frame_ {0},
+    moves_begun_ {false}
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Residency_manager::~Residency_manager()
+{
+    retire_(true);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Resident_id Residency_manager::add(VkDeviceSize size, uint32_t heap, Resident_callbacks callbacks)
+{
+    Resident_ resident {size, heap, frame_, 0, State_::resident, false, false, false, move(callbacks)};
+    Resident_id id;
+
+    if (free_ids_.empty()) {
+        id = static_cast<Resident_id>(residents_.size());
+        residents_.push_back(move(resident));
+        buffers_.emplace_back();
+    } else {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+        residents_[id] = move(resident);
+    }
+
+    // every resident can be a candidate, so frames don't allocate.
+    candidates_.reserve(residents_.size());
+
+    return id;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Resident_id Residency_manager::add_buffer(const VkBufferCreateInfo& create_info, VkBuffer* buffer,
+                                          VmaAllocation* allocation, Resident_move_callback callback)
+{
+    // the old buffer is the source of the copy and the new one is the destination.
+    assert(create_info.usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    assert(create_info.usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    VmaAllocationInfo info;
+
+    vmaGetAllocationInfo(allocator_.allocator(), *allocation, &info);
+
+    // an evicted buffer is read by the device over the bus, so it doesn't take the BAR.
+    auto placement = allocator_.place_buffer(create_info, Memory_access::streaming);
+
+    auto id = add(info.size, allocator_.heap_index(*allocation), {});
+
+    residents_[id].callbacks.evict = [this, id](VkCommandBuffer command_buffer) {
+        move_buffer_(command_buffer, id, true);
+    };
+    residents_[id].callbacks.restore = [this, id](VkCommandBuffer command_buffer) {
+        move_buffer_(command_buffer, id, false);
+    };
+    residents_[id].callbacks.retire = [this, id]() {
+        retire_buffer_(id);
+    };
+
+    auto& entry = buffers_[id];
+
+    entry.create_info = create_info;
+    entry.create_info.pNext = nullptr;
+    entry.queue_family_indices.assign(create_info.pQueueFamilyIndices,
+                                      create_info.pQueueFamilyIndices + create_info.queueFamilyIndexCount);
+    entry.buffer = buffer;
+    entry.allocation = allocation;
+    entry.device_memory_type_bits = 1u << info.memoryType;
+    entry.host_memory_type_bits = 1u << placement.memory_type;
+    entry.retired_buffer = VK_NULL_HANDLE;
+    entry.retired_allocation = VK_NULL_HANDLE;
+    entry.callback = move(callback);
+
+    return id;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::remove(Resident_id id)
+{
+    auto& resident = residents_[id];
+
+    if (resident.moving) {
+        resident.callbacks.retire();
+
+        if (resident.releasing)
+            pending_bytes_[resident.heap] -= resident.size;
+    }
+
+    resident.removed = true;
+    resident.moving = false;
+    resident.releasing = false;
+    resident.callbacks = {};
+    buffers_[id] = {};
+
+    free_ids_.push_back(id);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::touch(Resident_id id) noexcept
+{
+    auto& resident = residents_[id];
+
+    resident.last_use = frame_;
+
+    if (resident.state == State_::evicted)
+        resident.state = State_::restoring;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::record(VkCommandBuffer command_buffer)
+{
+    // the budget of the extension is refreshed once per frame.
+    allocator_.set_frame_index(static_cast<uint32_t>(frame_));
+
+    retire_(false);
+
+    auto budgets = allocator_.budgets();
+    auto heap_count = allocator_.heap_count();
+    array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> usages {};
+
+    for (auto i = 0u; i != heap_count; ++i) {
+        // the memory of evicted resources is counted until the frames in flight release it.
+        usages[i] = budgets[i].usage - min(budgets[i].usage, pending_bytes_[i]);
+
+        auto high = static_cast<VkDeviceSize>(desc_.high_watermark * budgets[i].budget);
+        auto low = static_cast<VkDeviceSize>(desc_.low_watermark * budgets[i].budget);
+
+        // only what is evicted makes room, the rest may not be evictable yet.
+        if (usages[i] > high)
+            usages[i] -= min(usages[i], evict_(command_buffer, i, usages[i] - low));
+    }
+
+    restore_(command_buffer, usages, budgets);
+
+    if (moves_begun_)
+        end_moves_(command_buffer);
+
+    // the resources which are touched from now on are used by the next frame.
+    ++frame_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Residency_manager::is_resident(Resident_id id) const noexcept
+{
+    return residents_[id].state == State_::resident;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::retire_(bool all)
+{
+    for (auto& resident : residents_) {
+        if (!resident.moving)
+            continue;
+
+        if (!all && frame_ - resident.move_frame < desc_.frames_in_flight)
+            continue;
+
+        resident.callbacks.retire();
+        resident.moving = false;
+
+        if (resident.releasing) {
+            pending_bytes_[resident.heap] -= resident.size;
+            resident.releasing = false;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkDeviceSize Residency_manager::evict_(VkCommandBuffer command_buffer, uint32_t heap, VkDeviceSize bytes)
+{
+    candidates_.clear();
+
+    for (auto i = 0u; i != residents_.size(); ++i) {
+        auto& resident = residents_[i];
+
+        if (resident.removed || resident.moving || resident.heap != heap || resident.state != State_::resident)
+            continue;
+
+        if (resident.last_use + desc_.min_idle_frames > frame_)
+            continue;
+
+        candidates_.push_back(i);
+    }
+
+    // the least recently used resources are evicted first.
+    sort(begin(candidates_), end(candidates_), [this](auto lhs, auto rhs) {
+        return residents_[lhs].last_use < residents_[rhs].last_use;
+    });
+
+    VkDeviceSize evicted_bytes {0};
+
+    for (auto id : candidates_) {
+        if (evicted_bytes >= bytes)
+            break;
+
+        auto& resident = residents_[id];
+
+        move_(command_buffer, resident, true);
+
+        resident.state = State_::evicted;
+        resident.releasing = true;
+        pending_bytes_[heap] += resident.size;
+        evicted_bytes += resident.size;
+
+        stats_.evicted_bytes += resident.size;
+        ++stats_.eviction_count;
+    }
+
+    return evicted_bytes;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::restore_(VkCommandBuffer command_buffer, array<VkDeviceSize, VK_MAX_MEMORY_HEAPS>& usages,
+                                 const array<VmaBudget, VK_MAX_MEMORY_HEAPS>& budgets)
+{
+    VkDeviceSize restored_bytes {0};
+
+    for (auto& resident : residents_) {
+        if (resident.removed || resident.moving || resident.state != State_::restoring)
+            continue;
+
+        // the rest is restored by the next frames.
+        if (restored_bytes + resident.size > desc_.frame_restore_budget && restored_bytes)
+            break;
+
+        // a restore which evicts something else right away only moves memory back and forth.
+        auto high = static_cast<VkDeviceSize>(desc_.high_watermark * budgets[resident.heap].budget);
+
+        if (usages[resident.heap] + resident.size > high)
+            continue;
+
+        move_(command_buffer, resident, false);
+
+        resident.state = State_::resident;
+        usages[resident.heap] += resident.size;
+        restored_bytes += resident.size;
+
+        stats_.restored_bytes += resident.size;
+        ++stats_.restore_count;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::move_(VkCommandBuffer command_buffer, Resident_& resident, bool evict)
+{
+    // a move creates a resource in the other heap, it is the rare frame which may allocate.
+    Platform::Allocation_exemption allocation_exemption;
+
+    if (!moves_begun_)
+        begin_moves_(command_buffer);
+
+    if (evict)
+        resident.callbacks.evict(command_buffer);
+    else
+        resident.callbacks.restore(command_buffer);
+
+    resident.moving = true;
+    resident.move_frame = frame_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::move_buffer_(VkCommandBuffer command_buffer, Resident_id id, bool evict)
+{
+    auto& buffer = buffers_[id];
+
+    buffer.create_info.pQueueFamilyIndices = buffer.queue_family_indices.data();
+
+    Allocation_desc desc;
+
+    desc.usage = VMA_MEMORY_USAGE_UNKNOWN;
+    desc.name = evict ? "evicted buffer" : "restored buffer";
+    desc.memory_type_bits = evict ? buffer.host_memory_type_bits : buffer.device_memory_type_bits;
+
+    VkBuffer new_buffer;
+    VmaAllocation new_allocation;
+
+    if (allocator_.create_buffer(buffer.create_info, desc, &new_buffer, &new_allocation) != VK_SUCCESS)
+        throw runtime_error("fail to create a buffer to move");
+
+    VkBufferCopy region {};
+
+    region.size = buffer.create_info.size;
+
+    device_table_.vkCmdCopyBuffer(command_buffer, *buffer.buffer, new_buffer, 1, &region);
+
+    // the old buffer is used by the frames in flight until the move is retired.
+    buffer.retired_buffer = *buffer.buffer;
+    buffer.retired_allocation = *buffer.allocation;
+    *buffer.buffer = new_buffer;
+    *buffer.allocation = new_allocation;
+
+    if (buffer.callback)
+        buffer.callback(new_buffer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::retire_buffer_(Resident_id id) noexcept
+{
+    auto& buffer = buffers_[id];
+
+    allocator_.destroy_buffer(buffer.retired_buffer, buffer.retired_allocation);
+
+    buffer.retired_buffer = VK_NULL_HANDLE;
+    buffer.retired_allocation = VK_NULL_HANDLE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::begin_moves_(VkCommandBuffer command_buffer)
+{
+    VkMemoryBarrier barrier {};
+
+    // the copies read what the previous frames wrote to the resources.
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    device_table_.vkCmdPipelineBarrier(command_buffer,
+                                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                       0,
+                                       1, &barrier,
+                                       0, nullptr,
+                                       0, nullptr);
+
+    moves_begun_ = true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Residency_manager::end_moves_(VkCommandBuffer command_buffer)
+{
+    VkMemoryBarrier barrier {};
+
+    // the frame reads the new places after the copies.
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+    device_table_.vkCmdPipelineBarrier(command_buffer,
+                                       VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                       0,
+                                       1, &barrier,
+                                       0, nullptr,
+                                       0, nullptr);
+
+    moves_begun_ = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
@@ -0,0 +1,203 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <stdexcept>
+#include "Loader.h"
+#include "Submit_thread.h"
+
+using namespace std;
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Submit_thread::Submit_thread(const Device_table& device_table, VkQueue queue, uint32_t capacity) :
+    device_table_ {device_table},
+    queue_ {queue},
+    frames_ {},
+    head_ {0},
+    count_ {0},
+    busy_ {false},
+    running_ {true},
+    result_ {VK_SUCCESS},
+    acquire_device_ {VK_NULL_HANDLE},
+    acquire_swapchain_ {VK_NULL_HANDLE},
+    acquire_semaphore_ {VK_NULL_HANDLE},
+    acquire_index_ {nullptr},
+    acquire_result_ {VK_SUCCESS},
+    acquire_pending_ {false},
+    mutex_ {},
+    push_cv_ {},
+    pop_cv_ {},
+    thread_ {}
+{
+    if (!capacity)
+        throw runtime_error("fail to create a submit thread");
+
+    // frames are kept in a ring, so pushing a frame doesn't allocate.
+    frames_.resize(capacity);
+
+    thread_ = thread(&Submit_thread::run_, this);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Submit_thread::~Submit_thread()
+{
+    {
+        lock_guard<mutex> lock {mutex_};
+
+        running_ = false;
+    }
+
+    push_cv_.notify_all();
+    thread_.join();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Submit_thread::push(const Submit_frame& frame)
+{
+    {
+        unique_lock<mutex> lock {mutex_};
+
+        pop_cv_.wait(lock, [this]() { return count_ < frames_.size(); });
+        frames_[(head_ + count_++) % frames_.size()] = frame;
+    }
+
+    push_cv_.notify_one();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+VkResult Submit_thread::acquire_next_image(VkDevice device, VkSwapchainKHR swapchain, VkSemaphore semaphore,
+                                           uint32_t* swapchain_index)
+{
+    {
+        lock_guard<mutex> lock {mutex_};
+
+        acquire_device_ = device;
+        acquire_swapchain_ = swapchain;
+        acquire_semaphore_ = semaphore;
+        acquire_index_ = swapchain_index;
+        acquire_pending_ = true;
+    }
+
+    push_cv_.notify_one();
+
+    unique_lock<mutex> lock {mutex_};
+
+    pop_cv_.wait(lock, [this]() { return !acquire_pending_; });
+
+    return acquire_result_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Submit_thread::wait_idle()
+{
+    unique_lock<mutex> lock {mutex_};
+
+    pop_cv_.wait(lock, [this]() { return !count_ && !busy_; });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Submit_thread::run_()
+{
+    while (true) {
+        Submit_frame frame;
+        auto acquire = false;
+
+        {
+            unique_lock<mutex> lock {mutex_};
+
+            push_cv_.wait(lock, [this]() { return !running_ || count_ || acquire_pending_; });
+
+            // an acquire waits for the frames which were pushed before it, so their presents release images.
+            if (count_) {
+                frame = frames_[head_];
+                head_ = (head_ + 1) % frames_.size();
+                --count_;
+                busy_ = true;
+            } else if (acquire_pending_) {
+                acquire = true;
+            } else {
+                // the frames which were pushed are submitted before the thread stops.
+                break;
+            }
+        }
+
+        if (acquire) {
+            acquire_();
+        } else {
+            submit_(frame);
+
+            lock_guard<mutex> lock {mutex_};
+
+            busy_ = false;
+        }
+
+        pop_cv_.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Submit_thread::submit_(const Submit_frame& frame)
+{
+    VkSubmitInfo submit_info {};
+
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.waitSemaphoreCount = frame.wait_semaphore ? 1 : 0;
+    submit_info.pWaitSemaphores = &frame.wait_semaphore;
+    submit_info.pWaitDstStageMask = &frame.wait_stage_mask;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &frame.command_buffer;
+    submit_info.signalSemaphoreCount = frame.signal_semaphore ? 1 : 0;
+    submit_info.pSignalSemaphores = &frame.signal_semaphore;
+
+    auto result = device_table_.vkQueueSubmit(queue_, 1, &submit_info, frame.fence);
+
+    if (VK_SUCCESS != result) {
+        result_.store(result, memory_order_release);
+        return;
+    }
+
+    if (!frame.swapchain)
+        return;
+
+    VkPresentInfoKHR present_info {};
+
+    present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    present_info.waitSemaphoreCount = frame.signal_semaphore ? 1 : 0;
+    present_info.pWaitSemaphores = &frame.signal_semaphore;
+    present_info.swapchainCount = 1;
+    present_info.pSwapchains = &frame.swapchain;
+    present_info.pImageIndices = &frame.swapchain_index;
+
+    result = device_table_.vkQueuePresentKHR(queue_, &present_info);
+
+    if (VK_SUCCESS != result)
+        result_.store(result, memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Submit_thread::acquire_()
+{
+    // the presents of this thread are done, so the acquire can block until the presentation engine releases an image.
+    auto result = device_table_.vkAcquireNextImageKHR(acquire_device_, acquire_swapchain_, UINT64_MAX,
+                                                      acquire_semaphore_, VK_NULL_HANDLE, acquire_index_);
+
+    lock_guard<mutex> lock {mutex_};
+
+    acquire_result_ = result;
+    acquire_pending_ = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
@@ -0,0 +1,657 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <fmt/format.h>
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+#include <sc/Spirv_compiler.h>
+#include "Workgroup_tuner.h"
+
+using namespace std;
+using namespace rapidjson;
+using namespace Vlk;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t pow2s[] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+
+    for (size_t i = 0; i != size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto group_count(uint32_t problem_size, uint32_t local_size, uint32_t tile_size)
+{
+    // the size of a group can exceed 32 bits with a large tile.
+    auto size = static_cast<uint64_t>(local_size) * tile_size;
+
+    return (problem_size + size - 1) / size;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void check(VkResult result, const char* message)
+{
+    if (VK_SUCCESS != result)
+        throw runtime_error(fmt::format("fail to {} ({})", message, static_cast<int>(result)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// owns every object created while tuning so an exception doesn't leak them.
+struct Objects {
+    VkDevice device {VK_NULL_HANDLE};
+    vector<VkBuffer> buffers;
+    vector<VkDeviceMemory> memories;
+    VkDescriptorSetLayout descriptor_set_layout {VK_NULL_HANDLE};
+    VkDescriptorPool descriptor_pool {VK_NULL_HANDLE};
+    VkPipelineLayout pipeline_layout {VK_NULL_HANDLE};
+    VkShaderModule shader_module {VK_NULL_HANDLE};
+    VkCommandPool command_pool {VK_NULL_HANDLE};
+    VkFence fence {VK_NULL_HANDLE};
+    VkQueryPool query_pool {VK_NULL_HANDLE};
+    VkPipeline pipeline {VK_NULL_HANDLE};
+
+    ~Objects()
+    {
+        vkDestroyPipeline(device, pipeline, nullptr);
+        vkDestroyQueryPool(device, query_pool, nullptr);
+        vkDestroyFence(device, fence, nullptr);
+        vkDestroyCommandPool(device, command_pool, nullptr);
+        vkDestroyShaderModule(device, shader_module, nullptr);
+        vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
+        vkDestroyDescriptorPool(device, descriptor_pool, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptor_set_layout, nullptr);
+
+        for (auto& buffer : buffers)
+            vkDestroyBuffer(device, buffer, nullptr);
+
+        for (auto& memory : memories)
+            vkFreeMemory(device, memory, nullptr);
+    }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+namespace Vlk {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<Workgroup_candidate> default_candidates(const std::array<uint32_t, 3>& problem_size)
+{
+    vector<Workgroup_candidate> candidates;
+
+    if (problem_size[1] == 1 && problem_size[2] == 1) {
+        for (auto x : pow2s) {
+            if (x >= 16)
+                candidates.push_back({{x, 1, 1}, {1, 1, 1}});
+        }
+    }
+    else {
+        for (auto x : pow2s) {
+            for (auto y : pow2s) {
+                if (x * y >= 16 && x * y <= 1024 && y <= 64)
+                    candidates.push_back({{x, y, 1}, {1, 1, 1}});
+            }
+        }
+    }
+
+    return candidates;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Workgroup_tuner::Workgroup_tuner(VkPhysicalDevice physical_device, VkDevice device, uint32_t queue_family_index,
+                                 const fs::path& cache_path) :
+    physical_device_ {physical_device},
+    device_ {device},
+    queue_family_index_ {queue_family_index},
+    queue_ {VK_NULL_HANDLE},
+    cache_path_ {cache_path},
+    properties_ {},
+    memory_properties_ {},
+    device_uuid_ {},
+    timestamp_valid_bits_ {0},
+    cache_ {}
+{
+    init_properties_();
+    init_queue_();
+    load_cache_();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Tuning_result Workgroup_tuner::tune(const Tuning_desc& desc)
+{
+    // every candidate shares one SPIRV and differs only by specialization constants.
+    auto spirv = Sc::Spirv_compiler(Sc::Spirv_compiler_configs {Sc::Platform::desktop})
+        .compile(Sc::Shader_type::compute, desc.src);
+
+    auto key = key_(spirv, desc);
+
+    if (auto iter = cache_.find(key); iter != cache_.end()) {
+        auto result = iter->second;
+
+        result.cached = true;
+        return result;
+    }
+
+    auto candidates = desc.candidates.empty() ? default_candidates(desc.problem_size) : desc.candidates;
+
+    Objects objects;
+
+    objects.device = device_;
+
+    // create storage buffers.
+    for (auto size : desc.storage_buffer_sizes) {
+        VkBufferCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        create_info.size = size;
+        create_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        VkBuffer buffer;
+
+        check(vkCreateBuffer(device_, &create_info, nullptr, &buffer), "create a buffer");
+        objects.buffers.push_back(buffer);
+
+        VkMemoryRequirements requirements;
+
+        vkGetBufferMemoryRequirements(device_, buffer, &requirements);
+
+        VkMemoryAllocateInfo allocate_info {};
+
+        allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocate_info.allocationSize = requirements.size;
+        allocate_info.memoryTypeIndex = find_memory_type_index_(requirements.memoryTypeBits,
+                                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        VkDeviceMemory memory;
+
+        check(vkAllocateMemory(device_, &allocate_info, nullptr, &memory), "allocate a memory");
+        objects.memories.push_back(memory);
+
+        check(vkBindBufferMemory(device_, buffer, memory, 0), "bind a memory");
+    }
+
+    // create a descriptor set which binds storage buffers in order.
+    vector<VkDescriptorSetLayoutBinding> bindings;
+
+    for (uint32_t i = 0; i != objects.buffers.size(); ++i)
+        bindings.push_back({i, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr});
+
+    {
+        VkDescriptorSetLayoutCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        create_info.bindingCount = static_cast<uint32_t>(bindings.size());
+        create_info.pBindings = bindings.empty() ? nullptr : &bindings[0];
+
+        check(vkCreateDescriptorSetLayout(device_, &create_info, nullptr, &objects.descriptor_set_layout),
+              "create a descriptor set layout");
+    }
+
+    VkDescriptorSet descriptor_set {VK_NULL_HANDLE};
+
+    if (!bindings.empty()) {
+        VkDescriptorPoolSize pool_size {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<uint32_t>(bindings.size())};
+
+        VkDescriptorPoolCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        create_info.maxSets = 1;
+        create_info.poolSizeCount = 1;
+        create_info.pPoolSizes = &pool_size;
+
+        check(vkCreateDescriptorPool(device_, &create_info, nullptr, &objects.descriptor_pool),
+              "create a descriptor pool");
+
+        VkDescriptorSetAllocateInfo allocate_info {};
+
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = objects.descriptor_pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &objects.descriptor_set_layout;
+
+        check(vkAllocateDescriptorSets(device_, &allocate_info, &descriptor_set), "allocate a descriptor set");
+
+        vector<VkDescriptorBufferInfo> buffer_infos;
+
+        for (auto& buffer : objects.buffers)
+            buffer_infos.push_back({buffer, 0, VK_WHOLE_SIZE});
+
+        vector<VkWriteDescriptorSet> writes;
+
+        for (uint32_t i = 0; i != buffer_infos.size(); ++i) {
+            VkWriteDescriptorSet write {};
+
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = descriptor_set;
+            write.dstBinding = i;
+            write.descriptorCount = 1;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.pBufferInfo = &buffer_infos[i];
+
+            writes.push_back(write);
+        }
+
+        vkUpdateDescriptorSets(device_, static_cast<uint32_t>(writes.size()), &writes[0], 0, nullptr);
+    }
+
+    {
+        VkPipelineLayoutCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        create_info.setLayoutCount = 1;
+        create_info.pSetLayouts = &objects.descriptor_set_layout;
+
+        check(vkCreatePipelineLayout(device_, &create_info, nullptr, &objects.pipeline_layout),
+              "create a pipeline layout");
+    }
+
+    {
+        VkShaderModuleCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        create_info.codeSize = spirv.size() * sizeof(uint32_t);
+        create_info.pCode = &spirv[0];
+
+        check(vkCreateShaderModule(device_, &create_info, nullptr, &objects.shader_module),
+              "create a shader module");
+    }
+
+    {
+        VkCommandPoolCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        create_info.queueFamilyIndex = queue_family_index_;
+
+        check(vkCreateCommandPool(device_, &create_info, nullptr, &objects.command_pool), "create a command pool");
+    }
+
+    VkCommandBuffer command_buffer;
+
+    {
+        VkCommandBufferAllocateInfo allocate_info {};
+
+        allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocate_info.commandPool = objects.command_pool;
+        allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocate_info.commandBufferCount = 1;
+
+        check(vkAllocateCommandBuffers(device_, &allocate_info, &command_buffer), "allocate a command buffer");
+    }
+
+    {
+        VkFenceCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        check(vkCreateFence(device_, &create_info, nullptr, &objects.fence), "create a fence");
+    }
+
+    if (timestamp_valid_bits_) {
+        VkQueryPoolCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        create_info.queryCount = 2;
+
+        check(vkCreateQueryPool(device_, &create_info, nullptr, &objects.query_pool), "create a query pool");
+    }
+
+    // records the dispatches of a candidate, submits them and waits for them to finish.
+    auto execute = [&](const Workgroup_candidate& candidate, uint32_t iterations, bool timed) {
+        VkCommandBufferBeginInfo begin_info {};
+
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkResetCommandBuffer(command_buffer, 0);
+        vkBeginCommandBuffer(command_buffer, &begin_info);
+
+        if (timed && objects.query_pool) {
+            vkCmdResetQueryPool(command_buffer, objects.query_pool, 0, 2);
+            vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, objects.query_pool, 0);
+        }
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, objects.pipeline);
+
+        if (descriptor_set)
+            vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, objects.pipeline_layout,
+                                    0, 1, &descriptor_set, 0, nullptr);
+
+        // valid_ checks the group counts against the limits, so they fit in 32 bits.
+        array<uint32_t, 3> group_counts;
+
+        for (uint32_t i = 0; i != 3; ++i)
+            group_counts[i] = static_cast<uint32_t>(group_count(desc.problem_size[i], candidate.local_size[i],
+                                                                candidate.tile_size[i]));
+
+        for (uint32_t i = 0; i != iterations; ++i) {
+            vkCmdDispatch(command_buffer, group_counts[0], group_counts[1], group_counts[2]);
+
+            // dispatches write the same buffers, so they must not overlap.
+            VkMemoryBarrier barrier {};
+
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+            vkCmdPipelineBarrier(command_buffer,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 0,
+                                 1, &barrier,
+                                 0, nullptr,
+                                 0, nullptr);
+        }
+
+        if (timed && objects.query_pool)
+            vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, objects.query_pool, 1);
+
+        vkEndCommandBuffer(command_buffer);
+
+        VkSubmitInfo submit_info {};
+
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &command_buffer;
+
+        auto begin = chrono::steady_clock::now();
+
+        check(vkQueueSubmit(queue_, 1, &submit_info, objects.fence), "submit");
+        check(vkWaitForFences(device_, 1, &objects.fence, VK_TRUE, UINT64_MAX), "wait for a fence");
+
+        auto end = chrono::steady_clock::now();
+
+        vkResetFences(device_, 1, &objects.fence);
+
+        if (!timed)
+            return 0.0;
+
+        // fall back to the host time when the queue doesn't support timestamps.
+        if (!objects.query_pool)
+            return chrono::duration<double, nano>(end - begin).count() / iterations;
+
+        array<uint64_t, 2> timestamps;
+
+        check(vkGetQueryPoolResults(device_, objects.query_pool, 0, 2, sizeof(timestamps), &timestamps[0],
+                                    sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT),
+              "get query results");
+
+        auto mask = timestamp_valid_bits_ == 64 ? ~0ull : (1ull << timestamp_valid_bits_) - 1;
+        auto ticks = ((timestamps[1] & mask) - (timestamps[0] & mask)) & mask;
+
+        return ticks * static_cast<double>(properties_.limits.timestampPeriod) / iterations;
+    };
+
+    Tuning_result best {{}, numeric_limits<double>::max(), false};
+
+    for (auto& candidate : candidates) {
+        if (!valid_(candidate, desc.problem_size))
+            continue;
+
+        // specialize the local size and the tile size.
+        array<uint32_t, 6> constants {
+            candidate.local_size[0], candidate.local_size[1], candidate.local_size[2],
+            candidate.tile_size[0], candidate.tile_size[1], candidate.tile_size[2]
+        };
+
+        array<VkSpecializationMapEntry, 6> entries;
+
+        for (uint32_t i = 0; i != entries.size(); ++i)
+            entries[i] = {i, static_cast<uint32_t>(i * sizeof(uint32_t)), sizeof(uint32_t)};
+
+        VkSpecializationInfo specialization_info {};
+
+        specialization_info.mapEntryCount = static_cast<uint32_t>(entries.size());
+        specialization_info.pMapEntries = &entries[0];
+        specialization_info.dataSize = sizeof(constants);
+        specialization_info.pData = &constants[0];
+
+        VkComputePipelineCreateInfo create_info {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        create_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        create_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        create_info.stage.module = objects.shader_module;
+        create_info.stage.pName = "main";
+        create_info.stage.pSpecializationInfo = &specialization_info;
+        create_info.layout = objects.pipeline_layout;
+
+        check(vkCreateComputePipelines(device_, VK_NULL_HANDLE, 1, &create_info, nullptr, &objects.pipeline),
+              "create a compute pipeline");
+
+        // warm up caches and clocks before measuring.
+        execute(candidate, 1, false);
+
+        auto time = execute(candidate, max(desc.iterations, 1u), true);
+
+        if (time < best.time)
+            best = {candidate, time, false};
+
+        vkDestroyPipeline(device_, objects.pipeline, nullptr);
+        objects.pipeline = VK_NULL_HANDLE;
+    }
+
+    if (best.time == numeric_limits<double>::max())
+        throw runtime_error("fail to find a valid workgroup candidate");
+
+    cache_[key] = best;
+    save_cache_();
+
+    return best;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Workgroup_tuner::init_properties_()
+{
+    VkPhysicalDeviceIDProperties id_properties {};
+
+    id_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties {};
+
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &id_properties;
+
+    vkGetPhysicalDeviceProperties2(physical_device_, &properties);
+
+    properties_ = properties.properties;
+    copy(begin(id_properties.deviceUUID), end(id_properties.deviceUUID), device_uuid_.begin());
+
+    vkGetPhysicalDeviceMemoryProperties(physical_device_, &memory_properties_);
+
+    uint32_t count {0};
+
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, nullptr);
+
+    vector<VkQueueFamilyProperties> queue_families(count);
+
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &count, &queue_families[0]);
+
+    assert(queue_family_index_ < count);
+    timestamp_valid_bits_ = queue_families[queue_family_index_].timestampValidBits;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Workgroup_tuner::init_queue_()
+{
+    vkGetDeviceQueue(device_, queue_family_index_, 0, &queue_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Workgroup_tuner::load_cache_()
+{
+    ifstream fin(cache_path_);
+
+    if (!fin.is_open())
+        return;
+
+    IStreamWrapper stream {fin};
+    Document document;
+
+    document.ParseStream(stream);
+
+    if (document.HasParseError() || !document.IsObject())
+        throw runtime_error("fail to parse " + cache_path_.string());
+
+    for (auto iter = document.MemberBegin(); iter != document.MemberEnd(); ++iter) {
+        auto& value = iter->value;
+        Tuning_result result;
+
+        for (uint32_t i = 0; i != 3; ++i) {
+            result.candidate.local_size[i] = value["local_size"][i].GetUint();
+            result.candidate.tile_size[i] = value["tile_size"][i].GetUint();
+        }
+
+        result.time = value["time"].GetDouble();
+        cache_[iter->name.GetString()] = result;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Workgroup_tuner::save_cache_() const
+{
+    Document document;
+    auto& allocator = document.GetAllocator();
+
+    document.SetObject();
+
+    for (auto& [key, result] : cache_) {
+        Value local_size {kArrayType};
+        Value tile_size {kArrayType};
+
+        for (uint32_t i = 0; i != 3; ++i) {
+            local_size.PushBack(result.candidate.local_size[i], allocator);
+            tile_size.PushBack(result.candidate.tile_size[i], allocator);
+        }
+
+        Value value {kObjectType};
+
+        value.AddMember("local_size", local_size, allocator);
+        value.AddMember("tile_size", tile_size, allocator);
+        value.AddMember("time", result.time, allocator);
+
+        document.AddMember(Value(key.c_str(), allocator), value, allocator);
+    }
+
+    ofstream fout(cache_path_);
+
+    if (!fout.is_open())
+        throw runtime_error("fail to open " + cache_path_.string());
+
+    OStreamWrapper stream {fout};
+    PrettyWriter<OStreamWrapper> writer {stream};
+
+    document.Accept(writer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string Workgroup_tuner::key_(const std::vector<uint32_t>& spirv, const Tuning_desc& desc) const
+{
+    // the best candidate depends on the problem size, the buffers and the candidates as well as the shader.
+    auto hash = fnv1a(&spirv[0], spirv.size() * sizeof(uint32_t));
+
+    hash = fnv1a(&desc.problem_size[0], sizeof(desc.problem_size), hash);
+
+    // the counts separate the lists, so moving an element from one list to the other changes the hash.
+    auto count = static_cast<uint64_t>(desc.storage_buffer_sizes.size());
+
+    hash = fnv1a(&count, sizeof(count), hash);
+
+    for (auto size : desc.storage_buffer_sizes)
+        hash = fnv1a(&size, sizeof(size), hash);
+
+    count = desc.candidates.size();
+    hash = fnv1a(&count, sizeof(count), hash);
+
+    for (auto& candidate : desc.candidates) {
+        hash = fnv1a(&candidate.local_size[0], sizeof(candidate.local_size), hash);
+        hash = fnv1a(&candidate.tile_size[0], sizeof(candidate.tile_size), hash);
+    }
+
+    string uuid;
+
+    for (auto byte : device_uuid_)
+        uuid += fmt::format("{:02x}", byte);
+
+    return fmt::format("{}-{:08x}-{:016x}", uuid, properties_.driverVersion, hash);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Workgroup_tuner::valid_(const Workgroup_candidate& candidate,
+                             const std::array<uint32_t, 3>& problem_size) const noexcept
+{
+    auto& limits = properties_.limits;
+    uint64_t invocations {1};
+
+    for (uint32_t i = 0; i != 3; ++i) {
+        if (!candidate.local_size[i] || !candidate.tile_size[i])
+            return false;
+
+        if (candidate.local_size[i] > limits.maxComputeWorkGroupSize[i])
+            return false;
+
+        // a small local size with a large problem needs more groups than a dispatch can have.
+        if (group_count(problem_size[i], candidate.local_size[i], candidate.tile_size[i]) >
+            limits.maxComputeWorkGroupCount[i])
+            return false;
+
+        invocations *= candidate.local_size[i];
+    }
+
+    return invocations <= limits.maxComputeWorkGroupInvocations;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t Workgroup_tuner::find_memory_type_index_(uint32_t memory_type_bits, VkMemoryPropertyFlags properties) const
+{
+    for (uint32_t i = 0; i != memory_properties_.memoryTypeCount; ++i) {
+        if (!(memory_type_bits & (1u << i)))
+            continue;
+
+        if ((memory_properties_.memoryTypes[i].propertyFlags & properties) != properties)
+            continue;
+
+        return i;
+    }
+
+    throw runtime_error("fail to find a memory type");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace Vlk
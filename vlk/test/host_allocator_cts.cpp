@@ -0,0 +1,220 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <cstdint>
+#include <vector>
+#include <doctest.h>
+#include <vlk/Host_allocator.h>
+
+using namespace std;
+using namespace doctest;
+using namespace Vlk;
+
+TEST_SUITE_BEGIN("host allocator test suite");
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+inline auto aligned(const void* memory, size_t alignment)
+{
+    return reinterpret_cast<uintptr_t>(memory) % alignment == 0;
+}
+
+void fill(void* memory, size_t size, uint8_t seed)
+{
+    auto bytes = static_cast<uint8_t*>(memory);
+
+    for (auto i = 0u; i != size; ++i)
+        bytes[i] = static_cast<uint8_t>(seed + i * 7);
+}
+
+bool filled(const void* memory, size_t size, uint8_t seed)
+{
+    auto bytes = static_cast<const uint8_t*>(memory);
+
+    for (auto i = 0u; i != size; ++i) {
+        if (bytes[i] != static_cast<uint8_t>(seed + i * 7))
+            return false;
+    }
+
+    return true;
+}
+
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("allocate and free in every size class")
+{
+    Host_allocator allocator;
+    auto callbacks = allocator.callbacks();
+    vector<void*> memories;
+    vector<size_t> sizes;
+    uint64_t bytes {0};
+
+    // the sizes cover every size class and the large allocations which bypass the pools.
+    for (auto size : {1u, 16u, 48u, 100u, 200u, 500u, 1000u, 2000u, 4000u, 8000u, 20000u}) {
+        for (auto alignment : {1u, 8u, 16u, 64u, 256u}) {
+            auto memory = callbacks->pfnAllocation(callbacks->pUserData, size, alignment,
+                                                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+            REQUIRE(memory);
+            REQUIRE(aligned(memory, alignment));
+
+            fill(memory, size, static_cast<uint8_t>(memories.size()));
+            memories.push_back(memory);
+            sizes.push_back(size);
+            bytes += size;
+        }
+    }
+
+    auto stats = allocator.stats(VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+    CHECK(stats.live_bytes == bytes);
+    CHECK(stats.peak_bytes == bytes);
+    CHECK(stats.live_count == memories.size());
+    CHECK(stats.allocation_count == memories.size());
+    CHECK(allocator.stats(VK_SYSTEM_ALLOCATION_SCOPE_COMMAND).live_count == 0);
+
+    // the allocations don't overlap, so every one keeps its own contents.
+    for (auto i = 0u; i != memories.size(); ++i)
+        CHECK(filled(memories[i], sizes[i], static_cast<uint8_t>(i)));
+
+    for (auto memory : memories)
+        callbacks->pfnFree(callbacks->pUserData, memory);
+
+    stats = allocator.stats(VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+    CHECK(stats.live_bytes == 0);
+    CHECK(stats.peak_bytes == bytes);
+    CHECK(stats.live_count == 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("allocate more blocks than a chunk holds")
+{
+    Host_allocator allocator;
+    auto callbacks = allocator.callbacks();
+    vector<void*> memories;
+
+    for (auto i = 0u; i != 5000; ++i) {
+        auto memory = callbacks->pfnAllocation(callbacks->pUserData, 8, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+        REQUIRE(memory);
+
+        fill(memory, 8, static_cast<uint8_t>(i));
+        memories.push_back(memory);
+    }
+
+    for (auto i = 0u; i != memories.size(); ++i)
+        CHECK(filled(memories[i], 8, static_cast<uint8_t>(i)));
+
+    // freed blocks are reused by the next allocations.
+    for (auto memory : memories)
+        callbacks->pfnFree(callbacks->pUserData, memory);
+
+    for (auto& memory : memories) {
+        memory = callbacks->pfnAllocation(callbacks->pUserData, 8, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+        REQUIRE(memory);
+    }
+
+    for (auto memory : memories)
+        callbacks->pfnFree(callbacks->pUserData, memory);
+
+    CHECK(allocator.stats(VK_SYSTEM_ALLOCATION_SCOPE_OBJECT).live_count == 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("allocate with an alignment larger than the size class")
+{
+    Host_allocator allocator;
+    auto callbacks = allocator.callbacks();
+
+    for (auto alignment : {1024u, 4096u, 16384u, 65536u}) {
+        auto memory = callbacks->pfnAllocation(callbacks->pUserData, 16, alignment,
+                                               VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+
+        REQUIRE(memory);
+        CHECK(aligned(memory, alignment));
+
+        fill(memory, 16, 0);
+        CHECK(filled(memory, 16, 0));
+
+        callbacks->pfnFree(callbacks->pUserData, memory);
+    }
+
+    CHECK(allocator.stats(VK_SYSTEM_ALLOCATION_SCOPE_DEVICE).live_count == 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("reallocate across size classes")
+{
+    Host_allocator allocator;
+    auto callbacks = allocator.callbacks();
+
+    // a reallocation of null allocates.
+    auto memory = callbacks->pfnReallocation(callbacks->pUserData, nullptr, 24, 16,
+                                             VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
+
+    REQUIRE(memory);
+    fill(memory, 24, 1);
+
+    // the contents are kept while the allocation grows into the larger classes and the large allocations.
+    size_t size {24};
+
+    for (auto new_size : {300u, 3000u, 20000u, 100u, 8u}) {
+        memory = callbacks->pfnReallocation(callbacks->pUserData, memory, new_size, 64,
+                                            VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
+
+        REQUIRE(memory);
+        CHECK(aligned(memory, 64));
+        CHECK(filled(memory, min<size_t>(size, new_size), 1));
+
+        fill(memory, new_size, 1);
+        size = new_size;
+
+        auto stats = allocator.stats(VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
+
+        CHECK(stats.live_bytes == size);
+        CHECK(stats.live_count == 1);
+    }
+
+    // a reallocation to zero frees the memory.
+    CHECK(!callbacks->pfnReallocation(callbacks->pUserData, memory, 0, 64, VK_SYSTEM_ALLOCATION_SCOPE_CACHE));
+
+    auto stats = allocator.stats(VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
+
+    CHECK(stats.live_bytes == 0);
+    CHECK(stats.live_count == 0);
+    CHECK(stats.peak_bytes == 20000 + 3000);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_CASE("track internal allocations")
+{
+    Host_allocator allocator;
+    auto callbacks = allocator.callbacks();
+
+    callbacks->pfnInternalAllocation(callbacks->pUserData, 4096, VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE,
+                                     VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+
+    CHECK(allocator.stats(VK_SYSTEM_ALLOCATION_SCOPE_DEVICE).internal_bytes == 4096);
+    CHECK(allocator.total_stats().internal_bytes == 4096);
+
+    callbacks->pfnInternalFree(callbacks->pUserData, 4096, VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE,
+                               VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+
+    CHECK(allocator.total_stats().internal_bytes == 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_SUITE_END();
@@ -0,0 +1,189 @@
+//
+// This file is part of the "ogl_to_vlk" project
+// See "LICENSE" for license information.
+//
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <fmt/format.h>
+#include <vlk/Workgroup_tuner.h>
+
+using namespace std;
+using namespace Vlk;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// CTest skips a run which exits with this status.
+constexpr auto skip_status = 77;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto starts_with(const string& str, const string& prefix)
+{
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline auto read_file(const fs::path& path)
+{
+    ifstream fin(path, ios::binary);
+
+    if (!fin.is_open())
+        throw runtime_error("fail to open " + path.string());
+
+    stringstream ss;
+
+    ss << fin.rdbuf();
+
+    return ss.str();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+} // of namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        cerr << "usage : vlk_tune <compute shader> <x> [y] [z] "
+                "[--device=<name>] [--cache=<path>] [--buffer=<size>]... [--iterations=<count>]" << endl;
+        return 1;
+    }
+
+    VkInstance instance {VK_NULL_HANDLE};
+    VkDevice device {VK_NULL_HANDLE};
+    auto status {1};
+
+    try {
+        Tuning_desc desc;
+        string device_name;
+        fs::path cache_path {"vlk_tune.json"};
+        auto dimension = 0;
+
+        desc.src = read_file(argv[1]);
+
+        for (auto i = 2; i != argc; ++i) {
+            string arg {argv[i]};
+
+            if (starts_with(arg, "--device="))
+                device_name = arg.substr(9);
+            else if (starts_with(arg, "--cache="))
+                cache_path = arg.substr(8);
+            else if (starts_with(arg, "--buffer="))
+                desc.storage_buffer_sizes.push_back(stoull(arg.substr(9)));
+            else if (starts_with(arg, "--iterations="))
+                desc.iterations = stoul(arg.substr(13));
+            else if (dimension < 3)
+                desc.problem_size[dimension++] = stoul(arg);
+            else
+                throw runtime_error("fail to parse " + arg);
+        }
+
+        // the device UUID is only available from Vulkan 1.1.
+        VkApplicationInfo app_info {};
+
+        app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        app_info.pApplicationName = "vlk_tune";
+        app_info.apiVersion = VK_API_VERSION_1_1;
+
+        VkInstanceCreateInfo instance_create_info {};
+
+        instance_create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        instance_create_info.pApplicationInfo = &app_info;
+
+        if (vkCreateInstance(&instance_create_info, nullptr, &instance))
+            throw runtime_error("fail to create an instance");
+
+        uint32_t count {0};
+
+        vkEnumeratePhysicalDevices(instance, &count, nullptr);
+
+        vector<VkPhysicalDevice> physical_devices(count);
+
+        vkEnumeratePhysicalDevices(instance, &count, physical_devices.data());
+
+        // pick the first device whose name contains the given name, e.g. llvmpipe for lavapipe.
+        VkPhysicalDevice physical_device {VK_NULL_HANDLE};
+        VkPhysicalDeviceProperties properties;
+
+        for (auto& candidate : physical_devices) {
+            vkGetPhysicalDeviceProperties(candidate, &properties);
+
+            if (string(properties.deviceName).find(device_name) != string::npos) {
+                physical_device = candidate;
+                break;
+            }
+        }
+
+        // a missing device skips the run rather than fails it.
+        if (!physical_device) {
+            status = skip_status;
+            throw runtime_error("fail to find a physical device " + device_name);
+        }
+
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &count, nullptr);
+
+        vector<VkQueueFamilyProperties> queue_families(count);
+
+        vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &count, queue_families.data());
+
+        auto queue_family_index {UINT32_MAX};
+
+        for (uint32_t i = 0; i != count; ++i) {
+            if (queue_families[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
+                queue_family_index = i;
+                break;
+            }
+        }
+
+        if (queue_family_index == UINT32_MAX)
+            throw runtime_error("fail to find a compute queue family");
+
+        auto priority {1.0f};
+
+        VkDeviceQueueCreateInfo queue_create_info {};
+
+        queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_create_info.queueFamilyIndex = queue_family_index;
+        queue_create_info.queueCount = 1;
+        queue_create_info.pQueuePriorities = &priority;
+
+        VkDeviceCreateInfo device_create_info {};
+
+        device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        device_create_info.queueCreateInfoCount = 1;
+        device_create_info.pQueueCreateInfos = &queue_create_info;
+
+        if (vkCreateDevice(physical_device, &device_create_info, nullptr, &device))
+            throw runtime_error("fail to create a device");
+
+        Workgroup_tuner tuner {physical_device, device, queue_family_index, cache_path};
+        auto result = tuner.tune(desc);
+
+        cout << fmt::format("{} : local size ({}, {}, {}), tile size ({}, {}, {}), {:.3f} us{}",
+                            properties.deviceName,
+                            result.candidate.local_size[0], result.candidate.local_size[1],
+                            result.candidate.local_size[2],
+                            result.candidate.tile_size[0], result.candidate.tile_size[1],
+                            result.candidate.tile_size[2],
+                            result.time / 1000.0, result.cached ? " (cached)" : "") << endl;
+
+        status = 0;
+    }
+    catch (exception& e) {
+        cerr << e.what() << endl;
+    }
+
+    vkDestroyDevice(device, nullptr);
+    vkDestroyInstance(instance, nullptr);
+
+    return status;
+}
+
+//----------------------------------------------------------------------------------------------------------------------